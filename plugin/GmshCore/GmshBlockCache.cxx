@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshBlockCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshBlockCache.h"
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+void DecodedBlock::OnNodeBlock(const NodeBlock& block)
+{
+  this->EntityDim = block.EntityDim;
+  this->EntityTag = block.EntityTag;
+  this->Tags.assign(block.Tags.begin(), block.Tags.end());
+  this->Coordinates.assign(block.Coordinates.begin(),
+			   block.Coordinates.end());
+}
+
+//----------------------------------------------------------------------------
+void DecodedBlock::OnElementBlock(const ElementBlock& block)
+{
+  this->EntityDim = block.EntityDim;
+  this->EntityTag = block.EntityTag;
+  this->Type = block.Type;
+  this->Tags.insert(this->Tags.end(), block.Tags.begin(), block.Tags.end());
+  this->NodeTags.insert(this->NodeTags.end(), block.NodeTags.begin(),
+			block.NodeTags.end());
+}
+
+//----------------------------------------------------------------------------
+NodeBlock DecodedBlock::GetNodeBlock() const
+{
+  NodeBlock block;
+  block.EntityDim = this->EntityDim;
+  block.EntityTag = this->EntityTag;
+  block.Tags = this->Tags;
+  block.Coordinates = this->Coordinates;
+  return block;
+}
+
+//----------------------------------------------------------------------------
+ElementBlock DecodedBlock::GetElementBlock() const
+{
+  ElementBlock block;
+  block.EntityDim = this->EntityDim;
+  block.EntityTag = this->EntityTag;
+  block.Type = this->Type;
+  block.Tags = this->Tags;
+  block.NodeTags = this->NodeTags;
+  return block;
+}
+
+//----------------------------------------------------------------------------
+std::size_t DecodedBlock::GetSize() const
+{
+  return sizeof(std::size_t) * (this->Tags.size() + this->NodeTags.size()) +
+    sizeof(double) * this->Coordinates.size();
+}
+
+//----------------------------------------------------------------------------
+std::size_t BlockCache::GetSize() const
+{
+  return this->Size +
+    (this->Oversized.second ? this->Oversized.second->GetSize() : 0);
+}
+
+//----------------------------------------------------------------------------
+void BlockCache::SetCapacity(std::size_t capacity)
+{
+  this->Capacity = capacity;
+  if (capacity == 0) {
+    this->Oversized = Entry();
+  }
+  this->Evict();
+}
+
+//----------------------------------------------------------------------------
+std::shared_ptr<const DecodedBlock> BlockCache::Find(const Key& key)
+{
+  if (this->Oversized.second && this->Oversized.first == key) {
+    return this->Oversized.second;
+  }
+  auto it = this->Positions.find(key);
+  if (it == this->Positions.end()) {
+    return nullptr;
+  }
+  this->Entries.splice(this->Entries.begin(), this->Entries, it->second);
+  return it->second->second;
+}
+
+//----------------------------------------------------------------------------
+void BlockCache::Insert(const Key& key,
+			std::shared_ptr<const DecodedBlock> block)
+{
+  const std::size_t size = block->GetSize();
+  if (this->Capacity == 0 || this->Positions.count(key)) {
+    return;
+  }
+  if (size > this->Capacity) {
+    this->Oversized = Entry(key, std::move(block));
+    return;
+  }
+  this->Entries.emplace_front(key, std::move(block));
+  this->Positions[key] = this->Entries.begin();
+  this->Size += size;
+  this->Evict();
+}
+
+//----------------------------------------------------------------------------
+void BlockCache::Evict()
+{
+  while (this->Size > this->Capacity && !this->Entries.empty()) {
+    this->Size -= this->Entries.back().second->GetSize();
+    this->Positions.erase(this->Entries.back().first);
+    this->Entries.pop_back();
+  }
+}
+}
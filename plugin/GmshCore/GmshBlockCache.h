@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshBlockCache.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   GmshCore::BlockCache
+ * @brief   Cache of decoded node and element blocks.
+ *
+ * Blocks are keyed by file identity and block offset, so that the blocks
+ * of the entities read again, by another selection of entities or the
+ * next file of a series with the same mesh, are not decoded again. The
+ * least recently used blocks are evicted once their size exceeds the
+ * capacity; blocks still in use by a read are kept alive by their shared
+ * pointers.
+ */
+
+#ifndef GmshBlockCache_h
+#define GmshBlockCache_h
+
+#include "GmshParser.h"
+
+#include <ios>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace GmshCore
+{
+/**
+ * Content of a whole node or element block: the tags of its nodes and
+ * their coordinates, or the tags of its elements and the node tags of
+ * their vertices.
+ */
+struct DecodedBlock : Handler
+{
+  int EntityDim = 0;
+  int EntityTag = 0;
+  const ElementType* Type = nullptr;
+  std::vector<std::size_t> Tags;
+  std::vector<std::size_t> NodeTags;
+  std::vector<double> Coordinates;
+
+  void OnNodeBlock(const NodeBlock& block) override;
+
+  // Large blocks are delivered in several calls.
+  void OnElementBlock(const ElementBlock& block) override;
+
+  NodeBlock GetNodeBlock() const;
+  ElementBlock GetElementBlock() const;
+
+  /**
+   * Size of the decoded content in bytes.
+   */
+  std::size_t GetSize() const;
+};
+
+class BlockCache
+{
+public:
+  using Key = std::pair<std::string, std::streamoff>;
+
+  /**
+   * Size of the blocks held, in bytes.
+   */
+  std::size_t GetSize() const;
+
+  /**
+   * Maximum size of the blocks held in bytes, beyond which the least
+   * recently used are evicted. A capacity of 0 holds nothing.
+   */
+  void SetCapacity(std::size_t capacity);
+
+  /**
+   * Block of a key, or nullptr if it is not held.
+   */
+  std::shared_ptr<const DecodedBlock> Find(const Key& key);
+
+  /**
+   * Hold a block. A block larger than the capacity, as the single block of
+   * a mesh made of one entity, is held on its own, outside of the
+   * capacity, until another such block replaces it, so that the largest
+   * blocks, which cost the most to decode, are not always decoded again.
+   */
+  void Insert(const Key& key, std::shared_ptr<const DecodedBlock> block);
+
+private:
+  void Evict();
+
+  using Entry = std::pair<Key, std::shared_ptr<const DecodedBlock>>;
+  std::list<Entry> Entries;
+  std::map<Key, std::list<Entry>::iterator> Positions;
+  std::size_t Size = 0;
+  std::size_t Capacity = 0;
+  Entry Oversized;
+};
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshCellOrder.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshCellOrder.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+void AppendCellBlock(std::vector<CellBlock>& blocks, int EntityDim,
+		     int EntityTag, long long FirstCell,
+		     long long NumberOfCells)
+{
+  if (!blocks.empty() && blocks.back().EntityDim == EntityDim &&
+      blocks.back().EntityTag == EntityTag &&
+      blocks.back().FirstCell + blocks.back().NumberOfCells == FirstCell) {
+    blocks.back().NumberOfCells += NumberOfCells;
+  } else {
+    blocks.push_back({ EntityDim, EntityTag, FirstCell, NumberOfCells });
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename OffsetType>
+void OrderCells(std::vector<CellBlock> blocks, const OffsetType* offsets,
+		CellOrder& order)
+{
+  std::stable_sort(blocks.begin(), blocks.end(),
+		   [](const CellBlock& a, const CellBlock& b) {
+		     return a.EntityDim < b.EntityDim ||
+		       (a.EntityDim == b.EntityDim &&
+			a.EntityTag < b.EntityTag);
+		   });
+
+  const std::size_t NumberOfBlocks = blocks.size();
+  order.FirstCells.assign(NumberOfBlocks + 1, 0);
+  order.FirstVertices.assign(NumberOfBlocks + 1, 0);
+  for (std::size_t b = 0; b < NumberOfBlocks; ++b) {
+    const long long first = blocks[b].FirstCell;
+    const long long last = first + blocks[b].NumberOfCells;
+    order.FirstCells[b + 1] = order.FirstCells[b] + blocks[b].NumberOfCells;
+    order.FirstVertices[b + 1] = order.FirstVertices[b] +
+      static_cast<long long>(offsets[last] - offsets[first]);
+  }
+
+  std::size_t b = 0;
+  for (int dim = 0; dim < 4; ++dim) {
+    while (b < NumberOfBlocks && blocks[b].EntityDim < dim) {
+      ++b;
+    }
+    const long long begin = order.FirstCells[b];
+    while (b < NumberOfBlocks && blocks[b].EntityDim == dim) {
+      ++b;
+    }
+    order.DimensionRanges[dim] = { begin, order.FirstCells[b] };
+  }
+
+  order.EntityRanges.clear();
+  for (b = 0; b < NumberOfBlocks; ++b) {
+    std::size_t next = b + 1;
+    while (next < NumberOfBlocks &&
+	   blocks[next].EntityDim == blocks[b].EntityDim &&
+	   blocks[next].EntityTag == blocks[b].EntityTag) {
+      ++next;
+    }
+    order.EntityRanges.push_back({ blocks[b].EntityDim, blocks[b].EntityTag,
+				   order.FirstCells[b],
+				   order.FirstCells[next] });
+    b = next - 1;
+  }
+
+  order.Blocks = std::move(blocks);
+}
+
+template void OrderCells<int>(std::vector<CellBlock>, const int*,
+			      CellOrder&);
+template void OrderCells<long>(std::vector<CellBlock>, const long*,
+			       CellOrder&);
+template void OrderCells<long long>(std::vector<CellBlock>,
+				    const long long*, CellOrder&);
+}
@@ -0,0 +1,78 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshCellOrder.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Order of the cells of a mesh by dimension and entity.
+ *
+ * Cells are read in file order, as blocks of consecutive cells of one
+ * entity. Ordering the blocks by dimension, then by entity tag, keeping
+ * the file order within an entity, gives where each block is moved to and
+ * the range of cells of each dimension and entity, so that the cells can
+ * be moved as whole blocks, one block per thread.
+ */
+
+#ifndef GmshCellOrder_h
+#define GmshCellOrder_h
+
+#include <array>
+#include <vector>
+
+namespace GmshCore
+{
+/**
+ * Cells read from consecutive element blocks of one entity.
+ */
+struct CellBlock
+{
+  int EntityDim;
+  int EntityTag;
+  long long FirstCell;
+  long long NumberOfCells;
+};
+
+/**
+ * Record the cells of an element block, which extend the last block when
+ * they follow it in the same entity, as large blocks are delivered in
+ * several calls.
+ */
+void AppendCellBlock(std::vector<CellBlock>& blocks, int EntityDim,
+		     int EntityTag, long long FirstCell,
+		     long long NumberOfCells);
+
+/**
+ * Blocks in dimension and entity order, with the first cell and the first
+ * vertex of each once ordered, and the numbers of cells and vertices in
+ * last place. DimensionRanges holds the [begin, end) range of cells of the
+ * dimensions 0 to 3, empty for those without cells, and EntityRanges that
+ * of each entity as (dimension, tag, begin, end).
+ */
+struct CellOrder
+{
+  std::vector<CellBlock> Blocks;
+  std::vector<long long> FirstCells;
+  std::vector<long long> FirstVertices;
+  std::array<std::array<long long, 2>, 4> DimensionRanges;
+  std::vector<std::array<long long, 4>> EntityRanges;
+};
+
+/**
+ * Order the blocks of cells whose vertices are given by offsets, with the
+ * vertices of cell i from offsets[i] to offsets[i + 1].
+ */
+template <typename OffsetType>
+void OrderCells(std::vector<CellBlock> blocks, const OffsetType* offsets,
+		CellOrder& order);
+}
+
+#endif
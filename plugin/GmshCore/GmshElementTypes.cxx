@@ -0,0 +1,79 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshElementTypes.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshElementTypes.h"
+
+#include <array>
+
+namespace
+{
+// Type, name, dimension, topology, order, number of nodes.
+const GmshCore::ElementType ElementTypes[] = {
+  { 1, "Line 2", 1, 2, 1, 2 },
+  { 2, "Triangle 3", 2, 3, 1, 3 },
+  { 3, "Quadrilateral 4", 2, 4, 1, 4 },
+  { 4, "Tetrahedron 4", 3, 5, 1, 4 },
+  { 5, "Hexahedron 8", 3, 8, 1, 8 },
+  { 6, "Prism 6", 3, 7, 1, 6 },
+  { 7, "Pyramid 5", 3, 6, 1, 5 },
+  { 8, "Line 3", 1, 2, 2, 3 },
+  { 9, "Triangle 6", 2, 3, 2, 6 },
+  { 10, "Quadrilateral 9", 2, 4, 2, 9 },
+  { 11, "Tetrahedron 10", 3, 5, 2, 10 },
+  { 12, "Hexahedron 27", 3, 8, 2, 27 },
+  { 13, "Prism 18", 3, 7, 2, 18 },
+  { 14, "Pyramid 14", 3, 6, 2, 14 },
+  { 15, "Point 1", 0, 1, 0, 1 },
+  { 16, "Quadrilateral 8", 2, 4, 2, 8 },
+  { 17, "Hexahedron 20", 3, 8, 2, 20 },
+  { 18, "Prism 15", 3, 7, 2, 15 },
+  { 19, "Pyramid 13", 3, 6, 2, 13 },
+  { 20, "Triangle 9", 2, 3, 3, 9 },
+  { 21, "Triangle 10", 2, 3, 3, 10 },
+  { 22, "Triangle 12", 2, 3, 4, 12 },
+  { 23, "Triangle 15", 2, 3, 4, 15 },
+  { 24, "Triangle 15", 2, 3, 5, 15 },
+  { 25, "Triangle 21", 2, 3, 5, 21 },
+  { 26, "Line 4", 1, 2, 3, 4 },
+  { 27, "Line 5", 1, 2, 4, 5 },
+  { 28, "Line 6", 1, 2, 5, 6 },
+  { 29, "Tetrahedron 20", 3, 5, 3, 20 },
+  { 30, "Tetrahedron 35", 3, 5, 4, 35 },
+  { 31, "Tetrahedron 56", 3, 5, 5, 56 },
+  { 92, "Hexahedron 64", 3, 8, 3, 64 },
+  { 93, "Hexahedron 125", 3, 8, 4, 125 },
+};
+
+//----------------------------------------------------------------------------
+// Entries of the table indexed by type, for constant time lookups.
+std::array<const GmshCore::ElementType*, 256> BuildLookup()
+{
+  std::array<const GmshCore::ElementType*, 256> lookup{};
+  for (const auto& type : ElementTypes) {
+    lookup[type.Type] = &type;
+  }
+  return lookup;
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+const ElementType* GetElementType(int type)
+{
+  static const std::array<const ElementType*, 256> lookup = BuildLookup();
+  return type >= 0 && type < static_cast<int>(lookup.size())
+    ? lookup[type] : nullptr;
+}
+}
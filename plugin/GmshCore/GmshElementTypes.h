@@ -0,0 +1,47 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshElementTypes.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Table of the Gmsh element types.
+ */
+
+#ifndef GmshElementTypes_h
+#define GmshElementTypes_h
+
+namespace GmshCore
+{
+/**
+ * Description of a Gmsh element type. Topology uses the numbering of the
+ * $InterpolationScheme section: 1 for points, 2 for lines, 3 for
+ * triangles, 4 for quadrangles, 5 for tetrahedra, 6 for pyramids, 7 for
+ * prisms and 8 for hexahedra.
+ */
+struct ElementType
+{
+  int Type;
+  const char* Name;
+  int Dimension;
+  int Topology;
+  int Order;
+  int NumberOfNodes;
+};
+
+/**
+ * Get the description of a Gmsh element type, or nullptr when the type is
+ * unknown.
+ */
+const ElementType* GetElementType(int type);
+}
+
+#endif
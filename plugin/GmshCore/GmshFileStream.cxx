@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshFileStream.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshFileStream.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifndef _WIN32
+// Reads are made in blocks of this size, at offsets and into a buffer
+// aligned as O_DIRECT requires.
+constexpr std::size_t BlockSize = std::size_t(4) << 20;
+constexpr std::size_t Alignment = 4096;
+
+//----------------------------------------------------------------------------
+// Stream buffer reading a file with pread in large aligned blocks, either
+// through O_DIRECT or dropping the cached pages behind the read cursor.
+class UncachedFileBuffer : public std::streambuf
+{
+public:
+  UncachedFileBuffer() = default;
+  ~UncachedFileBuffer() override
+  {
+    if (this->FileDescriptor >= 0) {
+      close(this->FileDescriptor);
+    }
+    std::free(this->Data);
+  }
+
+  bool Open(const std::string& FileName, bool direct)
+  {
+    void* data = nullptr;
+    if (posix_memalign(&data, Alignment, BlockSize) != 0) {
+      return false;
+    }
+    this->Data = static_cast<char*>(data);
+
+#if defined(O_DIRECT)
+    if (direct) {
+      this->FileDescriptor = open(FileName.c_str(), O_RDONLY | O_DIRECT);
+      this->Direct = this->FileDescriptor >= 0;
+    }
+#endif
+    if (this->FileDescriptor < 0) {
+      this->FileDescriptor = open(FileName.c_str(), O_RDONLY);
+    }
+    if (this->FileDescriptor < 0) {
+      return false;
+    }
+
+#if defined(F_NOCACHE)
+    if (direct) {
+      this->Direct = fcntl(this->FileDescriptor, F_NOCACHE, 1) == 0;
+    }
+#endif
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (!this->Direct) {
+      posix_fadvise(this->FileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+    return true;
+  }
+
+protected:
+  int_type underflow() override
+  {
+    if (this->gptr() < this->egptr()) {
+      return traits_type::to_int_type(*this->gptr());
+    }
+
+    const std::streamoff next =
+      this->BlockOffset + (this->egptr() - this->eback());
+    if (!this->Load(next)) {
+      return traits_type::eof();
+    }
+    return traits_type::to_int_type(*this->gptr());
+  }
+
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+		   std::ios_base::openmode which) override
+  {
+    std::streamoff base = 0;
+    if (dir == std::ios_base::cur) {
+      base = this->BlockOffset + (this->gptr() - this->eback());
+    } else if (dir == std::ios_base::end) {
+      struct stat status;
+      if (fstat(this->FileDescriptor, &status) != 0) {
+	return pos_type(off_type(-1));
+      }
+      base = status.st_size;
+    }
+    return this->seekpos(pos_type(base + off), which);
+  }
+
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+  {
+    const std::streamoff offset = pos;
+    if (!(which & std::ios_base::in) || offset < 0) {
+      return pos_type(off_type(-1));
+    }
+
+    // Within the loaded block only the read cursor moves; otherwise the
+    // block holding the offset is loaded by the next read.
+    const std::streamoff loaded = this->egptr() - this->eback();
+    if (this->eback() && offset >= this->BlockOffset &&
+	offset <= this->BlockOffset + loaded) {
+      this->setg(this->eback(),
+		 this->eback() + (offset - this->BlockOffset), this->egptr());
+    } else {
+      this->BlockOffset = offset;
+      this->setg(this->Data, this->Data, this->Data);
+    }
+    return pos;
+  }
+
+private:
+  // Load the aligned block holding the given offset.
+  bool Load(std::streamoff offset)
+  {
+    const std::streamoff aligned =
+      offset - offset % static_cast<std::streamoff>(Alignment);
+
+    ssize_t count =
+      pread(this->FileDescriptor, this->Data, BlockSize, aligned);
+    while (count < 0 && errno == EINTR) {
+      count = pread(this->FileDescriptor, this->Data, BlockSize, aligned);
+    }
+
+#if defined(O_DIRECT)
+    // Some file systems accept O_DIRECT at open time but not on reads;
+    // those are read through the page cache instead.
+    if (count < 0 && errno == EINVAL && this->Direct) {
+      const int flags = fcntl(this->FileDescriptor, F_GETFL);
+      fcntl(this->FileDescriptor, F_SETFL, flags & ~O_DIRECT);
+      this->Direct = false;
+      return this->Load(offset);
+    }
+#endif
+
+    this->BlockOffset = aligned;
+    if (count <= offset - aligned) {
+      this->setg(this->Data, this->Data, this->Data);
+      this->BlockOffset = offset;
+      return false;
+    }
+    this->setg(this->Data, this->Data + (offset - aligned),
+	       this->Data + count);
+
+#if defined(POSIX_FADV_DONTNEED)
+    // Pages before the block are not needed anymore.
+    if (!this->Direct) {
+      if (aligned > this->Dropped) {
+	posix_fadvise(this->FileDescriptor, this->Dropped,
+		      aligned - this->Dropped, POSIX_FADV_DONTNEED);
+      }
+      this->Dropped = aligned;
+    }
+#endif
+    return true;
+  }
+
+  int FileDescriptor = -1;
+  bool Direct = false;
+  char* Data = nullptr;
+  // File offset of the first byte of the buffer.
+  std::streamoff BlockOffset = 0;
+  // Offset up to which cached pages were dropped.
+  std::streamoff Dropped = 0;
+};
+#endif
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+FileStream::FileStream(const std::string& FileName, IOPolicy policy)
+  : std::istream(nullptr)
+{
+  bool opened = false;
+#ifndef _WIN32
+  if (policy != IOPolicy::Buffered) {
+    auto buffer = std::make_unique<UncachedFileBuffer>();
+    opened = buffer->Open(FileName, policy == IOPolicy::Direct);
+    this->Buffer = std::move(buffer);
+  }
+#else
+  (void)policy;
+#endif
+  if (!this->Buffer) {
+    auto buffer = std::make_unique<std::filebuf>();
+    opened = buffer->open(FileName, std::ios_base::in) != nullptr;
+    this->Buffer = std::move(buffer);
+  }
+
+  this->rdbuf(this->Buffer.get());
+  if (!opened) {
+    this->setstate(std::ios_base::failbit);
+  }
+}
+
+//----------------------------------------------------------------------------
+FileStream::~FileStream() = default;
+}
@@ -0,0 +1,60 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshFileStream.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   GmshCore::FileStream
+ * @brief   Input file stream with a selectable page cache policy.
+ *
+ * Buffered reads go through a std::filebuf, like std::ifstream. The other
+ * policies read the file in large aligned blocks for one-shot conversions
+ * that should not evict the page cache of co-located jobs: DropBehind
+ * advises the kernel to drop the pages behind the read cursor, and Direct
+ * bypasses the page cache with O_DIRECT (F_NOCACHE on macOS), falling back
+ * to DropBehind on file systems that do not support it. Both fall back to
+ * Buffered on Windows.
+ */
+
+#ifndef GmshFileStream_h
+#define GmshFileStream_h
+
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace GmshCore
+{
+enum class IOPolicy
+{
+  Buffered,
+  DropBehind,
+  Direct
+};
+
+class FileStream : public std::istream
+{
+public:
+  explicit FileStream(const std::string& FileName,
+		      IOPolicy policy = IOPolicy::Buffered);
+  ~FileStream() override;
+
+  FileStream(const FileStream&) = delete;
+  FileStream& operator=(const FileStream&) = delete;
+
+private:
+  std::unique_ptr<std::streambuf> Buffer;
+};
+}
+
+#endif
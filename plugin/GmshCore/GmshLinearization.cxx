@@ -0,0 +1,381 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshLinearization.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshLinearization.h"
+
+#include "GmshElementTypes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Point of a split rule, the average of some corners of the cell being
+// split, a corner being repeated to weigh it more.
+struct RulePoint
+{
+  int NumberOfCorners;
+  int Corners[8];
+};
+
+//----------------------------------------------------------------------------
+// Lines: the midpoint, and the quarter points as probes.
+const RulePoint LinePoints[] = { { 2, { 0, 1 } } };
+const int LineChildren[] = { 0, 2,  2, 1 };
+const RulePoint LineProbes[] = { { 4, { 0, 0, 0, 1 } },
+				 { 4, { 0, 1, 1, 1 } } };
+
+//----------------------------------------------------------------------------
+// Triangles: the edge midpoints in gmsh order, and the centroid as probe.
+const RulePoint TrianglePoints[] = {
+  { 2, { 0, 1 } }, { 2, { 1, 2 } }, { 2, { 2, 0 } } };
+const int TriangleChildren[] = { 0, 3, 5,  3, 1, 4,  5, 4, 2,  3, 4, 5 };
+const RulePoint TriangleProbes[] = { { 3, { 0, 1, 2 } } };
+
+//----------------------------------------------------------------------------
+// Quadrangles: the edge midpoints and the center, as in the 9-node
+// quadrangle.
+const RulePoint QuadranglePoints[] = {
+  { 2, { 0, 1 } }, { 2, { 1, 2 } }, { 2, { 2, 3 } }, { 2, { 3, 0 } },
+  { 4, { 0, 1, 2, 3 } } };
+const int QuadrangleChildren[] = {
+  0, 4, 8, 7,  4, 1, 5, 8,  8, 5, 2, 6,  7, 8, 6, 3 };
+
+//----------------------------------------------------------------------------
+// Tetrahedra: the edge midpoints, as in the 10-node tetrahedron, split
+// along the 4-8 diagonal, and the face centroids and centroid as probes.
+const RulePoint TetrahedronPoints[] = {
+  { 2, { 0, 1 } }, { 2, { 1, 2 } }, { 2, { 2, 0 } },
+  { 2, { 3, 0 } }, { 2, { 3, 2 } }, { 2, { 3, 1 } } };
+const int TetrahedronChildren[] = {
+  0, 4, 6, 7,  4, 1, 5, 9,  6, 5, 2, 8,  7, 9, 8, 3,
+  4, 8, 9, 5,  4, 8, 7, 9,  4, 8, 6, 7,  4, 8, 5, 6 };
+const RulePoint TetrahedronProbes[] = {
+  { 3, { 0, 1, 2 } }, { 3, { 0, 1, 3 } }, { 3, { 0, 2, 3 } },
+  { 3, { 1, 2, 3 } }, { 4, { 0, 1, 2, 3 } } };
+
+//----------------------------------------------------------------------------
+// Hexahedra: the edge midpoints, face centers and center, as in the
+// 27-node hexahedron.
+const RulePoint HexahedronPoints[] = {
+  { 2, { 0, 1 } }, { 2, { 0, 3 } }, { 2, { 0, 4 } }, { 2, { 1, 2 } },
+  { 2, { 1, 5 } }, { 2, { 2, 3 } }, { 2, { 2, 6 } }, { 2, { 3, 7 } },
+  { 2, { 4, 5 } }, { 2, { 4, 7 } }, { 2, { 5, 6 } }, { 2, { 6, 7 } },
+  { 4, { 0, 3, 2, 1 } }, { 4, { 0, 1, 5, 4 } }, { 4, { 0, 4, 7, 3 } },
+  { 4, { 1, 2, 6, 5 } }, { 4, { 2, 3, 7, 6 } }, { 4, { 4, 5, 6, 7 } },
+  { 8, { 0, 1, 2, 3, 4, 5, 6, 7 } } };
+const int HexahedronChildren[] = {
+  0, 8, 20, 9, 10, 21, 26, 22,  8, 1, 11, 20, 21, 12, 23, 26,
+  9, 20, 13, 3, 22, 26, 24, 15,  20, 11, 2, 13, 26, 23, 14, 24,
+  10, 21, 26, 22, 4, 16, 25, 17,  21, 12, 23, 26, 16, 5, 18, 25,
+  22, 26, 24, 15, 17, 25, 19, 7,  26, 23, 14, 24, 25, 18, 6, 19 };
+
+//----------------------------------------------------------------------------
+// Prisms: the edge midpoints and the centers of the quadrangular faces, as
+// in the 18-node prism, and the centroids of the triangular faces and of
+// the prism as probes.
+const RulePoint PrismPoints[] = {
+  { 2, { 0, 1 } }, { 2, { 0, 2 } }, { 2, { 0, 3 } }, { 2, { 1, 2 } },
+  { 2, { 1, 4 } }, { 2, { 2, 5 } }, { 2, { 3, 4 } }, { 2, { 3, 5 } },
+  { 2, { 4, 5 } }, { 4, { 0, 1, 4, 3 } }, { 4, { 0, 3, 5, 2 } },
+  { 4, { 1, 2, 5, 4 } } };
+const int PrismChildren[] = {
+  0, 6, 7, 8, 15, 16,  6, 1, 9, 15, 10, 17,
+  7, 9, 2, 16, 17, 11,  6, 9, 7, 15, 17, 16,
+  8, 15, 16, 3, 12, 13,  15, 10, 17, 12, 4, 14,
+  16, 17, 11, 13, 14, 5,  15, 17, 16, 12, 14, 13 };
+const RulePoint PrismProbes[] = {
+  { 3, { 0, 1, 2 } }, { 3, { 3, 4, 5 } }, { 6, { 0, 1, 2, 3, 4, 5 } } };
+
+//----------------------------------------------------------------------------
+template <typename T, int N>
+constexpr int Count(const T (&)[N])
+{
+  return N;
+}
+
+//----------------------------------------------------------------------------
+// Reference coordinates of a rule point of a cell.
+void GetRuleCoordinates(const RulePoint& point, const int* corners,
+			const std::vector<double>& coordinates, double uvw[3])
+{
+  uvw[0] = uvw[1] = uvw[2] = 0.0;
+  for (int i = 0; i < point.NumberOfCorners; ++i) {
+    const double* corner = coordinates.data() + 3 * corners[point.Corners[i]];
+    for (int c = 0; c < 3; ++c) {
+      uvw[c] += corner[c];
+    }
+  }
+  for (int c = 0; c < 3; ++c) {
+    uvw[c] /= point.NumberOfCorners;
+  }
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+// Split of a cell into cells of its topology through new points, numbered
+// after its corners, and points probed on top of these to decide whether
+// to split.
+struct Linearizer::SplitRule
+{
+  int NumberOfCorners;
+  const RulePoint* Points;
+  int NumberOfPoints;
+  const int* Children;
+  int NumberOfChildren;
+  const RulePoint* Probes;
+  int NumberOfProbes;
+};
+
+//----------------------------------------------------------------------------
+bool Linearizer::Initialize(int type, int NumberOfValues, const double* ranges,
+			    double tolerance, int MaximumDepth)
+{
+  static const SplitRule Rules[] = {
+    { 2, LinePoints, Count(LinePoints), LineChildren,
+      Count(LineChildren) / 2, LineProbes, Count(LineProbes) },
+    { 3, TrianglePoints, Count(TrianglePoints), TriangleChildren,
+      Count(TriangleChildren) / 3, TriangleProbes, Count(TriangleProbes) },
+    { 4, QuadranglePoints, Count(QuadranglePoints), QuadrangleChildren,
+      Count(QuadrangleChildren) / 4, nullptr, 0 },
+    { 4, TetrahedronPoints, Count(TetrahedronPoints), TetrahedronChildren,
+      Count(TetrahedronChildren) / 4, TetrahedronProbes,
+      Count(TetrahedronProbes) },
+    { 8, HexahedronPoints, Count(HexahedronPoints), HexahedronChildren,
+      Count(HexahedronChildren) / 8, nullptr, 0 },
+    { 6, PrismPoints, Count(PrismPoints), PrismChildren,
+      Count(PrismChildren) / 6, PrismProbes, Count(PrismProbes) },
+  };
+
+  this->Rule = nullptr;
+  const ElementType* element = GetElementType(type);
+  if (!element || !this->Basis.Initialize(type)) {
+    return false;
+  }
+  switch (element->Topology) {
+  case 2: this->Rule = &Rules[0]; break;
+  case 3: this->Rule = &Rules[1]; break;
+  case 4: this->Rule = &Rules[2]; break;
+  case 5: this->Rule = &Rules[3]; break;
+  case 8: this->Rule = &Rules[4]; break;
+  case 7: this->Rule = &Rules[5]; break;
+  default: return false;
+  }
+
+  this->NumberOfValues = NumberOfValues;
+  this->Tolerance = tolerance;
+  this->MaximumDepth = MaximumDepth;
+
+  // Field components without range are not checked.
+  this->Thresholds.clear();
+  for (int k = 3; k < NumberOfValues; ++k) {
+    const double range = ranges[k - 3];
+    this->Thresholds.push_back(range > 0.0 ? tolerance * range : -1.0);
+  }
+
+  this->NodeLookup.clear();
+  const std::vector<double>& nodes = this->Basis.GetNodes();
+  for (int i = 0; i < this->Basis.GetNumberOfNodes(); ++i) {
+    this->NodeLookup.emplace(
+      std::array<double, 3>{ nodes[3 * i], nodes[3 * i + 1],
+			     nodes[3 * i + 2] }, i);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int Linearizer::GetNumberOfCorners() const
+{
+  return this->Rule ? this->Rule->NumberOfCorners : 0;
+}
+
+//----------------------------------------------------------------------------
+void Linearizer::Subdivide(const double* values, LinearCells& cells) const
+{
+  cells.NumberOfCorners = this->Rule->NumberOfCorners;
+  cells.Points.clear();
+  cells.Values.clear();
+  cells.Corners.clear();
+  cells.Coordinates.clear();
+  cells.PointValues.clear();
+  cells.PointNodes.clear();
+  cells.Output.clear();
+  cells.Lookup.clear();
+  cells.Weights.resize(this->Basis.GetNumberOfNodes());
+
+  // Gmsh numbers the corners of every element first.
+  int corners[8];
+  const double* nodes = this->Basis.GetNodes().data();
+  for (int i = 0; i < this->Rule->NumberOfCorners; ++i) {
+    corners[i] = this->GetPoint(nodes + 3 * i, values, cells);
+  }
+  this->Split(corners, 0, values, cells);
+}
+
+//----------------------------------------------------------------------------
+// Index of the point at reference coordinates uvw, added with its values
+// on first use.
+int Linearizer::GetPoint(const double uvw[3], const double* values,
+			 LinearCells& cells) const
+{
+  const std::array<double, 3> key{ uvw[0], uvw[1], uvw[2] };
+  const auto inserted = cells.Lookup.emplace(
+    key, static_cast<int>(cells.PointNodes.size()));
+  if (!inserted.second) {
+    return inserted.first->second;
+  }
+
+  const auto node = this->NodeLookup.find(key);
+  const int n = this->NumberOfValues;
+  const std::size_t first = cells.PointValues.size();
+  cells.Coordinates.insert(cells.Coordinates.end(), uvw, uvw + 3);
+  cells.PointValues.resize(first + n);
+  if (node != this->NodeLookup.end()) {
+    std::copy_n(values + node->second * n, n, &cells.PointValues[first]);
+    cells.PointNodes.push_back(node->second);
+  } else {
+    this->Evaluate(uvw, values, cells, &cells.PointValues[first]);
+    cells.PointNodes.push_back(-1);
+  }
+  cells.Output.push_back(-1);
+  return inserted.first->second;
+}
+
+//----------------------------------------------------------------------------
+// Interpolate the node values at reference coordinates uvw.
+void Linearizer::Evaluate(const double uvw[3], const double* values,
+			  LinearCells& cells, double* result) const
+{
+  const int n = this->NumberOfValues;
+  this->Basis.Evaluate(uvw, cells.Weights.data());
+  std::fill_n(result, n, 0.0);
+  for (int i = 0; i < this->Basis.GetNumberOfNodes(); ++i) {
+    const double weight = cells.Weights[i];
+    const double* node = values + i * n;
+    for (int k = 0; k < n; ++k) {
+      result[k] += weight * node[k];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Whether the element deviates from the linear cell with the given corners
+// by more than the tolerance at the rule points or probes of the cell.
+bool Linearizer::NeedsSplit(const int* corners, const double* values,
+			    LinearCells& cells) const
+{
+  if (this->Tolerance <= 0.0) {
+    return true;
+  }
+
+  const SplitRule& rule = *this->Rule;
+  const int n = this->NumberOfValues;
+
+  // Geometric deviations are relative to the diameter of the cell.
+  double diameter = 0.0;
+  for (int a = 0; a < rule.NumberOfCorners; ++a) {
+    for (int b = a + 1; b < rule.NumberOfCorners; ++b) {
+      const double* p = &cells.PointValues[corners[a] * n];
+      const double* q = &cells.PointValues[corners[b] * n];
+      double length = 0.0;
+      for (int c = 0; c < 3; ++c) {
+	length += (q[c] - p[c]) * (q[c] - p[c]);
+      }
+      diameter = std::max(diameter, length);
+    }
+  }
+  const double MaximumDeviation = this->Tolerance * this->Tolerance * diameter;
+
+  cells.Probe.resize(n);
+  auto Deviates = [&](const RulePoint& point, const double* actual) {
+    double deviation = 0.0;
+    for (int k = 0; k < n; ++k) {
+      double linear = 0.0;
+      for (int i = 0; i < point.NumberOfCorners; ++i) {
+	linear += cells.PointValues[corners[point.Corners[i]] * n + k];
+      }
+      const double d = actual[k] - linear / point.NumberOfCorners;
+      if (k < 3) {
+	deviation += d * d;
+      } else if (this->Thresholds[k - 3] >= 0.0 &&
+		 std::abs(d) > this->Thresholds[k - 3]) {
+	return true;
+      }
+    }
+    return deviation > MaximumDeviation;
+  };
+
+  // The rule points are kept for the split.
+  double uvw[3];
+  for (int i = 0; i < rule.NumberOfPoints; ++i) {
+    GetRuleCoordinates(rule.Points[i], corners, cells.Coordinates, uvw);
+    const int point = this->GetPoint(uvw, values, cells);
+    if (Deviates(rule.Points[i], &cells.PointValues[point * n])) {
+      return true;
+    }
+  }
+  for (int i = 0; i < rule.NumberOfProbes; ++i) {
+    GetRuleCoordinates(rule.Probes[i], corners, cells.Coordinates, uvw);
+    this->Evaluate(uvw, values, cells, cells.Probe.data());
+    if (Deviates(rule.Probes[i], cells.Probe.data())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Output the cell with the given corners, or its children when it is
+// split.
+void Linearizer::Split(const int* corners, int depth, const double* values,
+		       LinearCells& cells) const
+{
+  const SplitRule& rule = *this->Rule;
+  if (depth < this->MaximumDepth && this->NeedsSplit(corners, values, cells)) {
+    int points[27];
+    std::copy_n(corners, rule.NumberOfCorners, points);
+    double uvw[3];
+    for (int i = 0; i < rule.NumberOfPoints; ++i) {
+      GetRuleCoordinates(rule.Points[i], corners, cells.Coordinates, uvw);
+      points[rule.NumberOfCorners + i] = this->GetPoint(uvw, values, cells);
+    }
+
+    int child[8];
+    for (int c = 0; c < rule.NumberOfChildren; ++c) {
+      for (int i = 0; i < rule.NumberOfCorners; ++i) {
+	child[i] = points[rule.Children[c * rule.NumberOfCorners + i]];
+      }
+      this->Split(child, depth + 1, values, cells);
+    }
+    return;
+  }
+
+  const int n = this->NumberOfValues;
+  for (int i = 0; i < rule.NumberOfCorners; ++i) {
+    const int point = corners[i];
+    if (cells.Output[point] < 0) {
+      cells.Output[point] = static_cast<int>(cells.Points.size());
+      cells.Points.push_back(cells.PointNodes[point]);
+      if (cells.PointNodes[point] < 0) {
+	const double* first = &cells.PointValues[point * n];
+	cells.Values.insert(cells.Values.end(), first, first + n);
+      }
+    }
+    cells.Corners.push_back(cells.Output[point]);
+  }
+}
+}
@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshLinearization.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   GmshCore::Linearizer
+ * @brief   Adaptive subdivision of high-order elements into linear cells.
+ *
+ * The reference cell of an element is split into linear cells of its
+ * topology by halving every edge, and each of these cells is split again
+ * while the element deviates from it by more than a tolerance, up to a
+ * maximum depth. The deviation is measured at the points the split would
+ * add and at the centers of the faces and of the cell: the element is
+ * mapped there from the coordinates of its nodes by its Lagrange basis,
+ * and fields are interpolated from their nodal values, then compared with
+ * the linear interpolation of the cell corners, relative to the diameter
+ * of the cell for the geometry and to the range of each field component.
+ * Points that fall on a node of the element are that node, so that
+ * neighboring elements share them; the others are private to the element.
+ */
+
+#ifndef GmshLinearization_h
+#define GmshLinearization_h
+
+#include "GmshReferenceElements.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace GmshCore
+{
+/**
+ * Linear cells replacing one element. Points lists the element node each
+ * point of the cells is at, or -1 for points inside the element, whose
+ * values are appended to Values in that order. Corners lists
+ * NumberOfCorners indices into Points per cell.
+ */
+struct LinearCells
+{
+  int NumberOfCorners = 0;
+  std::vector<int> Points;
+  std::vector<double> Values;
+  std::vector<int> Corners;
+
+  // Points visited by the subdivision, kept between calls to save
+  // allocations: their reference coordinates, values, node and index in
+  // Points, or -1 while no cell uses them.
+  std::vector<double> Coordinates;
+  std::vector<double> PointValues;
+  std::vector<int> PointNodes;
+  std::vector<int> Output;
+  std::map<std::array<double, 3>, int> Lookup;
+  std::vector<double> Weights;
+  std::vector<double> Probe;
+};
+
+class Linearizer
+{
+public:
+  /**
+   * Prepare the subdivision of elements of a type whose nodes carry
+   * NumberOfValues values each: x, y and z, then field components, whose
+   * NumberOfValues - 3 ranges are given. Returns false for types without
+   * a Lagrange basis and for points. A tolerance of 0 splits every cell
+   * down to the maximum depth.
+   */
+  bool Initialize(int type, int NumberOfValues, const double* ranges,
+		  double tolerance, int MaximumDepth);
+
+  int GetNumberOfCorners() const;
+
+  /**
+   * Split an element given the values at its nodes, NumberOfValues per
+   * node in gmsh node order, into cells. Concurrent calls are safe with
+   * distinct cells.
+   */
+  void Subdivide(const double* values, LinearCells& cells) const;
+
+private:
+  struct SplitRule;
+
+  int GetPoint(const double uvw[3], const double* values,
+	       LinearCells& cells) const;
+  void Evaluate(const double uvw[3], const double* values,
+		LinearCells& cells, double* result) const;
+  bool NeedsSplit(const int* corners, const double* values,
+		  LinearCells& cells) const;
+  void Split(const int* corners, int depth, const double* values,
+	     LinearCells& cells) const;
+
+  LagrangeBasis Basis;
+  const SplitRule* Rule = nullptr;
+  int NumberOfValues = 0;
+  std::vector<double> Thresholds;
+  double Tolerance = 0.0;
+  int MaximumDepth = 0;
+  std::map<std::array<double, 3>, int> NodeLookup;
+};
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshLoadPlan.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshLoadPlan.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Numbers of points, cells and cell vertices of the output at a level.
+struct LevelSizes
+{
+  double Points;
+  double Cells;
+  double Connectivity;
+};
+
+//----------------------------------------------------------------------------
+LevelSizes GetLevelSizes(const GmshCore::OutputSizes& sizes,
+			 GmshCore::Degradation level, bool explode)
+{
+  const bool boundary = level >= GmshCore::Degradation::Boundary;
+  LevelSizes result;
+  result.Cells = boundary ? sizes.BoundaryCells : sizes.Cells;
+  result.Connectivity =
+    boundary ? sizes.BoundaryConnectivity : sizes.Connectivity;
+  result.Points = explode ? result.Connectivity : sizes.Points;
+  return result;
+}
+
+//----------------------------------------------------------------------------
+// Whether the point ids and the offsets of the output fit 32-bit values.
+bool IsNarrow(const LevelSizes& sizes, GmshCore::Degradation level)
+{
+  const double limit =
+    static_cast<double>(std::numeric_limits<std::int32_t>::max());
+  return level >= GmshCore::Degradation::Connectivity &&
+    sizes.Points <= limit && sizes.Connectivity <= limit;
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+OutputSizes PredictOutputSizes(const std::vector<ElementBlockHeader>& blocks,
+			       std::size_t MaxNodeTag)
+{
+  OutputSizes sizes;
+  sizes.Points = static_cast<double>(MaxNodeTag);
+  for (const ElementBlockHeader& block : blocks) {
+    sizes.MeshDimension = std::max(sizes.MeshDimension, block.EntityDim);
+  }
+  for (const ElementBlockHeader& block : blocks) {
+    const double cells = static_cast<double>(block.NumberOfElements);
+    const double vertices = cells * block.Type->NumberOfNodes;
+    sizes.Cells += cells;
+    sizes.Connectivity += vertices;
+    if (block.EntityDim < sizes.MeshDimension) {
+      sizes.BoundaryCells += cells;
+      sizes.BoundaryConnectivity += vertices;
+    }
+  }
+  return sizes;
+}
+
+//----------------------------------------------------------------------------
+double PredictOutputBytes(const OutputSizes& sizes, Degradation level,
+			  bool explode)
+{
+  const LevelSizes output = GetLevelSizes(sizes, level, explode);
+  const double id = IsNarrow(output, level) ? 4.0 : 8.0;
+  const double coordinate = level >= Degradation::Coordinates ? 4.0 : 8.0;
+
+  double bytes = 3.0 * output.Points * coordinate +
+    (output.Cells + 1.0) * id + output.Connectivity * id + output.Cells;
+  const bool fields = level < Degradation::Fields;
+  bytes += 8.0 *
+    (output.Points *
+       (fields ? sizes.PointComponents : sizes.ExplicitPointComponents) +
+     output.Cells *
+       (fields ? sizes.CellComponents : sizes.ExplicitCellComponents) +
+     output.Connectivity *
+       (fields ? sizes.CellVertexComponents
+	       : sizes.ExplicitCellVertexComponents));
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+bool PlanLoad(const OutputSizes& sizes, double budget,
+	      Degradation MaximumLevel, bool explode, LoadPlan& plan)
+{
+  plan = LoadPlan();
+  plan.MeshDimension = sizes.MeshDimension;
+  plan.Estimate = PredictOutputBytes(sizes, Degradation::None, explode);
+  plan.Bytes = plan.Estimate;
+  while (plan.Bytes > budget && plan.Level < MaximumLevel &&
+	 (plan.Level < Degradation::Fields || sizes.BoundaryCells > 0.0)) {
+    plan.Level = static_cast<Degradation>(static_cast<int>(plan.Level) + 1);
+    plan.Bytes = PredictOutputBytes(sizes, plan.Level, explode);
+  }
+
+  plan.NarrowConnectivity =
+    IsNarrow(GetLevelSizes(sizes, plan.Level, explode), plan.Level);
+  plan.FloatCoordinates = plan.Level >= Degradation::Coordinates;
+  return plan.Bytes <= budget;
+}
+
+//----------------------------------------------------------------------------
+bool HasPlannedArrays(const LoadPlan& mesh, const LoadPlan& plan)
+{
+  const bool boundary = plan.Level >= Degradation::Boundary;
+  return mesh.NarrowConnectivity == plan.NarrowConnectivity &&
+    mesh.FloatCoordinates == plan.FloatCoordinates &&
+    (mesh.Level >= Degradation::Boundary) == boundary &&
+    (!boundary || mesh.MeshDimension == plan.MeshDimension);
+}
+}
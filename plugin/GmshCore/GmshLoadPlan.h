@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshLoadPlan.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Prediction of the size of the output of a mesh, and the
+ * reductions that make it fit a memory budget.
+ *
+ * The numbers of points, cells and cell vertices are predicted from the
+ * element block headers and the largest node tag, before any element is
+ * decoded, so that the mesh is read directly into the reduced arrays.
+ */
+
+#ifndef GmshLoadPlan_h
+#define GmshLoadPlan_h
+
+#include "GmshParser.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace GmshCore
+{
+/**
+ * Reductions of the output, each level applying those before it: 32-bit
+ * connectivity, float coordinates, no field data but the fields selected
+ * explicitly, then only the elements of lower dimension than the mesh.
+ */
+enum class Degradation
+{
+  None,
+  Connectivity,
+  Coordinates,
+  Fields,
+  Boundary
+};
+
+/**
+ * Numbers of points, cells, cell vertices and field components of the
+ * output of a mesh.
+ */
+struct OutputSizes
+{
+  double Points = 0.0;
+  double Cells = 0.0;
+  double Connectivity = 0.0;
+  // Cells of lower dimension than the mesh, and their vertices.
+  double BoundaryCells = 0.0;
+  double BoundaryConnectivity = 0.0;
+  int MeshDimension = 0;
+  // Components of the selected point, cell and cell vertex fields, and of
+  // those of them selected explicitly, which are kept at all levels.
+  double PointComponents = 0.0;
+  double CellComponents = 0.0;
+  double CellVertexComponents = 0.0;
+  double ExplicitPointComponents = 0.0;
+  double ExplicitCellComponents = 0.0;
+  double ExplicitCellVertexComponents = 0.0;
+};
+
+/**
+ * Numbers of points, cells and cell vertices of a mesh of element blocks
+ * whose largest node tag is MaxNodeTag, points being indexed by node tag.
+ * Field components are left to the caller.
+ */
+OutputSizes PredictOutputSizes(const std::vector<ElementBlockHeader>& blocks,
+			       std::size_t MaxNodeTag);
+
+/**
+ * Predicted size in bytes of the output at a level. Exploded cells have
+ * private copies of their points.
+ */
+double PredictOutputBytes(const OutputSizes& sizes, Degradation level,
+			  bool explode);
+
+/**
+ * Reductions chosen for a mesh, with the arrays they are read into and
+ * the predicted sizes of the output without and with them.
+ */
+struct LoadPlan
+{
+  Degradation Level = Degradation::None;
+  int MeshDimension = 3;
+  bool NarrowConnectivity = false;
+  bool FloatCoordinates = false;
+  double Estimate = 0.0;
+  double Bytes = 0.0;
+};
+
+/**
+ * Plan the lowest level, up to MaximumLevel, whose output fits a budget in
+ * bytes. Dropping the elements of the mesh dimension needs elements of
+ * lower dimension, and connectivity stays 64-bit when ids of the output
+ * exceed the 32-bit range. Return false if the output does not fit at any
+ * allowed level, with plan.Bytes the size at the last one.
+ */
+bool PlanLoad(const OutputSizes& sizes, double budget,
+	      Degradation MaximumLevel, bool explode, LoadPlan& plan);
+
+/**
+ * Whether a mesh read with one plan has the arrays planned by another, so
+ * that it is kept when only the fields they read differ.
+ */
+bool HasPlannedArrays(const LoadPlan& mesh, const LoadPlan& plan);
+}
+
+#endif
@@ -0,0 +1,31 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshMeshKey.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshMeshKey.h"
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+bool CanReuseMesh(const MeshKey& mesh, const MeshKey& request)
+{
+  return mesh.Signature == request.Signature &&
+    mesh.Partial == request.Partial && mesh.Piece == request.Piece &&
+    mesh.NumberOfPieces == request.NumberOfPieces &&
+    mesh.Entities == request.Entities &&
+    (mesh.Parametric || !request.Parametric) &&
+    mesh.SortedCells == request.SortedCells &&
+    (mesh.Validated || !request.Validated) &&
+    HasPlannedArrays(mesh.Plan, request.Plan);
+}
+}
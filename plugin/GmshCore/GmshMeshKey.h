@@ -0,0 +1,63 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshMeshKey.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Properties a mesh is read with, which decide whether the mesh
+ * kept from a previous update serves the next one.
+ *
+ * Every option that changes how a mesh is built or checked is part of the
+ * key, so that changing it reads the mesh again. Options that only add to
+ * the mesh, such as parametric coordinates or validation, are also served
+ * by a mesh read with them.
+ */
+
+#ifndef GmshMeshKey_h
+#define GmshMeshKey_h
+
+#include "GmshLoadPlan.h"
+
+#include <string>
+
+namespace GmshCore
+{
+struct MeshKey
+{
+  // $Nodes, $Elements and $Periodic headers of the file, which the files
+  // of a series sharing the mesh have in common.
+  std::string Signature;
+  // Partial meshes: pieces of a streaming pipeline, or the selected
+  // entities, one per line.
+  bool Partial = false;
+  int Piece = 0;
+  int NumberOfPieces = 1;
+  std::string Entities;
+  // Whether the mesh has the parametric coordinates of its nodes.
+  bool Parametric = false;
+  // Whether the cells are sorted by dimension and entity.
+  bool SortedCells = false;
+  // Whether the mesh was validated as it was parsed.
+  bool Validated = false;
+  // Reductions the mesh is read with for the memory budget.
+  LoadPlan Plan;
+};
+
+/**
+ * Whether a mesh read with the key mesh serves a request: both have the
+ * same signature, piece, entities, cell order and planned arrays, and the
+ * mesh has the parametric coordinates and the validation requested.
+ */
+bool CanReuseMesh(const MeshKey& mesh, const MeshKey& request);
+}
+
+#endif
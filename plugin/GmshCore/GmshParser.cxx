@@ -0,0 +1,866 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshParser.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshParser.h"
+
+#include "GmshTrace.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// Number of elements or data records delivered per callback, which bounds
+// the memory used by the parser buffers.
+constexpr std::size_t ChunkSize = 1 << 16;
+
+//----------------------------------------------------------------------------
+void TrimRight(std::string& line)
+{
+  const std::size_t last = line.find_last_not_of(" \t\r");
+  line.erase(last == std::string::npos ? 0 : last + 1);
+}
+
+//----------------------------------------------------------------------------
+// Read the header line of a node block.
+bool ReadNodeBlockHeader(GmshCore::Tokenizer& tokens,
+			 GmshCore::NodeBlockHeader& block)
+{
+  int Parametric;
+  if (!tokens.Read(block.EntityDim) || !tokens.Read(block.EntityTag) ||
+      !tokens.Read(Parametric) || !tokens.Read(block.NumberOfNodes)) {
+    return false;
+  }
+  block.Parametric = Parametric != 0;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Read the tags and coordinates of the nodes of a block or, when wanted is
+// given, of those of its nodes whose tags are in wanted, the coordinate
+// lines of the others being skipped.
+bool ReadNodeLines(GmshCore::Tokenizer& tokens,
+		   const GmshCore::NodeBlockHeader& header,
+		   const std::vector<std::size_t>* wanted,
+		   GmshCore::Handler& handler, std::string& error)
+{
+  const bool WantsParametric = handler.WantsParametricCoordinates();
+  const std::size_t NumberOfNodesInBlock = header.NumberOfNodes;
+  GmshCore::Trace::Scope scope(tokens.GetTrace(), "block", "$Nodes block");
+  scope.Argument("dim", header.EntityDim)
+    .Argument("tag", header.EntityTag)
+    .Argument("nodes", static_cast<double>(NumberOfNodesInBlock));
+
+  // Parametric nodes carry one parametric coordinate per dimension of
+  // their entity after x, y and z, skipped unless the handler wants them.
+  const int NumberOfParameters =
+    header.Parametric ? std::max(header.EntityDim, 0) : 0;
+  const int NumberOfDecoded = WantsParametric ? NumberOfParameters : 0;
+  std::vector<std::size_t> tags(NumberOfNodesInBlock);
+  std::vector<double> coordinates(3 * NumberOfNodesInBlock);
+  std::vector<double> parametric(NumberOfDecoded * NumberOfNodesInBlock);
+
+  for (std::size_t& tag : tags) {
+    tokens.Read(tag);
+  }
+
+  // The coordinates of each node are on a line of their own, which makes
+  // the lines of unwanted nodes cheap to skip.
+  if (wanted && NumberOfNodesInBlock > 0) {
+    tokens.SkipLine();
+  }
+
+  std::size_t kept = 0;
+  double* xyz = coordinates.data();
+  double* uvw = parametric.data();
+  for (std::size_t j = 0; j < NumberOfNodesInBlock; ++j) {
+    if (wanted &&
+	!std::binary_search(wanted->begin(), wanted->end(), tags[j])) {
+      tokens.SkipLine();
+      continue;
+    }
+    tags[kept++] = tags[j];
+    tokens.Read(*xyz++);
+    tokens.Read(*xyz++);
+    tokens.Read(*xyz++);
+    for (int k = 0; k < NumberOfDecoded; ++k) {
+      tokens.Read(*uvw++);
+    }
+    tokens.Skip(NumberOfParameters - NumberOfDecoded);
+    if (wanted) {
+      tokens.SkipLine();
+    }
+  }
+  tags.resize(kept);
+  coordinates.resize(3 * kept);
+  parametric.resize(NumberOfDecoded * kept);
+
+  if (tokens.Fail()) {
+    error = "Malformed $Nodes block of entity " +
+      std::to_string(header.EntityTag) + ".";
+    return false;
+  }
+
+  GmshCore::NodeBlock block;
+  block.EntityDim = header.EntityDim;
+  block.EntityTag = header.EntityTag;
+  block.Parametric = NumberOfParameters > 0;
+  block.Tags = tags;
+  block.Coordinates = coordinates;
+  block.ParametricCoordinates = parametric;
+  handler.OnNodeBlock(block);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Read count elements of a block, delivering them in chunks.
+bool ReadElementLines(GmshCore::Tokenizer& tokens,
+		      GmshCore::ElementBlock& block, std::size_t count,
+		      GmshCore::Handler& handler, std::string& error)
+{
+  std::vector<std::size_t> tags;
+  std::vector<std::size_t> NodeTags;
+  const std::size_t NumberOfNodes = block.Type->NumberOfNodes;
+  GmshCore::Trace::Scope scope(tokens.GetTrace(), "block",
+			       "$Elements block");
+  scope.Argument("dim", block.EntityDim)
+    .Argument("tag", block.EntityTag)
+    .Argument("type", block.Type->Type)
+    .Argument("elements", static_cast<double>(count));
+  for (std::size_t first = 0; first < count; first += ChunkSize) {
+    const std::size_t size = std::min(ChunkSize, count - first);
+    tags.resize(size);
+    NodeTags.resize(size * NumberOfNodes);
+
+    std::size_t* NodeTag = NodeTags.data();
+    for (std::size_t j = 0; j < size; ++j) {
+      tokens.Read(tags[j]);
+      for (std::size_t k = 0; k < NumberOfNodes; ++k) {
+	tokens.Read(*NodeTag++);
+      }
+    }
+
+    if (tokens.Fail()) {
+      error = "Malformed $Elements block of entity " +
+	std::to_string(block.EntityTag) + ".";
+      return false;
+    }
+
+    block.Tags = tags;
+    block.NodeTags = NodeTags;
+    handler.OnElementBlock(block);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string Unquote(const std::string& tag)
+{
+  const std::size_t first = tag.find('"');
+  const std::size_t last = tag.rfind('"');
+  if (first == std::string::npos || last == first) {
+    return tag;
+  }
+  return tag.substr(first + 1, last - first - 1);
+}
+
+//----------------------------------------------------------------------------
+// Skip lines up to the end marker of the named section, which may be the
+// unterminated last line of the stream.
+bool SkipToEndMarker(GmshCore::Tokenizer& tokens, const std::string& name)
+{
+  const std::string marker = "$End" + name;
+  for (std::string line; tokens.ReadLine(line, true);) {
+    TrimRight(line);
+    if (line == marker) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool ReadBlockSectionHeader(GmshCore::Tokenizer& tokens,
+			    GmshCore::BlockSectionHeader& header)
+{
+  return tokens.Read(header.NumberOfBlocks) &&
+    tokens.Read(header.NumberOfEntities) && tokens.Read(header.MinTag) &&
+    tokens.Read(header.MaxTag);
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+std::string DataViewHeader::GetName() const
+{
+  return this->StringTags.size() > 0 ? this->StringTags[0] : std::string();
+}
+
+//----------------------------------------------------------------------------
+std::string DataViewHeader::GetInterpolationScheme() const
+{
+  return this->StringTags.size() > 1 ? this->StringTags[1] : std::string();
+}
+
+//----------------------------------------------------------------------------
+double DataViewHeader::GetTime() const
+{
+  return this->RealTags.size() > 0 ? this->RealTags[0] : 0.0;
+}
+
+//----------------------------------------------------------------------------
+int DataViewHeader::GetTimeStep() const
+{
+  return this->IntegerTags.size() > 0
+    ? static_cast<int>(this->IntegerTags[0]) : 0;
+}
+
+//----------------------------------------------------------------------------
+int DataViewHeader::GetNumberOfComponents() const
+{
+  return this->IntegerTags.size() > 1
+    ? static_cast<int>(this->IntegerTags[1]) : 0;
+}
+
+//----------------------------------------------------------------------------
+std::size_t DataViewHeader::GetNumberOfEntities() const
+{
+  return this->IntegerTags.size() > 2 && this->IntegerTags[2] > 0
+    ? static_cast<std::size_t>(this->IntegerTags[2]) : 0;
+}
+
+//----------------------------------------------------------------------------
+bool GetDataKind(const std::string& SectionName, DataKind& kind)
+{
+  if (SectionName == "NodeData") {
+    kind = DataKind::Node;
+  } else if (SectionName == "ElementData") {
+    kind = DataKind::Element;
+  } else if (SectionName == "ElementNodeData") {
+    kind = DataKind::ElementNode;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+IndexResult IndexSections(Tokenizer& tokens, std::vector<Section>& sections)
+{
+  Trace::Scope scope(tokens.GetTrace(), "section", "Index sections");
+  IndexResult result;
+  for (std::string line;;) {
+    result.Offset = tokens.Tell();
+    if (!tokens.ReadLine(line)) {
+      return result;
+    }
+
+    TrimRight(line);
+    if (line.size() < 2 || line[0] != '$') {
+      continue;
+    }
+
+    Section section;
+    section.Name = line.substr(1);
+    section.Offset = result.Offset;
+    section.ContentOffset = tokens.Tell();
+
+    // Data views are skipped record by record, one per line, and must be
+    // followed by their end marker.
+    bool complete;
+    DataKind kind;
+    if (GetDataKind(section.Name, kind)) {
+      complete = ReadDataViewHeader(tokens, section.View);
+      section.RecordsOffset = tokens.Tell();
+      const std::size_t NumberOfRecords = section.View.GetNumberOfEntities();
+      for (std::size_t i = 0; complete && i < NumberOfRecords; ++i) {
+	complete = tokens.SkipLine();
+      }
+      if (complete) {
+	complete = tokens.ReadLine(line, true);
+	TrimRight(line);
+	if (complete && line != "$End" + section.Name) {
+	  result.Status = IndexStatus::Malformed;
+	  result.Offset = section.Offset;
+	  result.SectionName = section.Name;
+	  return result;
+	}
+      }
+    } else {
+      complete = tokens.ReadLine(section.FirstLine, true) &&
+	SkipToEndMarker(tokens, section.Name);
+      TrimRight(section.FirstLine);
+    }
+
+    if (!complete) {
+      result.Status = tokens.EndReached() ? IndexStatus::Incomplete
+					  : IndexStatus::Malformed;
+      result.Offset = section.Offset;
+      result.SectionName = section.Name;
+      return result;
+    }
+
+    sections.push_back(std::move(section));
+  }
+}
+
+//----------------------------------------------------------------------------
+bool ReadMeshFormat(Tokenizer& tokens, MeshFormat& format)
+{
+  return tokens.Read(format.Version) && tokens.Read(format.FileType) &&
+    tokens.Read(format.DataSize) && tokens.SkipLine();
+}
+
+//----------------------------------------------------------------------------
+bool ReadDataViewHeader(Tokenizer& tokens, DataViewHeader& header)
+{
+  int NumberOfStringTags;
+  if (!tokens.Read(NumberOfStringTags) || !tokens.SkipLine()) {
+    return false;
+  }
+  header.StringTags.resize(std::max(NumberOfStringTags, 0));
+  for (std::string& tag : header.StringTags) {
+    if (!tokens.ReadLine(tag)) {
+      return false;
+    }
+    tag = Unquote(tag);
+  }
+
+  int NumberOfRealTags;
+  if (!tokens.Read(NumberOfRealTags)) {
+    return false;
+  }
+  header.RealTags.resize(std::max(NumberOfRealTags, 0));
+  for (double& tag : header.RealTags) {
+    tokens.Read(tag);
+  }
+
+  int NumberOfIntegerTags;
+  if (!tokens.Read(NumberOfIntegerTags)) {
+    return false;
+  }
+  header.IntegerTags.resize(std::max(NumberOfIntegerTags, 0));
+  for (long long& tag : header.IntegerTags) {
+    tokens.Read(tag);
+  }
+
+  return tokens.SkipLine();
+}
+
+//----------------------------------------------------------------------------
+bool ReadNodes(Tokenizer& tokens, Handler& handler, std::string& error)
+{
+  BlockSectionHeader header;
+  if (!ReadBlockSectionHeader(tokens, header)) {
+    error = "Malformed $Nodes header.";
+    return false;
+  }
+  handler.OnNodes(header);
+
+  for (std::size_t i = 0; i < header.NumberOfBlocks; ++i) {
+    NodeBlockHeader block;
+    if (!ReadNodeBlockHeader(tokens, block)) {
+      error = "Malformed $Nodes block header.";
+      return false;
+    }
+    if (!ReadNodeLines(tokens, block, nullptr, handler, error)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadElements(Tokenizer& tokens, Handler& handler, std::string& error)
+{
+  BlockSectionHeader header;
+  if (!ReadBlockSectionHeader(tokens, header)) {
+    error = "Malformed $Elements header.";
+    return false;
+  }
+  handler.OnElements(header);
+
+  for (std::size_t i = 0; i < header.NumberOfBlocks; ++i) {
+    int EntityDim, EntityTag, Type;
+    std::size_t NumberOfElementsInBlock;
+    if (!tokens.Read(EntityDim) || !tokens.Read(EntityTag) ||
+	!tokens.Read(Type) || !tokens.Read(NumberOfElementsInBlock)) {
+      error = "Malformed $Elements block header.";
+      return false;
+    }
+
+    ElementBlock block;
+    block.EntityDim = EntityDim;
+    block.EntityTag = EntityTag;
+    block.Type = GetElementType(Type);
+    if (!block.Type) {
+      error = "Unknown element type " + std::to_string(Type) + ".";
+      return false;
+    }
+
+    if (!ReadElementLines(tokens, block, NumberOfElementsInBlock, handler,
+			  error)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadNodeBlockHeaders(Tokenizer& tokens, BlockSectionHeader& header,
+			  std::vector<NodeBlockHeader>& blocks,
+			  std::string& error)
+{
+  if (!ReadBlockSectionHeader(tokens, header)) {
+    error = "Malformed $Nodes header.";
+    return false;
+  }
+
+  blocks.clear();
+  blocks.reserve(header.NumberOfBlocks);
+  for (std::size_t i = 0; i < header.NumberOfBlocks; ++i) {
+    NodeBlockHeader block;
+    block.Offset = tokens.Tell();
+    if (!ReadNodeBlockHeader(tokens, block) || !tokens.SkipLine()) {
+      error = "Malformed $Nodes block header.";
+      return false;
+    }
+
+    // Each tag, then the coordinates of each node, are on a line of their
+    // own. The range of the tags lets readers pass over the blocks of
+    // nodes they do not need.
+    block.MinTag = std::numeric_limits<std::size_t>::max();
+    for (std::size_t j = 0; j < 2 * block.NumberOfNodes; ++j) {
+      std::size_t tag;
+      if ((j < block.NumberOfNodes && !tokens.Read(tag)) ||
+	  !tokens.SkipLine()) {
+	error = "Malformed $Nodes block of entity " +
+	  std::to_string(block.EntityTag) + ".";
+	return false;
+      }
+      if (j < block.NumberOfNodes) {
+	block.MinTag = std::min(block.MinTag, tag);
+	block.MaxTag = std::max(block.MaxTag, tag);
+      }
+    }
+    blocks.push_back(block);
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadNodeBlock(Tokenizer& tokens, const NodeBlockHeader& header,
+		   Handler& handler, std::string& error)
+{
+  tokens.Seek(header.Offset);
+  NodeBlockHeader block;
+  if (!ReadNodeBlockHeader(tokens, block)) {
+    error = "Malformed $Nodes block header.";
+    return false;
+  }
+  return ReadNodeLines(tokens, block, nullptr, handler, error);
+}
+
+//----------------------------------------------------------------------------
+bool ReadNodeBlock(Tokenizer& tokens, const NodeBlockHeader& header,
+		   const std::vector<std::size_t>& NodeTags, Handler& handler,
+		   std::string& error)
+{
+  tokens.Seek(header.Offset);
+  NodeBlockHeader block;
+  if (!ReadNodeBlockHeader(tokens, block)) {
+    error = "Malformed $Nodes block header.";
+    return false;
+  }
+  return ReadNodeLines(tokens, block, &NodeTags, handler, error);
+}
+
+//----------------------------------------------------------------------------
+bool ReadElementBlockHeaders(Tokenizer& tokens, BlockSectionHeader& header,
+			     std::vector<ElementBlockHeader>& blocks,
+			     std::string& error)
+{
+  if (!ReadBlockSectionHeader(tokens, header)) {
+    error = "Malformed $Elements header.";
+    return false;
+  }
+
+  blocks.clear();
+  blocks.reserve(header.NumberOfBlocks);
+  for (std::size_t i = 0; i < header.NumberOfBlocks; ++i) {
+    ElementBlockHeader block;
+    int Type;
+    if (!tokens.Read(block.EntityDim) || !tokens.Read(block.EntityTag) ||
+	!tokens.Read(Type) || !tokens.Read(block.NumberOfElements) ||
+	!tokens.SkipLine()) {
+      error = "Malformed $Elements block header.";
+      return false;
+    }
+
+    block.Type = GetElementType(Type);
+    if (!block.Type) {
+      error = "Unknown element type " + std::to_string(Type) + ".";
+      return false;
+    }
+
+    // Each element is on a line of its own.
+    block.Offset = tokens.Tell();
+    for (std::size_t j = 0; j < block.NumberOfElements; ++j) {
+      if (!tokens.SkipLine()) {
+	error = "Malformed $Elements block of entity " +
+	  std::to_string(block.EntityTag) + ".";
+	return false;
+      }
+    }
+    blocks.push_back(block);
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadElementBlock(Tokenizer& tokens, const ElementBlockHeader& header,
+		      std::size_t first, std::size_t count, Handler& handler,
+		      std::string& error)
+{
+  tokens.Seek(header.Offset);
+  for (std::size_t j = 0; j < first; ++j) {
+    if (!tokens.SkipLine()) {
+      error = "Malformed $Elements block of entity " +
+	std::to_string(header.EntityTag) + ".";
+      return false;
+    }
+  }
+
+  ElementBlock block;
+  block.EntityDim = header.EntityDim;
+  block.EntityTag = header.EntityTag;
+  block.Type = header.Type;
+  return ReadElementLines(tokens, block, count, handler, error);
+}
+
+//----------------------------------------------------------------------------
+bool ReadPeriodic(Tokenizer& tokens, Handler& handler, std::string& error)
+{
+  std::size_t NumberOfLinks;
+  if (!tokens.Read(NumberOfLinks)) {
+    error = "Malformed $Periodic header.";
+    return false;
+  }
+
+  std::vector<double> affine;
+  std::vector<std::size_t> NodeTags;
+  for (std::size_t i = 0; i < NumberOfLinks; ++i) {
+    PeriodicLink link;
+    std::size_t NumberOfValues;
+    if (!tokens.Read(link.EntityDim) || !tokens.Read(link.EntityTag) ||
+	!tokens.Read(link.MasterTag) || !tokens.Read(NumberOfValues)) {
+      error = "Malformed $Periodic link header.";
+      return false;
+    }
+
+    affine.resize(NumberOfValues);
+    for (double& value : affine) {
+      tokens.Read(value);
+    }
+
+    std::size_t NumberOfNodes = 0;
+    tokens.Read(NumberOfNodes);
+    NodeTags.resize(2 * NumberOfNodes);
+    for (std::size_t& tag : NodeTags) {
+      tokens.Read(tag);
+    }
+
+    if (tokens.Fail() || (NumberOfValues != 0 && NumberOfValues != 16)) {
+      error = "Malformed $Periodic link of entity " +
+	std::to_string(link.EntityTag) + ".";
+      return false;
+    }
+
+    link.Affine = affine;
+    link.NodeTags = NodeTags;
+    handler.OnPeriodicLink(link);
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadInterpolationScheme(Tokenizer& tokens, std::string& name,
+			     InterpolationScheme& scheme, std::string& error)
+{
+  if (!tokens.ReadLine(name)) {
+    error = "Malformed $InterpolationScheme header.";
+    return false;
+  }
+  TrimRight(name);
+  name = Unquote(name);
+
+  int NumberOfTopologies = 0;
+  tokens.Read(NumberOfTopologies);
+  std::vector<double> values;
+  for (int i = 0; i < NumberOfTopologies && !tokens.Fail(); ++i) {
+    int Topology = 0, NumberOfMatrices = 0;
+    tokens.Read(Topology);
+    tokens.Read(NumberOfMatrices);
+
+    // The first two matrices describe the field; the optional other two
+    // describe the geometry, which is interpolated with the mesh nodes.
+    InterpolationMatrices& matrices = scheme[Topology];
+    for (int m = 0; m < NumberOfMatrices; ++m) {
+      int NumberOfRows = -1, NumberOfColumns = -1;
+      tokens.Read(NumberOfRows);
+      tokens.Read(NumberOfColumns);
+      if (tokens.Fail() || NumberOfRows < 0 || NumberOfColumns < 0 ||
+	  (m == 1 && NumberOfColumns > 3)) {
+	error = "Malformed matrix in interpolation scheme \"" + name + "\".";
+	return false;
+      }
+
+      values.resize(static_cast<std::size_t>(NumberOfRows) * NumberOfColumns);
+      for (double& value : values) {
+	tokens.Read(value);
+      }
+
+      if (m == 0) {
+	matrices.NumberOfBasisFunctions = NumberOfRows;
+	matrices.Coefficients = values;
+      } else if (m == 1) {
+	matrices.NumberOfMonomials = NumberOfRows;
+	matrices.Exponents.assign(3 * static_cast<std::size_t>(NumberOfRows),
+				  0.0);
+	for (int r = 0; r < NumberOfRows; ++r) {
+	  std::copy_n(values.data() + r * NumberOfColumns, NumberOfColumns,
+		      matrices.Exponents.data() + 3 * r);
+	}
+      }
+    }
+
+    if (matrices.Coefficients.size() !=
+	static_cast<std::size_t>(matrices.NumberOfBasisFunctions) *
+	  matrices.NumberOfMonomials) {
+      error = "Mismatched matrices in interpolation scheme \"" + name + "\".";
+      return false;
+    }
+  }
+
+  if (tokens.Fail() || !tokens.SkipLine()) {
+    error = "Malformed interpolation scheme \"" + name + "\".";
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadDataRecords(Tokenizer& tokens, DataKind kind,
+		     const DataViewHeader& header, Handler& handler,
+		     std::string& error)
+{
+  const std::size_t NumberOfComponents =
+    static_cast<std::size_t>(std::max(header.GetNumberOfComponents(), 0));
+  const std::size_t NumberOfRecords = header.GetNumberOfEntities();
+
+  std::vector<std::size_t> tags;
+  std::vector<int> NumberOfNodes;
+  std::vector<double> values;
+
+  DataRecords records;
+  records.Kind = kind;
+  records.Header = &header;
+  for (std::size_t first = 0; first < NumberOfRecords; first += ChunkSize) {
+    const std::size_t count = std::min(ChunkSize, NumberOfRecords - first);
+    tags.resize(count);
+    NumberOfNodes.assign(kind == DataKind::ElementNode ? count : 0, 1);
+    values.clear();
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      tokens.Read(tags[kept]);
+      int n = 1;
+      if (kind == DataKind::ElementNode) {
+	tokens.Read(NumberOfNodes[kept]);
+	n = std::max(NumberOfNodes[kept], 0);
+      }
+
+      if (!handler.WantsRecord(tags[kept])) {
+	tokens.Skip(n * NumberOfComponents);
+      } else {
+	const std::size_t offset = values.size();
+	values.resize(offset + n * NumberOfComponents);
+	for (std::size_t k = offset; k < values.size(); ++k) {
+	  tokens.Read(values[k]);
+	}
+	++kept;
+      }
+
+      if (tokens.Fail()) {
+	error = "Malformed records in view \"" + header.GetName() + "\".";
+	return false;
+      }
+    }
+    tags.resize(kept);
+    NumberOfNodes.resize(kind == DataKind::ElementNode ? kept : 0);
+
+    records.Tags = tags;
+    records.NumberOfNodes = NumberOfNodes;
+    records.Values = values;
+    handler.OnDataRecords(records);
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ProbeDataRecords(Tokenizer& tokens, std::streamoff begin,
+		      std::streamoff end, std::size_t NumberOfRecords,
+		      int NumberOfComponents,
+		      const std::vector<std::size_t>& tags, double* values)
+{
+  std::vector<bool> found(tags.size(), false);
+  bool missing = false;
+
+  std::streamoff low = begin;
+  for (std::size_t j = 0; j < tags.size(); ++j) {
+    const std::size_t tag = tags[j];
+
+    // The record of the tag, if in order, starts in [low, high).
+    std::streamoff high = end;
+    while (high - low > ProbeWindow) {
+      const std::streamoff middle = low + (high - low) / 2;
+      tokens.Seek(middle);
+      const bool synchronized = tokens.SkipLine();
+      const std::streamoff start = tokens.Tell();
+      std::size_t other = 0;
+      if (!synchronized || start >= high) {
+	high = middle;
+      } else if (!tokens.Read(other) || other >= tag) {
+	high = start;
+      } else {
+	low = start;
+      }
+    }
+
+    tokens.Seek(low);
+    while (tokens.Tell() < end) {
+      const std::streamoff start = tokens.Tell();
+      std::size_t other = 0;
+      if (!tokens.Read(other) || other > tag) {
+	break;
+      }
+      low = start;
+      if (other == tag) {
+	double* Tuple = values + j * NumberOfComponents;
+	for (int k = 0; k < NumberOfComponents; ++k) {
+	  tokens.Read(Tuple[k]);
+	}
+	found[j] = !tokens.Fail();
+	break;
+      }
+      tokens.Skip(NumberOfComponents);
+    }
+    missing = missing || !found[j];
+  }
+
+  if (!missing) {
+    return true;
+  }
+
+  tokens.Seek(begin);
+  for (std::size_t i = 0; i < NumberOfRecords; ++i) {
+    std::size_t tag = 0;
+    tokens.Read(tag);
+    auto it = std::lower_bound(tags.begin(), tags.end(), tag);
+    const std::size_t j = it - tags.begin();
+    if (it == tags.end() || *it != tag || found[j]) {
+      tokens.Skip(NumberOfComponents);
+      continue;
+    }
+    double* Tuple = values + j * NumberOfComponents;
+    for (int k = 0; k < NumberOfComponents; ++k) {
+      tokens.Read(Tuple[k]);
+    }
+    found[j] = true;
+  }
+
+  return !tokens.Fail();
+}
+
+//----------------------------------------------------------------------------
+bool Parse(Tokenizer& tokens, Handler& handler, std::string& error)
+{
+  for (std::string line; tokens.ReadLine(line, true);) {
+    TrimRight(line);
+    if (line.size() < 2 || line[0] != '$') {
+      continue;
+    }
+
+    const std::string name = line.substr(1);
+    Trace::Scope scope(tokens.GetTrace(), "section", line);
+    bool status = true;
+    DataKind kind;
+    if (name == "MeshFormat") {
+      MeshFormat format;
+      status = ReadMeshFormat(tokens, format);
+      if (status && format.FileType != 0) {
+	error = "Binary files are not supported.";
+	return false;
+      }
+      if (status) {
+	handler.OnMeshFormat(format);
+      }
+    } else if (name == "Nodes") {
+      status = ReadNodes(tokens, handler, error);
+    } else if (name == "Elements") {
+      status = ReadElements(tokens, handler, error);
+    } else if (name == "Periodic") {
+      status = ReadPeriodic(tokens, handler, error);
+    } else if (name == "InterpolationScheme") {
+      std::string SchemeName;
+      InterpolationScheme scheme;
+      status = ReadInterpolationScheme(tokens, SchemeName, scheme, error);
+      if (status) {
+	handler.OnInterpolationScheme(SchemeName, scheme);
+      }
+    } else if (GetDataKind(name, kind)) {
+      DataViewHeader header;
+      status = ReadDataViewHeader(tokens, header);
+      if (status && handler.OnDataView(kind, header)) {
+	status = ReadDataRecords(tokens, kind, header, handler, error);
+      }
+    }
+
+    if (!status) {
+      if (error.empty()) {
+	error = "Malformed " + line + " section.";
+      }
+      return false;
+    }
+
+    if (!SkipToEndMarker(tokens, name)) {
+      error = "Missing $End" + name + " marker.";
+      return false;
+    }
+
+    if (!handler.OnEndSection(name)) {
+      break;
+    }
+  }
+
+  return true;
+}
+}
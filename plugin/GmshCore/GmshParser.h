@@ -0,0 +1,416 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshParser.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Parser of ASCII MSH 4.1 files, independent of VTK.
+ *
+ * Sections are either indexed, to seek later to the data views a consumer
+ * needs, or parsed in one pass with a Handler that receives the node
+ * blocks, element blocks, interpolation schemes and data view records,
+ * the blocks and records as spans over the parser buffers. Spans are only
+ * valid for the duration of the callback.
+ */
+
+#ifndef GmshParser_h
+#define GmshParser_h
+
+#include "GmshElementTypes.h"
+#include "GmshTokenizer.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace GmshCore
+{
+/**
+ * Read-only view of contiguous values.
+ */
+template <typename T>
+class Span
+{
+public:
+  Span() = default;
+  Span(const T* data, std::size_t size)
+    : Data(data)
+    , Size(size)
+  {
+  }
+  Span(const std::vector<T>& values)
+    : Data(values.data())
+    , Size(values.size())
+  {
+  }
+
+  const T* data() const { return this->Data; }
+  std::size_t size() const { return this->Size; }
+  bool empty() const { return this->Size == 0; }
+  const T& operator[](std::size_t i) const { return this->Data[i]; }
+  const T* begin() const { return this->Data; }
+  const T* end() const { return this->Data + this->Size; }
+
+private:
+  const T* Data = nullptr;
+  std::size_t Size = 0;
+};
+
+/**
+ * Content of the $MeshFormat section. FileType is 0 for ASCII files.
+ */
+struct MeshFormat
+{
+  double Version = 0.0;
+  int FileType = 0;
+  int DataSize = 0;
+};
+
+/**
+ * Header line of the $Nodes and $Elements sections.
+ */
+struct BlockSectionHeader
+{
+  std::size_t NumberOfBlocks = 0;
+  std::size_t NumberOfEntities = 0;
+  std::size_t MinTag = 0;
+  std::size_t MaxTag = 0;
+};
+
+/**
+ * Nodes of one entity: three coordinates per node and, when Parametric is
+ * set and the handler asked for them, EntityDim parametric coordinates per
+ * node.
+ */
+struct NodeBlock
+{
+  int EntityDim = 0;
+  int EntityTag = 0;
+  bool Parametric = false;
+  Span<std::size_t> Tags;
+  Span<double> Coordinates;
+  Span<double> ParametricCoordinates;
+};
+
+/**
+ * Elements of one entity, all of the same type, with NumberOfNodes node
+ * tags per element. Large blocks are delivered over several calls.
+ */
+struct ElementBlock
+{
+  int EntityDim = 0;
+  int EntityTag = 0;
+  const ElementType* Type = nullptr;
+  Span<std::size_t> Tags;
+  Span<std::size_t> NodeTags;
+};
+
+/**
+ * Periodic link of one entity to its master entity, from the $Periodic
+ * section. Affine holds the 16 values of the row-major 4x4 transform
+ * mapping the master entity onto the entity, when the file gives it, and
+ * NodeTags holds pairs of node tag and master node tag.
+ */
+struct PeriodicLink
+{
+  int EntityDim = 0;
+  int EntityTag = 0;
+  int MasterTag = 0;
+  Span<double> Affine;
+  Span<std::size_t> NodeTags;
+};
+
+/**
+ * Header line of a node block, which starts at Offset, with the range of
+ * the tags of its nodes, empty for a block without nodes.
+ */
+struct NodeBlockHeader
+{
+  int EntityDim = 0;
+  int EntityTag = 0;
+  bool Parametric = false;
+  std::size_t NumberOfNodes = 0;
+  std::size_t MinTag = 0;
+  std::size_t MaxTag = 0;
+  std::streamoff Offset = 0;
+};
+
+/**
+ * Header of an element block, without its elements, which start at
+ * Offset.
+ */
+struct ElementBlockHeader
+{
+  int EntityDim = 0;
+  int EntityTag = 0;
+  const ElementType* Type = nullptr;
+  std::size_t NumberOfElements = 0;
+  std::streamoff Offset = 0;
+};
+
+enum class DataKind
+{
+  Node,
+  Element,
+  ElementNode
+};
+
+/**
+ * Tags heading a $NodeData, $ElementData or $ElementNodeData section.
+ * String tags are unquoted.
+ */
+struct DataViewHeader
+{
+  std::vector<std::string> StringTags;
+  std::vector<double> RealTags;
+  std::vector<long long> IntegerTags;
+
+  //@{
+  /**
+   * Standard tags: the view name and interpolation scheme, then the time,
+   * then the time step, the number of components and the number of
+   * entities. Missing tags read as empty or 0.
+   */
+  std::string GetName() const;
+  std::string GetInterpolationScheme() const;
+  double GetTime() const;
+  int GetTimeStep() const;
+  int GetNumberOfComponents() const;
+  std::size_t GetNumberOfEntities() const;
+  //@}
+};
+
+/**
+ * Records of a data view: one tag per record and, for $ElementNodeData,
+ * the number of nodes of each element. Values hold NumberOfComponents
+ * values per node or element. Large views are delivered over several
+ * calls, without the records the handler does not want.
+ */
+struct DataRecords
+{
+  DataKind Kind = DataKind::Node;
+  const DataViewHeader* Header = nullptr;
+  Span<std::size_t> Tags;
+  Span<int> NumberOfNodes;
+  Span<double> Values;
+};
+
+/**
+ * Interpolation matrices of an $InterpolationScheme section for one element
+ * topology: the basis functions are phi_i(u, v, w) = sum_j F_ij u^p_j v^q_j
+ * w^r_j, with F the row-major coefficient matrix and (p, q, r) the rows of
+ * the monomial exponent matrix, stored with three columns, missing ones
+ * being 0.
+ */
+struct InterpolationMatrices
+{
+  int NumberOfBasisFunctions = 0;
+  int NumberOfMonomials = 0;
+  std::vector<double> Coefficients;
+  std::vector<double> Exponents;
+};
+
+/**
+ * Element topology (gmsh parent type) to interpolation matrices.
+ */
+using InterpolationScheme = std::map<int, InterpolationMatrices>;
+
+/**
+ * Receiver of the content of a file parsed by Parse.
+ */
+class Handler
+{
+public:
+  virtual ~Handler() = default;
+
+  virtual void OnMeshFormat(const MeshFormat&) {}
+  virtual void OnNodes(const BlockSectionHeader&) {}
+
+  /**
+   * Whether the parametric coordinates of the nodes are decoded; they are
+   * skipped without conversion otherwise.
+   */
+  virtual bool WantsParametricCoordinates() { return false; }
+  virtual void OnNodeBlock(const NodeBlock&) {}
+  virtual void OnElements(const BlockSectionHeader&) {}
+  virtual void OnElementBlock(const ElementBlock&) {}
+  virtual void OnPeriodicLink(const PeriodicLink&) {}
+
+  /**
+   * Called with each $InterpolationScheme section and its unquoted name.
+   */
+  virtual void OnInterpolationScheme(const std::string&,
+				     const InterpolationScheme&)
+  {
+  }
+
+  /**
+   * Called before the records of a data view; return false to skip them.
+   */
+  virtual bool OnDataView(DataKind, const DataViewHeader&) { return true; }
+
+  /**
+   * Whether the record of an entity tag is decoded; the values of the
+   * other records are skipped without conversion and not delivered.
+   */
+  virtual bool WantsRecord(std::size_t) { return true; }
+  virtual void OnDataRecords(const DataRecords&) {}
+
+  /**
+   * Called after each section, named without its $; return false to stop
+   * parsing there.
+   */
+  virtual bool OnEndSection(const std::string&) { return true; }
+};
+
+/**
+ * Location of a complete section. Offset is that of the opening marker and
+ * ContentOffset that of the next line, whose content is kept in FirstLine.
+ * Data sections also get their header and the offset of their records.
+ */
+struct Section
+{
+  std::string Name;
+  std::streamoff Offset = 0;
+  std::streamoff ContentOffset = 0;
+  std::string FirstLine;
+  DataViewHeader View;
+  std::streamoff RecordsOffset = 0;
+};
+
+enum class IndexStatus
+{
+  Complete,
+  Incomplete,
+  Malformed
+};
+
+/**
+ * Outcome of IndexSections. Unless the status is Complete, Offset and
+ * SectionName are those of the section that was cut short by the end of
+ * the stream or malformed; indexing can resume at Offset once a running
+ * solver completed it. Otherwise Offset is where the next section would
+ * start.
+ */
+struct IndexResult
+{
+  IndexStatus Status = IndexStatus::Complete;
+  std::streamoff Offset = 0;
+  std::string SectionName;
+};
+
+/**
+ * Get the kind of data held by a section, returning false for sections
+ * that do not hold data views.
+ */
+bool GetDataKind(const std::string& SectionName, DataKind& kind);
+
+/**
+ * Append the sections found from the current position to the end of the
+ * stream. Only the headers of the data views are decoded.
+ */
+IndexResult IndexSections(Tokenizer& tokens, std::vector<Section>& sections);
+
+//@{
+/**
+ * Read the content of a section, the tokenizer being positioned after its
+ * opening marker. The end marker is left to be read. Data records are
+ * read after the header of their view.
+ */
+bool ReadMeshFormat(Tokenizer& tokens, MeshFormat& format);
+bool ReadDataViewHeader(Tokenizer& tokens, DataViewHeader& header);
+bool ReadNodes(Tokenizer& tokens, Handler& handler, std::string& error);
+bool ReadElements(Tokenizer& tokens, Handler& handler, std::string& error);
+bool ReadPeriodic(Tokenizer& tokens, Handler& handler, std::string& error);
+bool ReadInterpolationScheme(Tokenizer& tokens, std::string& name,
+			     InterpolationScheme& scheme, std::string& error);
+bool ReadDataRecords(Tokenizer& tokens, DataKind kind,
+		     const DataViewHeader& header, Handler& handler,
+		     std::string& error);
+//@}
+
+/**
+ * Read the header of the $Nodes section and the headers of its blocks,
+ * with the range of the node tags of each, skipping the coordinate lines
+ * without decoding them, so that blocks can be read one at a time with
+ * ReadNodeBlock. The tokenizer is positioned after the opening marker.
+ */
+bool ReadNodeBlockHeaders(Tokenizer& tokens, BlockSectionHeader& header,
+			  std::vector<NodeBlockHeader>& blocks,
+			  std::string& error);
+
+//@{
+/**
+ * Read the nodes of a block indexed by ReadNodeBlockHeaders, or only those
+ * whose tags are in the sorted NodeTags, the coordinate lines of the other
+ * nodes being skipped without being decoded.
+ */
+bool ReadNodeBlock(Tokenizer& tokens, const NodeBlockHeader& header,
+		   Handler& handler, std::string& error);
+bool ReadNodeBlock(Tokenizer& tokens, const NodeBlockHeader& header,
+		   const std::vector<std::size_t>& NodeTags, Handler& handler,
+		   std::string& error);
+//@}
+
+/**
+ * Read the header of the $Elements section and the headers of its blocks,
+ * skipping the element lines without decoding them, so that the mesh can
+ * be sized before it is read. The tokenizer is positioned after the
+ * opening marker.
+ */
+bool ReadElementBlockHeaders(Tokenizer& tokens, BlockSectionHeader& header,
+			     std::vector<ElementBlockHeader>& blocks,
+			     std::string& error);
+
+/**
+ * Read count elements of a block indexed by ReadElementBlockHeaders,
+ * starting with its element of index first, so that a range of the mesh
+ * can be read without the rest of the section.
+ */
+bool ReadElementBlock(Tokenizer& tokens, const ElementBlockHeader& header,
+		      std::size_t first, std::size_t count, Handler& handler,
+		      std::string& error);
+
+/**
+ * Records of a data view that ProbeDataRecords scans rather than bisects,
+ * in bytes, and a good buffer size for tokenizers probing views.
+ */
+constexpr std::streamoff ProbeWindow = 4096;
+
+/**
+ * Read the values of the given tags, sorted and unique, from the records
+ * of a $NodeData or $ElementData view found in [begin, end) of the stream,
+ * NumberOfRecords records of NumberOfComponents values, into one tuple per
+ * tag. Views list their records by increasing tag, so each record is
+ * located by bisecting the byte range, resynchronizing on the next line,
+ * and scanning the last ProbeWindow bytes; successive tags resume from the
+ * record of the previous one. Tags not found that way, absent from a
+ * partial view or written out of order, are looked for in a sequential
+ * scan of the view. The tuples of tags that are not found are left as
+ * they are.
+ */
+bool ProbeDataRecords(Tokenizer& tokens, std::streamoff begin,
+		      std::streamoff end, std::size_t NumberOfRecords,
+		      int NumberOfComponents,
+		      const std::vector<std::size_t>& tags, double* values);
+
+/**
+ * Parse the sections found from the current position, passing their
+ * content to the handler. Returns false with a message on malformed or
+ * binary files.
+ */
+bool Parse(Tokenizer& tokens, Handler& handler, std::string& error);
+}
+
+#endif
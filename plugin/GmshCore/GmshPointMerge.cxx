@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshPointMerge.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshPointMerge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// First of the sorted entries with a key not less than key.
+std::vector<GmshCore::MergeEntry>::const_iterator FindKey(
+  const std::vector<GmshCore::MergeEntry>& entries,
+  std::vector<GmshCore::MergeEntry>::const_iterator last,
+  const GmshCore::MergeKey& key)
+{
+  return std::lower_bound(
+    entries.begin(), last, key,
+    [](const GmshCore::MergeEntry& entry, const GmshCore::MergeKey& value) {
+      return entry.Key < value;
+    });
+}
+
+//----------------------------------------------------------------------------
+template <typename ValueType>
+double Distance2(const ValueType* a, const ValueType* b)
+{
+  double distance2 = 0.0;
+  for (int c = 0; c < 3; ++c) {
+    const double d = static_cast<double>(a[c]) - static_cast<double>(b[c]);
+    distance2 += d * d;
+  }
+  return distance2;
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+MergeKey GetMergeKey(const double point[3], double tolerance)
+{
+  MergeKey key;
+  for (int c = 0; c < 3; ++c) {
+    if (tolerance > 0.0) {
+      key[c] = static_cast<long long>(std::floor(point[c] / tolerance));
+    } else {
+      const double value = point[c] + 0.0;
+      std::memcpy(&key[c], &value, sizeof(value));
+    }
+  }
+  return key;
+}
+
+//----------------------------------------------------------------------------
+void MergeEqualPoints(const std::vector<MergeEntry>& entries,
+		      std::size_t first, std::size_t last,
+		      std::vector<long long>& target)
+{
+  for (std::size_t e = first; e < last; ++e) {
+    const auto it = FindKey(entries, entries.begin() + e, entries[e].Key);
+    target[entries[e].Point] = static_cast<long long>(it->Point);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename ValueType>
+void MergeNearbyPoints(const std::vector<MergeEntry>& entries,
+		       const ValueType* coordinates, double tolerance,
+		       std::vector<long long>& target)
+{
+  // A single round over all points resolves them all.
+  std::fill(target.begin(), target.end(), -1);
+  for (const MergeEntry& entry : entries) {
+    target[entry.Point] = PendingTarget;
+  }
+  std::vector<long long> next(target.size());
+  ResolveNearbyPoints(entries, coordinates, tolerance, target, 0,
+		      target.size(), next);
+  target.swap(next);
+}
+
+//----------------------------------------------------------------------------
+template <typename ValueType>
+std::size_t ResolveNearbyPoints(const std::vector<MergeEntry>& entries,
+				const ValueType* coordinates, double tolerance,
+				const std::vector<long long>& target,
+				std::size_t first, std::size_t last,
+				std::vector<long long>& next)
+{
+  const double tolerance2 = tolerance * tolerance;
+  std::size_t pending = 0;
+  for (std::size_t p = first; p < last; ++p) {
+    next[p] = target[p];
+    if (target[p] != PendingTarget) {
+      continue;
+    }
+
+    // The points before p decide it, those of the range as resolved in
+    // this round. Those of a grid cell are sorted by id, so that the first
+    // representative or pending point within the tolerance is the smallest
+    // of its cell. A pending point smaller than the best representative
+    // may still become a smaller one, which leaves p pending.
+    const ValueType* x = coordinates + 3 * p;
+    double point[3] = { static_cast<double>(x[0]), static_cast<double>(x[1]),
+			static_cast<double>(x[2]) };
+    const MergeKey key = GetMergeKey(point, tolerance);
+    std::size_t best = p;
+    std::size_t blocked = p;
+    for (long long dx = -1; dx <= 1; ++dx) {
+      for (long long dy = -1; dy <= 1; ++dy) {
+	for (long long dz = -1; dz <= 1; ++dz) {
+	  const MergeKey neighbor = { key[0] + dx, key[1] + dy, key[2] + dz };
+	  for (auto it = FindKey(entries, entries.end(), neighbor);
+	       it != entries.end() && it->Key == neighbor &&
+		 it->Point < std::min(best, blocked);
+	       ++it) {
+	    const std::size_t q = it->Point;
+	    const long long state = q >= first ? next[q] : target[q];
+	    if ((state == static_cast<long long>(q) ||
+		 state == PendingTarget) &&
+		Distance2(x, coordinates + 3 * q) <= tolerance2) {
+	      (state == PendingTarget ? blocked : best) = q;
+	      break;
+	    }
+	  }
+	}
+      }
+    }
+    if (blocked < best) {
+      ++pending;
+    } else {
+      next[p] = static_cast<long long>(best);
+    }
+  }
+  return pending;
+}
+
+template void MergeNearbyPoints<float>(const std::vector<MergeEntry>&,
+				       const float*, double,
+				       std::vector<long long>&);
+template void MergeNearbyPoints<double>(const std::vector<MergeEntry>&,
+					const double*, double,
+					std::vector<long long>&);
+template std::size_t ResolveNearbyPoints<float>(
+  const std::vector<MergeEntry>&, const float*, double,
+  const std::vector<long long>&, std::size_t, std::size_t,
+  std::vector<long long>&);
+template std::size_t ResolveNearbyPoints<double>(
+  const std::vector<MergeEntry>&, const double*, double,
+  const std::vector<long long>&, std::size_t, std::size_t,
+  std::vector<long long>&);
+}
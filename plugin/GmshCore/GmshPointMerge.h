@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshPointMerge.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Merging of coincident points on a spatial hash.
+ *
+ * Points are keyed by the cell of a grid as large as the tolerance, or by
+ * their coordinates for a zero tolerance, and the entries sorted by key,
+ * so that the points within the tolerance of a point are found in its
+ * grid cell and the neighboring ones. Keying and sorting are independent
+ * per point, and merging is done by ranges of entries or points, all left
+ * to the caller, which may run them in parallel.
+ */
+
+#ifndef GmshPointMerge_h
+#define GmshPointMerge_h
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace GmshCore
+{
+using MergeKey = std::array<long long, 3>;
+
+/**
+ * Key of a point, ordered by key then by point.
+ */
+struct MergeEntry
+{
+  MergeKey Key;
+  std::size_t Point;
+
+  bool operator<(const MergeEntry& other) const
+  {
+    return this->Key < other.Key ||
+      (this->Key == other.Key && this->Point < other.Point);
+  }
+};
+
+/**
+ * Grid cell of a point for a positive tolerance, or the point itself for
+ * a zero tolerance, with -0 and 0 made alike.
+ */
+MergeKey GetMergeKey(const double point[3], double tolerance);
+
+/**
+ * For a zero tolerance, set the target of the points of the sorted entries
+ * first to last to the first point at the same place. Ranges of entries
+ * may be merged concurrently.
+ */
+void MergeEqualPoints(const std::vector<MergeEntry>& entries,
+		      std::size_t first, std::size_t last,
+		      std::vector<long long>& target);
+
+/**
+ * Target of a point with an entry whose merging of nearby points is not
+ * resolved yet.
+ */
+constexpr long long PendingTarget = -2;
+
+/**
+ * For a positive tolerance, set the target of each point of the sorted
+ * entries to the representative it is merged into, and that of the points
+ * without an entry to -1. Points are visited in increasing order and each
+ * becomes a representative unless a representative lies within the
+ * tolerance, in which case it is merged into the one of smallest id, so
+ * that merging is not transitive: no point moves further than the
+ * tolerance, however long a chain of close points is. The target vector
+ * is sized by the caller to the number of points, which are read from
+ * coordinates with three values each.
+ */
+template <typename ValueType>
+void MergeNearbyPoints(const std::vector<MergeEntry>& entries,
+		       const ValueType* coordinates, double tolerance,
+		       std::vector<long long>& target);
+
+/**
+ * One round of MergeNearbyPoints over the points first to last, for
+ * merging in parallel. target holds PendingTarget for the points not
+ * resolved yet and the target of the others, -1 for the points without an
+ * entry, and next receives the targets after the round. A point is
+ * resolved once the points before it within the tolerance are, those of
+ * the range in the same round. Ranges of one round may be resolved
+ * concurrently; rounds are repeated, swapping target and next, until no
+ * range returns pending points. Each round resolves at least the first
+ * range with pending points, and the points of a mesh numbered along its
+ * cells mostly depend on points of their own range, so that few rounds are
+ * needed. Returns the number of points of the range left pending.
+ */
+template <typename ValueType>
+std::size_t ResolveNearbyPoints(const std::vector<MergeEntry>& entries,
+				const ValueType* coordinates, double tolerance,
+				const std::vector<long long>& target,
+				std::size_t first, std::size_t last,
+				std::vector<long long>& next);
+}
+
+#endif
@@ -0,0 +1,293 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshQuality.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshQuality.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+using GmshCore::CellQuality;
+
+constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+//----------------------------------------------------------------------------
+void Subtract(const double a[3], const double b[3], double c[3])
+{
+  for (int i = 0; i < 3; ++i) {
+    c[i] = a[i] - b[i];
+  }
+}
+
+double Dot(const double a[3], const double b[3])
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+double Norm(const double a[3])
+{
+  return std::sqrt(Dot(a, a));
+}
+
+void Cross(const double a[3], const double b[3], double c[3])
+{
+  c[0] = a[1] * b[2] - a[2] * b[1];
+  c[1] = a[2] * b[0] - a[0] * b[2];
+  c[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+double Determinant(const double a[3], const double b[3], const double c[3])
+{
+  double cross[3];
+  Cross(b, c, cross);
+  return Dot(a, cross);
+}
+
+//----------------------------------------------------------------------------
+// Triangle: area, minimum corner Jacobian scaled by 2/sqrt(3) over the
+// largest product of two edge lengths, and Verdict aspect ratio.
+CellQuality ComputeTriangle(const double (*p)[3])
+{
+  double e[3][3];
+  double l[3];
+  for (int i = 0; i < 3; ++i) {
+    Subtract(p[(i + 1) % 3], p[i], e[i]);
+    l[i] = Norm(e[i]);
+  }
+
+  double normal[3];
+  Cross(e[0], e[1], normal);
+  const double J = Norm(normal);
+  const double product = std::max({ l[0] * l[1], l[1] * l[2], l[2] * l[0] });
+  const double hmax = std::max({ l[0], l[1], l[2] });
+
+  CellQuality q;
+  q.Size = 0.5 * J;
+  q.ScaledJacobian = product > 0.0 ? 2.0 / std::sqrt(3.0) * J / product : 0.0;
+  q.AspectRatio = J > 0.0
+    ? hmax * (l[0] + l[1] + l[2]) / (2.0 * std::sqrt(3.0) * J)
+    : Infinity;
+  return q;
+}
+
+//----------------------------------------------------------------------------
+// Quadrangle: area from the diagonals, minimum corner Jacobian normalized
+// by the edge lengths and measured along the normal, and ratio of the
+// longest to the shortest edge.
+CellQuality ComputeQuadrangle(const double (*p)[3])
+{
+  double e[4][3];
+  double l[4];
+  for (int i = 0; i < 4; ++i) {
+    Subtract(p[(i + 1) % 4], p[i], e[i]);
+    l[i] = Norm(e[i]);
+  }
+
+  double d0[3], d1[3], normal[3];
+  Subtract(p[2], p[0], d0);
+  Subtract(p[3], p[1], d1);
+  Cross(d0, d1, normal);
+  const double area = 0.5 * Norm(normal);
+
+  double ScaledJacobian = area > 0.0 ? 1.0 : 0.0;
+  for (int i = 0; i < 4 && area > 0.0; ++i) {
+    const int j = (i + 1) % 4;
+    double corner[3];
+    Cross(e[i], e[j], corner);
+    const double product = l[i] * l[j];
+    ScaledJacobian = std::min(ScaledJacobian, product > 0.0
+      ? Dot(corner, normal) / (2.0 * area * product) : 0.0);
+  }
+  const double lmin = std::min({ l[0], l[1], l[2], l[3] });
+
+  CellQuality q;
+  q.Size = area;
+  q.ScaledJacobian = ScaledJacobian;
+  q.AspectRatio =
+    lmin > 0.0 ? std::max({ l[0], l[1], l[2], l[3] }) / lmin : Infinity;
+  return q;
+}
+
+//----------------------------------------------------------------------------
+// Tetrahedron: signed volume, Verdict scaled Jacobian and Verdict aspect
+// ratio (longest edge over the inradius, normalized).
+CellQuality ComputeTetrahedron(const double (*p)[3])
+{
+  double L[6][3];
+  Subtract(p[1], p[0], L[0]);
+  Subtract(p[2], p[1], L[1]);
+  Subtract(p[0], p[2], L[2]);
+  Subtract(p[3], p[0], L[3]);
+  Subtract(p[3], p[1], L[4]);
+  Subtract(p[3], p[2], L[5]);
+  double l[6];
+  for (int i = 0; i < 6; ++i) {
+    l[i] = Norm(L[i]);
+  }
+
+  double cross[3];
+  Cross(L[2], L[0], cross);
+  const double J = Dot(L[3], cross);
+  const double product = std::max({ l[0] * l[2] * l[3], l[0] * l[1] * l[4],
+				    l[1] * l[2] * l[5], l[3] * l[4] * l[5] });
+
+  double FaceAreas = Norm(cross);
+  const int faces[3][2] = { { 0, 3 }, { 1, 4 }, { 2, 3 } };
+  for (const auto& face : faces) {
+    Cross(L[face[0]], L[face[1]], cross);
+    FaceAreas += Norm(cross);
+  }
+  FaceAreas *= 0.5;
+
+  CellQuality q;
+  q.Size = J / 6.0;
+  q.ScaledJacobian = product > 0.0 ? std::sqrt(2.0) * J / product : 0.0;
+  q.AspectRatio = J > 0.0
+    ? std::max({ l[0], l[1], l[2], l[3], l[4], l[5] }) * FaceAreas /
+      (std::sqrt(6.0) * J)
+    : Infinity;
+  return q;
+}
+
+//----------------------------------------------------------------------------
+// Hexahedron: volume of the six tetrahedra around the 0-6 diagonal,
+// minimum over the corners of the Jacobian of the normalized edges, and
+// ratio of the longest to the shortest edge.
+CellQuality ComputeHexahedron(const double (*p)[3])
+{
+  // Tetrahedra (0, a, b, 6) for consecutive a, b around the diagonal.
+  const int ring[7] = { 1, 2, 3, 7, 4, 5, 1 };
+  double diagonal[3];
+  Subtract(p[6], p[0], diagonal);
+  double volume = 0.0;
+  for (int i = 0; i < 6; ++i) {
+    double a[3], b[3];
+    Subtract(p[ring[i]], p[0], a);
+    Subtract(p[ring[i + 1]], p[0], b);
+    volume += Determinant(a, b, diagonal);
+  }
+
+  // Neighbors of each corner, forming a right-handed frame.
+  const int corners[8][4] = { { 0, 1, 3, 4 }, { 1, 2, 0, 5 },
+			      { 2, 3, 1, 6 }, { 3, 0, 2, 7 },
+			      { 4, 7, 5, 0 }, { 5, 4, 6, 1 },
+			      { 6, 5, 7, 2 }, { 7, 6, 4, 3 } };
+  double ScaledJacobian = 1.0;
+  for (const auto& corner : corners) {
+    double e[3][3];
+    double product = 1.0;
+    for (int k = 0; k < 3; ++k) {
+      Subtract(p[corner[k + 1]], p[corner[0]], e[k]);
+      product *= Norm(e[k]);
+    }
+    ScaledJacobian = std::min(ScaledJacobian, product > 0.0
+      ? Determinant(e[0], e[1], e[2]) / product : 0.0);
+  }
+
+  const int edges[12][2] = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },
+			     { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },
+			     { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+  double lmin = std::numeric_limits<double>::max();
+  double lmax = 0.0;
+  for (const auto& edge : edges) {
+    double e[3];
+    Subtract(p[edge[1]], p[edge[0]], e);
+    const double l = Norm(e);
+    lmin = std::min(lmin, l);
+    lmax = std::max(lmax, l);
+  }
+
+  CellQuality q;
+  q.Size = volume / 6.0;
+  q.ScaledJacobian = ScaledJacobian;
+  q.AspectRatio = lmin > 0.0 ? lmax / lmin : Infinity;
+  return q;
+}
+}
+
+namespace GmshCore
+{
+const char* const QualityMetricNames[3] = { "Size", "ScaledJacobian",
+					    "AspectRatio" };
+
+//----------------------------------------------------------------------------
+const QualityKernel* GetQualityKernel(int topology)
+{
+  static const QualityKernel Triangle = { 3, &ComputeTriangle };
+  static const QualityKernel Quadrangle = { 4, &ComputeQuadrangle };
+  static const QualityKernel Tetrahedron = { 4, &ComputeTetrahedron };
+  static const QualityKernel Hexahedron = { 8, &ComputeHexahedron };
+
+  switch (topology) {
+  case 3:
+    return &Triangle;
+  case 4:
+    return &Quadrangle;
+  case 5:
+    return &Tetrahedron;
+  case 8:
+    return &Hexahedron;
+  default:
+    return nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------
+QualityStatistics::QualityStatistics()
+{
+  this->Min.fill(Infinity);
+  this->Max.fill(-Infinity);
+}
+
+//----------------------------------------------------------------------------
+void QualityStatistics::Add(const CellQuality& q)
+{
+  const double values[3] = { q.Size, q.ScaledJacobian, q.AspectRatio };
+  for (int i = 0; i < 3; ++i) {
+    this->Min[i] = std::min(this->Min[i], values[i]);
+    this->Max[i] = std::max(this->Max[i], values[i]);
+    this->Sum[i] += values[i];
+    this->SumOfSquares[i] += values[i] * values[i];
+  }
+  ++this->NumberOfCells;
+}
+
+//----------------------------------------------------------------------------
+void QualityStatistics::Merge(const QualityStatistics& other)
+{
+  for (int i = 0; i < 3; ++i) {
+    this->Min[i] = std::min(this->Min[i], other.Min[i]);
+    this->Max[i] = std::max(this->Max[i], other.Max[i]);
+    this->Sum[i] += other.Sum[i];
+    this->SumOfSquares[i] += other.SumOfSquares[i];
+  }
+  this->NumberOfCells += other.NumberOfCells;
+}
+
+//----------------------------------------------------------------------------
+double QualityStatistics::GetMean(int metric) const
+{
+  return this->Sum[metric] / static_cast<double>(this->NumberOfCells);
+}
+
+//----------------------------------------------------------------------------
+double QualityStatistics::GetStandardDeviation(int metric) const
+{
+  const double n = static_cast<double>(this->NumberOfCells);
+  const double mean = this->Sum[metric] / n;
+  return std::sqrt(std::max(0.0, this->SumOfSquares[metric] / n - mean * mean));
+}
+}
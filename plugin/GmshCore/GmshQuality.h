@@ -0,0 +1,83 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshQuality.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Quality metrics of linear cells.
+ *
+ * Kernels compute the quality of triangles, quadrangles, tetrahedra and
+ * hexahedra from the coordinates of their corners, in gmsh corner order;
+ * high-order elements are measured by their corners. Statistics are
+ * accumulated per thread and merged.
+ */
+
+#ifndef GmshQuality_h
+#define GmshQuality_h
+
+#include <array>
+#include <cstdint>
+
+namespace GmshCore
+{
+/**
+ * Quality of one cell. Size is the length, area or volume, ScaledJacobian
+ * is 1 for ideal shapes and 0 or less for degenerate or inverted ones, and
+ * AspectRatio is 1 for ideal shapes.
+ */
+struct CellQuality
+{
+  double Size;
+  double ScaledJacobian;
+  double AspectRatio;
+};
+
+// Names of the CellQuality members, as the arrays holding them are named.
+extern const char* const QualityMetricNames[3];
+
+struct QualityKernel
+{
+  int NumberOfCorners;
+  CellQuality (*Compute)(const double (*corners)[3]);
+};
+
+/**
+ * Kernel of a gmsh element topology (3 triangle, 4 quadrangle,
+ * 5 tetrahedron, 8 hexahedron), or nullptr for other topologies.
+ */
+const QualityKernel* GetQualityKernel(int topology);
+
+/**
+ * Running minimum, maximum, sum and sum of squares of each quality metric.
+ */
+struct QualityStatistics
+{
+  std::array<double, 3> Min;
+  std::array<double, 3> Max;
+  std::array<double, 3> Sum{};
+  std::array<double, 3> SumOfSquares{};
+  std::int64_t NumberOfCells = 0;
+
+  QualityStatistics();
+
+  void Add(const CellQuality& q);
+  void Merge(const QualityStatistics& other);
+
+  /**
+   * Mean and standard deviation of a metric over the cells added.
+   */
+  double GetMean(int metric) const;
+  double GetStandardDeviation(int metric) const;
+};
+}
+
+#endif
@@ -0,0 +1,500 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshReferenceElements.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshReferenceElements.h"
+
+#include "GmshElementTypes.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+// Nodes of an element of order p as integer coordinates on the lattice of
+// step 1 / p (2 / p for the axes spanning [-1, 1]), which keeps the
+// recursive construction exact.
+using Lattice = std::vector<std::array<int, 3>>;
+
+// Edges and faces of the corners, in gmsh order. Quadrangular faces list
+// their corners around the face, triangular ones end with -1.
+const int TriangleEdges[][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+const int QuadrangleEdges[][2] = { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 } };
+const int TetrahedronEdges[][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 },
+				    { 3, 0 }, { 3, 2 }, { 3, 1 } };
+const int TetrahedronFaces[][4] = { { 0, 2, 1, -1 }, { 0, 1, 3, -1 },
+				    { 0, 3, 2, -1 }, { 3, 1, 2, -1 } };
+const int HexahedronEdges[][2] = { { 0, 1 }, { 0, 3 }, { 0, 4 }, { 1, 2 },
+				   { 1, 5 }, { 2, 3 }, { 2, 6 }, { 3, 7 },
+				   { 4, 5 }, { 4, 7 }, { 5, 6 }, { 6, 7 } };
+const int HexahedronFaces[][4] = { { 0, 3, 2, 1 }, { 0, 1, 5, 4 },
+				   { 0, 4, 7, 3 }, { 1, 2, 6, 5 },
+				   { 2, 3, 7, 6 }, { 4, 5, 6, 7 } };
+const int PrismEdges[][2] = { { 0, 1 }, { 0, 2 }, { 0, 3 },
+			      { 1, 2 }, { 1, 4 }, { 2, 5 },
+			      { 3, 4 }, { 3, 5 }, { 4, 5 } };
+const int PrismFaces[][4] = { { 0, 2, 1, -1 }, { 3, 4, 5, -1 },
+			      { 0, 1, 4, 3 }, { 0, 3, 5, 2 }, { 1, 2, 5, 4 } };
+const int PyramidEdges[][2] = { { 0, 1 }, { 0, 3 }, { 0, 4 }, { 1, 2 },
+				{ 1, 4 }, { 2, 3 }, { 2, 4 }, { 3, 4 } };
+
+//----------------------------------------------------------------------------
+// Append the nodes inside each edge, from its first corner to its second.
+template <std::size_t N>
+void AddEdgeNodes(Lattice& nodes, const int (&edges)[N][2], int order)
+{
+  for (const auto& edge : edges) {
+    const auto first = nodes[edge[0]];
+    const auto last = nodes[edge[1]];
+    for (int i = 1; i < order; ++i) {
+      std::array<int, 3> node;
+      for (int c = 0; c < 3; ++c) {
+	node[c] = first[c] + (last[c] - first[c]) / order * i;
+      }
+      nodes.push_back(node);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Append the nodes of a face, given as a two-dimensional lattice in the
+// frame of its first corner and the two corners next to it.
+void AddFaceNodes(Lattice& nodes, const int* face, const Lattice& inner,
+		  int order)
+{
+  const auto origin = nodes[face[0]];
+  const auto u = nodes[face[1]];
+  const auto v = nodes[face[3] >= 0 ? face[3] : face[2]];
+  for (const auto& point : inner) {
+    std::array<int, 3> node;
+    for (int c = 0; c < 3; ++c) {
+      node[c] = origin[c] + (u[c] - origin[c]) / order * point[0] +
+	(v[c] - origin[c]) / order * point[1];
+    }
+    nodes.push_back(node);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Append a lower order lattice moved by one step along each axis, as the
+// interior nodes of an element.
+void AddInnerNodes(Lattice& nodes, const Lattice& inner, int dimension)
+{
+  for (auto node : inner) {
+    for (int c = 0; c < dimension; ++c) {
+      ++node[c];
+    }
+    nodes.push_back(node);
+  }
+}
+
+//----------------------------------------------------------------------------
+Lattice GetLineLattice(int order)
+{
+  Lattice nodes = { { 0, 0, 0 } };
+  if (order > 0) {
+    nodes.push_back({ order, 0, 0 });
+  }
+  for (int i = 1; i < order; ++i) {
+    nodes.push_back({ i, 0, 0 });
+  }
+  return nodes;
+}
+
+//----------------------------------------------------------------------------
+Lattice GetTriangleLattice(int order, bool complete)
+{
+  if (order == 0) {
+    return { { 0, 0, 0 } };
+  }
+  Lattice nodes = { { 0, 0, 0 }, { order, 0, 0 }, { 0, order, 0 } };
+  AddEdgeNodes(nodes, TriangleEdges, order);
+  if (complete && order > 2) {
+    AddInnerNodes(nodes, GetTriangleLattice(order - 3, true), 2);
+  }
+  return nodes;
+}
+
+//----------------------------------------------------------------------------
+Lattice GetQuadrangleLattice(int order, bool complete)
+{
+  if (order == 0) {
+    return { { 0, 0, 0 } };
+  }
+  Lattice nodes = { { 0, 0, 0 }, { order, 0, 0 }, { order, order, 0 },
+		    { 0, order, 0 } };
+  AddEdgeNodes(nodes, QuadrangleEdges, order);
+  if (complete && order > 1) {
+    AddInnerNodes(nodes, GetQuadrangleLattice(order - 2, true), 2);
+  }
+  return nodes;
+}
+
+//----------------------------------------------------------------------------
+Lattice GetTetrahedronLattice(int order)
+{
+  if (order == 0) {
+    return { { 0, 0, 0 } };
+  }
+  Lattice nodes = { { 0, 0, 0 }, { order, 0, 0 }, { 0, order, 0 },
+		    { 0, 0, order } };
+  AddEdgeNodes(nodes, TetrahedronEdges, order);
+  if (order > 2) {
+    Lattice inner;
+    AddInnerNodes(inner, GetTriangleLattice(order - 3, true), 2);
+    for (const auto& face : TetrahedronFaces) {
+      AddFaceNodes(nodes, face, inner, order);
+    }
+  }
+  if (order > 3) {
+    AddInnerNodes(nodes, GetTetrahedronLattice(order - 4), 3);
+  }
+  return nodes;
+}
+
+//----------------------------------------------------------------------------
+Lattice GetHexahedronLattice(int order, bool complete)
+{
+  if (order == 0) {
+    return { { 0, 0, 0 } };
+  }
+  Lattice nodes = { { 0, 0, 0 }, { order, 0, 0 }, { order, order, 0 },
+		    { 0, order, 0 }, { 0, 0, order }, { order, 0, order },
+		    { order, order, order }, { 0, order, order } };
+  AddEdgeNodes(nodes, HexahedronEdges, order);
+  if (complete && order > 1) {
+    Lattice inner;
+    AddInnerNodes(inner, GetQuadrangleLattice(order - 2, true), 2);
+    for (const auto& face : HexahedronFaces) {
+      AddFaceNodes(nodes, face, inner, order);
+    }
+    AddInnerNodes(nodes, GetHexahedronLattice(order - 2, true), 3);
+  }
+  return nodes;
+}
+
+//----------------------------------------------------------------------------
+Lattice GetPrismLattice(int order, bool complete)
+{
+  if (order == 0) {
+    return { { 0, 0, 0 } };
+  }
+  Lattice nodes = { { 0, 0, 0 }, { order, 0, 0 }, { 0, order, 0 },
+		    { 0, 0, order }, { order, 0, order }, { 0, order, order } };
+  AddEdgeNodes(nodes, PrismEdges, order);
+  if (complete && order > 1) {
+    Lattice quadrangle, triangle;
+    AddInnerNodes(quadrangle, GetQuadrangleLattice(order - 2, true), 2);
+    if (order > 2) {
+      AddInnerNodes(triangle, GetTriangleLattice(order - 3, true), 2);
+    }
+    for (const auto& face : PrismFaces) {
+      AddFaceNodes(nodes, face, face[3] >= 0 ? quadrangle : triangle,
+		   order);
+    }
+    if (order > 2) {
+      for (const auto& base : GetTriangleLattice(order - 3, true)) {
+	for (const auto& height : GetLineLattice(order - 2)) {
+	  nodes.push_back({ base[0] + 1, base[1] + 1, height[0] + 1 });
+	}
+      }
+    }
+  }
+  return nodes;
+}
+
+//----------------------------------------------------------------------------
+// Second order pyramids, whose nodes are the corners, the edge midpoints
+// and, for complete ones, the center of the base.
+void GetPyramidNodes(int order, bool complete, std::vector<double>& uvw)
+{
+  uvw = { -1, -1, 0,  1, -1, 0,  1, 1, 0,  -1, 1, 0,  0, 0, 1 };
+  if (order < 2) {
+    return;
+  }
+  for (const auto& edge : PyramidEdges) {
+    for (int c = 0; c < 3; ++c) {
+      uvw.push_back(0.5 * (uvw[3 * edge[0] + c] + uvw[3 * edge[1] + c]));
+    }
+  }
+  if (complete) {
+    uvw.insert(uvw.end(), { 0, 0, 0 });
+  }
+}
+
+//----------------------------------------------------------------------------
+// Exponents of the monomials spanning the gmsh interpolation space of an
+// element: complete polynomials of the order on simplices, tensor products
+// on quadrangles and hexahedra, and products of both on prisms. Second
+// order serendipity quadrangles, hexahedra and prisms drop the monomials
+// of degree 4 and more, and incomplete triangles use the lattice of their
+// nodes, as gmsh does.
+Lattice GetMonomials(int topology, int order, bool complete)
+{
+  Lattice monomials;
+  if (topology == 3 && !complete) {
+    return GetTriangleLattice(order, false);
+  }
+
+  const int p = order;
+  for (int k = 0; k <= p; ++k) {
+    for (int j = 0; j <= p; ++j) {
+      for (int i = 0; i <= p; ++i) {
+	bool kept = false;
+	switch (topology) {
+	case 1:
+	  kept = i == 0 && j == 0 && k == 0;
+	  break;
+	case 2:
+	  kept = j == 0 && k == 0;
+	  break;
+	case 3:
+	  kept = k == 0 && i + j <= p;
+	  break;
+	case 4:
+	  kept = k == 0 && (complete || i < 2 || j < 2);
+	  break;
+	case 5:
+	  kept = i + j + k <= p;
+	  break;
+	case 7:
+	  kept = i + j <= p && (complete || k < 2 || i + j < 2);
+	  break;
+	case 8:
+	  kept = complete || (i == 2) + (j == 2) + (k == 2) < 2;
+	  break;
+	}
+	if (kept) {
+	  monomials.push_back({ i, j, k });
+	}
+      }
+    }
+  }
+  return monomials;
+}
+
+//----------------------------------------------------------------------------
+// Invert a square row-major matrix in place by Gauss-Jordan elimination
+// with partial pivoting, returning false when it is singular.
+bool Invert(std::vector<double>& matrix, int n)
+{
+  std::vector<double> inverse(matrix.size(), 0.0);
+  for (int i = 0; i < n; ++i) {
+    inverse[i * n + i] = 1.0;
+  }
+
+  for (int c = 0; c < n; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < n; ++r) {
+      if (std::abs(matrix[r * n + c]) > std::abs(matrix[pivot * n + c])) {
+	pivot = r;
+      }
+    }
+    if (std::abs(matrix[pivot * n + c]) < 1e-12) {
+      return false;
+    }
+    if (pivot != c) {
+      for (int k = 0; k < n; ++k) {
+	std::swap(matrix[pivot * n + k], matrix[c * n + k]);
+	std::swap(inverse[pivot * n + k], inverse[c * n + k]);
+      }
+    }
+
+    const double scale = 1.0 / matrix[c * n + c];
+    for (int k = 0; k < n; ++k) {
+      matrix[c * n + k] *= scale;
+      inverse[c * n + k] *= scale;
+    }
+    for (int r = 0; r < n; ++r) {
+      const double factor = matrix[r * n + c];
+      if (r == c || factor == 0.0) {
+	continue;
+      }
+      for (int k = 0; k < n; ++k) {
+	matrix[r * n + k] -= factor * matrix[c * n + k];
+	inverse[r * n + k] -= factor * inverse[c * n + k];
+      }
+    }
+  }
+
+  matrix = std::move(inverse);
+  return true;
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+bool GetReferenceNodes(int type, std::vector<double>& uvw)
+{
+  const ElementType* element = GetElementType(type);
+  if (!element) {
+    return false;
+  }
+
+  // Incomplete elements have fewer nodes than the complete ones of their
+  // order, which are counted here.
+  const int p = element->Order;
+  int NumberOfCompleteNodes = 1;
+  switch (element->Topology) {
+  case 2:
+    NumberOfCompleteNodes = p + 1;
+    break;
+  case 3:
+    NumberOfCompleteNodes = (p + 1) * (p + 2) / 2;
+    break;
+  case 4:
+    NumberOfCompleteNodes = (p + 1) * (p + 1);
+    break;
+  case 5:
+    NumberOfCompleteNodes = (p + 1) * (p + 2) * (p + 3) / 6;
+    break;
+  case 6:
+    NumberOfCompleteNodes = p < 2 ? 5 : 14;
+    break;
+  case 7:
+    NumberOfCompleteNodes = (p + 1) * (p + 1) * (p + 2) / 2;
+    break;
+  case 8:
+    NumberOfCompleteNodes = (p + 1) * (p + 1) * (p + 1);
+    break;
+  }
+  const bool complete = element->NumberOfNodes == NumberOfCompleteNodes;
+
+  // Lattice axes spanning [-1, 1] rather than [0, 1].
+  Lattice nodes;
+  bool centered[3] = { false, false, false };
+  switch (element->Topology) {
+  case 1:
+    nodes = { { 0, 0, 0 } };
+    break;
+  case 2:
+    nodes = GetLineLattice(p);
+    centered[0] = true;
+    break;
+  case 3:
+    nodes = GetTriangleLattice(p, complete);
+    break;
+  case 4:
+    nodes = GetQuadrangleLattice(p, complete);
+    centered[0] = centered[1] = true;
+    break;
+  case 5:
+    nodes = GetTetrahedronLattice(p);
+    break;
+  case 6:
+    if (p > 2) {
+      return false;
+    }
+    GetPyramidNodes(p, complete, uvw);
+    return static_cast<int>(uvw.size()) == 3 * element->NumberOfNodes;
+  case 7:
+    nodes = GetPrismLattice(p, complete);
+    centered[2] = true;
+    break;
+  case 8:
+    nodes = GetHexahedronLattice(p, complete);
+    centered[0] = centered[1] = centered[2] = true;
+    break;
+  default:
+    return false;
+  }
+
+  if (static_cast<int>(nodes.size()) != element->NumberOfNodes) {
+    return false;
+  }
+
+  uvw.resize(3 * nodes.size());
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    for (int c = 0; c < 3; ++c) {
+      const double t = p > 0 ? static_cast<double>(nodes[i][c]) / p : 0.0;
+      uvw[3 * i + c] = centered[c] ? 2.0 * t - 1.0 : t;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool LagrangeBasis::Initialize(int type)
+{
+  const ElementType* element = GetElementType(type);
+  if (!element || element->Topology == 6 ||
+      !GetReferenceNodes(type, this->Nodes)) {
+    return false;
+  }
+
+  const int n = element->NumberOfNodes;
+  const int NumberOfCompleteMonomials = static_cast<int>(
+    GetMonomials(element->Topology, element->Order, true).size());
+  Lattice monomials = GetMonomials(element->Topology, element->Order,
+				   n == NumberOfCompleteMonomials);
+  if (static_cast<int>(monomials.size()) != n) {
+    return false;
+  }
+
+  // Vandermonde matrix: monomial m at node i in row i, column m.
+  std::vector<double> matrix(n * n);
+  for (int i = 0; i < n; ++i) {
+    for (int m = 0; m < n; ++m) {
+      double value = 1.0;
+      for (int c = 0; c < 3; ++c) {
+	value *= std::pow(this->Nodes[3 * i + c], monomials[m][c]);
+      }
+      matrix[i * n + m] = value;
+    }
+  }
+  if (!Invert(matrix, n)) {
+    return false;
+  }
+
+  this->NumberOfNodes = n;
+  this->Exponents = std::move(monomials);
+  this->Coefficients = std::move(matrix);
+  this->MaximumExponent = 0;
+  for (const auto& exponents : this->Exponents) {
+    for (const int e : exponents) {
+      this->MaximumExponent = std::max(this->MaximumExponent, e);
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void LagrangeBasis::Evaluate(const double uvw[3], double* values) const
+{
+  // Powers of each coordinate, then one row of the inverse Vandermonde
+  // matrix per monomial, accumulated into the basis functions.
+  constexpr int MaximumPowers = 16;
+  double powers[3][MaximumPowers];
+  const int last = std::min(this->MaximumExponent, MaximumPowers - 1);
+  for (int c = 0; c < 3; ++c) {
+    powers[c][0] = 1.0;
+    for (int e = 1; e <= last; ++e) {
+      powers[c][e] = powers[c][e - 1] * uvw[c];
+    }
+  }
+
+  const int n = this->NumberOfNodes;
+  std::fill_n(values, n, 0.0);
+  for (int m = 0; m < n; ++m) {
+    const auto& e = this->Exponents[m];
+    const double monomial = powers[0][e[0]] * powers[1][e[1]] * powers[2][e[2]];
+    const double* row = this->Coefficients.data() + m * n;
+    for (int i = 0; i < n; ++i) {
+      values[i] += monomial * row[i];
+    }
+  }
+}
+}
@@ -0,0 +1,85 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshReferenceElements.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Reference elements of the Gmsh element types.
+ *
+ * Reference coordinates follow the $InterpolationScheme section: lines,
+ * quadrangles and hexahedra span [-1, 1] along each axis, triangles and
+ * tetrahedra are the unit simplices, prisms are the unit triangle times
+ * [-1, 1] along w, and pyramids have their base on [-1, 1]^2 at w = 0 and
+ * their apex at (0, 0, 1).
+ */
+
+#ifndef GmshReferenceElements_h
+#define GmshReferenceElements_h
+
+#include <array>
+#include <vector>
+
+namespace GmshCore
+{
+/**
+ * Get the reference (u, v, w) coordinates of the nodes of an element type,
+ * three per node in gmsh node order: the corners, then the nodes inside
+ * each edge, then those inside each face, then the interior nodes, each
+ * group being numbered like a lower order element of its own. Returns
+ * false for unknown types. Pyramids are covered up to the second order,
+ * which includes every pyramid type of the table, and other topologies at
+ * any order, incomplete (serendipity) elements included.
+ */
+bool GetReferenceNodes(int type, std::vector<double>& uvw);
+
+/**
+ * Lagrange basis of an element type: one polynomial per node, equal to 1
+ * at its node and to 0 at the others, which interpolates a field given at
+ * the nodes of an element and maps the reference element onto the element
+ * from the coordinates of its nodes. The polynomials span the monomials of
+ * the gmsh space of the type, serendipity spaces included, and are found
+ * by inverting their Vandermonde matrix at the reference nodes.
+ */
+class LagrangeBasis
+{
+public:
+  /**
+   * Build the basis of a type, returning false for unknown types and for
+   * pyramids, whose gmsh basis is rational.
+   */
+  bool Initialize(int type);
+
+  int GetNumberOfNodes() const { return this->NumberOfNodes; }
+
+  /**
+   * Reference coordinates of the nodes, as given by GetReferenceNodes.
+   */
+  const std::vector<double>& GetNodes() const { return this->Nodes; }
+
+  /**
+   * Evaluate the basis functions at a reference point, writing one value
+   * per node.
+   */
+  void Evaluate(const double uvw[3], double* values) const;
+
+private:
+  int NumberOfNodes = 0;
+  int MaximumExponent = 0;
+  std::vector<double> Nodes;
+  std::vector<std::array<int, 3>> Exponents;
+
+  // Row m holds the coefficient of monomial m in each basis function.
+  std::vector<double> Coefficients;
+};
+}
+
+#endif
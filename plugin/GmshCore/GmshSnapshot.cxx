@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshSnapshot.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshSnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+constexpr char SnapshotMagic[8] = { 'G', 'M', 'S', 'H', 'S', 'N', 'P', '2' };
+
+struct SnapshotHeader
+{
+  char Magic[8];
+  std::uint64_t NumberOfSections;
+  std::uint64_t SourceSize;
+  std::int64_t SourceModificationTime;
+  std::uint64_t Checksum;
+};
+
+//----------------------------------------------------------------------------
+// FNV-1a hash of bytes, continued from hash.
+std::uint64_t Hash(const void* data, std::size_t size, std::uint64_t hash)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+//----------------------------------------------------------------------------
+// Checksum of a header, without its magic and checksum, and of the section
+// table that follows it.
+std::uint64_t GetChecksum(SnapshotHeader header, const char* table)
+{
+  std::memset(header.Magic, 0, sizeof(header.Magic));
+  header.Checksum = 0;
+  const std::size_t TableSize =
+    header.NumberOfSections * sizeof(GmshCore::SnapshotSection);
+  return Hash(table, TableSize,
+	      Hash(&header, sizeof(header), 0xcbf29ce484222325ULL));
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+SnapshotWriter::SnapshotWriter(std::size_t PageSize)
+  : PageSize(std::max<std::size_t>(PageSize, 1))
+{
+}
+
+//----------------------------------------------------------------------------
+void SnapshotWriter::AddSection(const char* name, const void* data,
+				std::uint64_t NumberOfValues,
+				std::uint32_t ValueSize,
+				std::uint32_t NumberOfComponents)
+{
+  SnapshotSection section{};
+  std::strncpy(section.Name, name, sizeof(section.Name) - 1);
+  section.NumberOfValues = NumberOfValues;
+  section.ValueSize = ValueSize;
+  section.NumberOfComponents = NumberOfComponents;
+  this->Sections.emplace_back(section, data);
+
+  // The table grows with each section, so every offset is placed again.
+  std::uint64_t offset = sizeof(SnapshotHeader) +
+    this->Sections.size() * sizeof(SnapshotSection);
+  for (auto& placed : this->Sections) {
+    offset = (offset + this->PageSize - 1) / this->PageSize * this->PageSize;
+    placed.first.Offset = offset;
+    offset += std::max<std::uint64_t>(
+      placed.first.NumberOfValues * placed.first.ValueSize, 1);
+  }
+}
+
+//----------------------------------------------------------------------------
+std::size_t SnapshotWriter::GetSize() const
+{
+  if (this->Sections.empty()) {
+    return sizeof(SnapshotHeader);
+  }
+  const SnapshotSection& last = this->Sections.back().first;
+  return static_cast<std::size_t>(last.Offset +
+    std::max<std::uint64_t>(last.NumberOfValues * last.ValueSize, 1));
+}
+
+//----------------------------------------------------------------------------
+void SnapshotWriter::Write(char* base, const SnapshotStamp& stamp) const
+{
+  SnapshotHeader header{};
+  header.NumberOfSections = this->Sections.size();
+  header.SourceSize = stamp.Size;
+  header.SourceModificationTime = stamp.ModificationTime;
+
+  char* table = base + sizeof(SnapshotHeader);
+  for (std::size_t i = 0; i < this->Sections.size(); ++i) {
+    const SnapshotSection& section = this->Sections[i].first;
+    std::memcpy(table + i * sizeof(SnapshotSection), &section,
+		sizeof(SnapshotSection));
+    if (this->Sections[i].second) {
+      std::memcpy(base + section.Offset, this->Sections[i].second,
+		  section.NumberOfValues * section.ValueSize);
+    }
+  }
+
+  header.Checksum = GetChecksum(header, table);
+  std::memcpy(base, &header, sizeof(header));
+}
+
+//----------------------------------------------------------------------------
+void SnapshotWriter::Publish(char* base)
+{
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(base, SnapshotMagic, sizeof(SnapshotMagic));
+}
+
+//----------------------------------------------------------------------------
+bool ReadSnapshot(const char* base, std::size_t size,
+		  const SnapshotStamp& stamp,
+		  std::vector<SnapshotSection>& sections)
+{
+  if (size < sizeof(SnapshotHeader)) {
+    return false;
+  }
+
+  SnapshotHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (std::memcmp(header.Magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 ||
+      header.SourceSize != stamp.Size ||
+      header.SourceModificationTime != stamp.ModificationTime ||
+      header.NumberOfSections >
+      (size - sizeof(SnapshotHeader)) / sizeof(SnapshotSection)) {
+    return false;
+  }
+
+  const char* table = base + sizeof(SnapshotHeader);
+  if (GetChecksum(header, table) != header.Checksum) {
+    return false;
+  }
+
+  sections.resize(header.NumberOfSections);
+  for (std::uint64_t i = 0; i < header.NumberOfSections; ++i) {
+    SnapshotSection& section = sections[i];
+    std::memcpy(&section, table + i * sizeof(SnapshotSection),
+		sizeof(section));
+    section.Name[sizeof(section.Name) - 1] = '\0';
+    if (section.Offset > size || section.ValueSize == 0 ||
+	section.NumberOfValues > (size - section.Offset) / section.ValueSize) {
+      return false;
+    }
+  }
+  return true;
+}
+}
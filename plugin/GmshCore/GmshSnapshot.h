@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshSnapshot.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Layout of the mesh snapshots shared between processes.
+ *
+ * A snapshot is a header, a table of sections, then the raw values of each
+ * section at a page-aligned offset, so that the sections of a mapped
+ * snapshot can be used in place. The header records the size and
+ * modification time of the file the snapshot was made from and a checksum
+ * of the header and section table. The writer leaves the magic string out
+ * of Write, to be written by Publish once the rest is flushed, so that a
+ * snapshot being written is never read.
+ */
+
+#ifndef GmshSnapshot_h
+#define GmshSnapshot_h
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GmshCore
+{
+// Size and modification time of the file a snapshot was made from.
+struct SnapshotStamp
+{
+  std::uint64_t Size = 0;
+  std::int64_t ModificationTime = 0;
+};
+
+struct SnapshotSection
+{
+  char Name[32];
+  std::uint64_t Offset;
+  std::uint64_t NumberOfValues;
+  std::uint32_t ValueSize;
+  std::uint32_t NumberOfComponents;
+};
+
+class SnapshotWriter
+{
+public:
+  explicit SnapshotWriter(std::size_t PageSize);
+
+  /**
+   * Add a section holding the values at data, which must stay valid until
+   * Write. Every section gets at least one page, so that no two sections
+   * share an address.
+   */
+  void AddSection(const char* name, const void* data,
+		  std::uint64_t NumberOfValues, std::uint32_t ValueSize,
+		  std::uint32_t NumberOfComponents = 1);
+
+  /**
+   * Size in bytes of the snapshot of the sections added so far.
+   */
+  std::size_t GetSize() const;
+
+  /**
+   * Write the snapshot, but for its magic string, to GetSize writable
+   * bytes.
+   */
+  void Write(char* base, const SnapshotStamp& stamp) const;
+
+  /**
+   * Write the magic string of a written snapshot, making it readable.
+   */
+  static void Publish(char* base);
+
+private:
+  std::size_t PageSize;
+  std::vector<std::pair<SnapshotSection, const void*>> Sections;
+};
+
+/**
+ * Read the section table of the snapshot at base, of the given size.
+ * Fails if the snapshot is not published, was made from a file with
+ * another stamp, does not match its checksum, or has sections past its
+ * end.
+ */
+bool ReadSnapshot(const char* base, std::size_t size,
+		  const SnapshotStamp& stamp,
+		  std::vector<SnapshotSection>& sections);
+}
+
+#endif
@@ -0,0 +1,294 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshTokenizer.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshTokenizer.h"
+
+#include "GmshTrace.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+
+namespace
+{
+//----------------------------------------------------------------------------
+inline bool IsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+    c == '\f';
+}
+
+//----------------------------------------------------------------------------
+template <typename IntegerType>
+bool ParseInteger(const char* first, const char* last, IntegerType& value)
+{
+  if (first != last && *first == '+') {
+    ++first;
+  }
+  const std::from_chars_result result = std::from_chars(first, last, value);
+  return result.ec == std::errc() && result.ptr == last;
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+Tokenizer::Tokenizer(std::istream& stream, std::size_t BufferSize)
+  : Stream(stream)
+  , Buffer(std::max<std::size_t>(BufferSize, 2))
+{
+  const std::streamoff offset = stream.tellg();
+  this->BufferOffset = offset > 0 ? offset : 0;
+  this->Buffer[0] = '\0';
+}
+
+//----------------------------------------------------------------------------
+// Move the unread characters to the front of the buffer and append the
+// next block of the stream, growing the buffer when a single line or
+// token fills it. Returns false when nothing more could be read.
+bool Tokenizer::Fill()
+{
+  if (this->EndOfStream) {
+    return false;
+  }
+
+  char* data = this->Buffer.data();
+  const std::size_t unread = this->End - this->Begin;
+  std::memmove(data, data + this->Begin, unread);
+  this->BufferOffset += this->Begin;
+  this->Begin = 0;
+  this->End = unread;
+
+  if (this->End + 1 == this->Buffer.size()) {
+    this->Buffer.resize(2 * this->Buffer.size());
+    data = this->Buffer.data();
+  }
+
+  const double start = this->Tracer ? this->Tracer->Now() : 0.0;
+  this->Stream.read(data + this->End,
+		    static_cast<std::streamsize>(this->Buffer.size() - 1 -
+						 this->End));
+  const std::streamsize count = this->Stream.gcount();
+  if (this->Tracer) {
+    this->Tracer->AddSpan("io", "Read", start, this->Tracer->Now(),
+			  { { "offset", static_cast<double>(
+				this->BufferOffset + this->End) },
+			    { "bytes", static_cast<double>(count) } });
+    this->Tracer->AddToCounter("Bytes read", static_cast<double>(count));
+  }
+  this->End += static_cast<std::size_t>(count);
+  data[this->End] = '\0';
+
+  if (!this->Stream) {
+    this->EndOfStream = true;
+  }
+  return count > 0;
+}
+
+//----------------------------------------------------------------------------
+// Skip whitespace and make sure the whole next token is in the buffer.
+bool Tokenizer::NextToken(std::size_t& TokenEnd)
+{
+  for (;;) {
+    while (this->Begin < this->End && IsSpace(this->Buffer[this->Begin])) {
+      ++this->Begin;
+    }
+    if (this->Begin < this->End) {
+      break;
+    }
+    if (!this->Fill()) {
+      this->Failed = true;
+      this->Truncated = true;
+      return false;
+    }
+  }
+
+  std::size_t i = this->Begin;
+  for (;;) {
+    while (i < this->End && !IsSpace(this->Buffer[i])) {
+      ++i;
+    }
+    if (i < this->End || this->EndOfStream) {
+      break;
+    }
+    i -= this->Begin;
+    this->Fill();
+    i += this->Begin;
+  }
+
+  // A number cut by the end of the stream may still be completed.
+  this->Truncated = i == this->End;
+  TokenEnd = i;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::FindEndOfLine(std::size_t& EndOfLine)
+{
+  std::size_t searched = this->Begin;
+  for (;;) {
+    const char* data = this->Buffer.data();
+    const void* found =
+      std::memchr(data + searched, '\n', this->End - searched);
+    if (found) {
+      EndOfLine = static_cast<const char*>(found) - data;
+      return true;
+    }
+
+    searched = this->End - this->Begin;
+    if (!this->Fill()) {
+      this->Truncated = true;
+      return false;
+    }
+    searched += this->Begin;
+  }
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::Read(int& value)
+{
+  std::size_t TokenEnd;
+  if (this->Failed || !this->NextToken(TokenEnd) ||
+      !ParseInteger(this->Buffer.data() + this->Begin,
+		    this->Buffer.data() + TokenEnd, value)) {
+    this->Failed = true;
+    return false;
+  }
+  this->Begin = TokenEnd;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::Read(long long& value)
+{
+  std::size_t TokenEnd;
+  if (this->Failed || !this->NextToken(TokenEnd) ||
+      !ParseInteger(this->Buffer.data() + this->Begin,
+		    this->Buffer.data() + TokenEnd, value)) {
+    this->Failed = true;
+    return false;
+  }
+  this->Begin = TokenEnd;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::Read(std::size_t& value)
+{
+  std::size_t TokenEnd;
+  if (this->Failed || !this->NextToken(TokenEnd) ||
+      !ParseInteger(this->Buffer.data() + this->Begin,
+		    this->Buffer.data() + TokenEnd, value)) {
+    this->Failed = true;
+    return false;
+  }
+  this->Begin = TokenEnd;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::Read(double& value)
+{
+  std::size_t TokenEnd;
+  if (this->Failed || !this->NextToken(TokenEnd)) {
+    this->Failed = true;
+    return false;
+  }
+
+  // The token is followed by whitespace or by the terminating 0, where
+  // strtod stops.
+  const char* first = this->Buffer.data() + this->Begin;
+  char* last = nullptr;
+  value = std::strtod(first, &last);
+  if (last != this->Buffer.data() + TokenEnd) {
+    this->Failed = true;
+    return false;
+  }
+  this->Begin = TokenEnd;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::Skip(std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    std::size_t TokenEnd;
+    if (this->Failed || !this->NextToken(TokenEnd)) {
+      this->Failed = true;
+      return false;
+    }
+    this->Begin = TokenEnd;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::ReadLine(std::string& line, bool unterminated)
+{
+  if (this->Failed) {
+    return false;
+  }
+
+  std::size_t EndOfLine;
+  std::size_t next;
+  if (this->FindEndOfLine(EndOfLine)) {
+    next = EndOfLine + 1;
+  } else if (unterminated && this->Begin < this->End) {
+    EndOfLine = next = this->End;
+  } else {
+    return false;
+  }
+
+  std::size_t last = EndOfLine;
+  if (last > this->Begin && this->Buffer[last - 1] == '\r') {
+    --last;
+  }
+  line.assign(this->Buffer.data() + this->Begin, last - this->Begin);
+  this->Begin = next;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool Tokenizer::SkipLine()
+{
+  std::size_t EndOfLine;
+  if (this->Failed || !this->FindEndOfLine(EndOfLine)) {
+    return false;
+  }
+  this->Begin = EndOfLine + 1;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::streamoff Tokenizer::Tell() const
+{
+  return this->BufferOffset + static_cast<std::streamoff>(this->Begin);
+}
+
+//----------------------------------------------------------------------------
+void Tokenizer::Seek(std::streamoff offset)
+{
+  this->Stream.clear();
+  this->Stream.seekg(offset);
+  this->Begin = 0;
+  this->End = 0;
+  this->Buffer[0] = '\0';
+  this->BufferOffset = offset;
+  this->EndOfStream = false;
+  this->Failed = false;
+  this->Truncated = false;
+}
+}
@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshTokenizer.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   GmshCore::Tokenizer
+ * @brief   Buffered reader of the numbers and lines of an ASCII MSH file.
+ *
+ * The stream is read in large blocks and numbers are decoded in place with
+ * std::from_chars and strtod, which is several times faster than the
+ * formatted extraction operators of std::istream. The tokenizer reads ahead
+ * of the tokens it returns, so the position of the underlying stream is
+ * only meaningful again after a call to Seek.
+ */
+
+#ifndef GmshTokenizer_h
+#define GmshTokenizer_h
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace GmshCore
+{
+class Trace;
+
+class Tokenizer
+{
+public:
+  static constexpr std::size_t DefaultBufferSize = 1 << 20;
+
+  explicit Tokenizer(std::istream& stream,
+		     std::size_t BufferSize = DefaultBufferSize);
+
+  //@{
+  /**
+   * Read the next whitespace separated number. On a malformed number or
+   * at the end of the stream, false is returned and the tokenizer fails
+   * until the next Seek.
+   */
+  bool Read(int& value);
+  bool Read(long long& value);
+  bool Read(std::size_t& value);
+  bool Read(double& value);
+  //@}
+
+  /**
+   * Skip the next count whitespace separated tokens without decoding
+   * them, with the same failure rules as Read.
+   */
+  bool Skip(std::size_t count = 1);
+
+  /**
+   * Read the rest of the current line, without its end of line. A line
+   * that is not terminated, such as one still being written by a running
+   * solver, is not consumed and false is returned, unless unterminated is
+   * true in which case the last line of the stream is returned as well.
+   */
+  bool ReadLine(std::string& line, bool unterminated = false);
+
+  /**
+   * Skip the rest of the current line, with the same rules as ReadLine.
+   */
+  bool SkipLine();
+
+  /**
+   * Offset in the stream of the next character to be read.
+   */
+  std::streamoff Tell() const;
+
+  /**
+   * Move to the given offset of the stream and clear the failed state.
+   */
+  void Seek(std::streamoff offset);
+
+  /**
+   * Whether a read failed since the last Seek.
+   */
+  bool Fail() const { return this->Failed; }
+
+  /**
+   * Whether the last failed read ran into the end of the stream, as
+   * happens with a file that is still being written.
+   */
+  bool EndReached() const { return this->EndOfStream && this->Truncated; }
+
+  //@{
+  /**
+   * Trace recording each read of the stream, with the number of bytes
+   * read as the "Bytes read" counter, and passed to the parser functions
+   * reading from this tokenizer. None by default.
+   */
+  void SetTrace(Trace* trace) { this->Tracer = trace; }
+  Trace* GetTrace() const { return this->Tracer; }
+  //@}
+
+private:
+  bool Fill();
+  bool NextToken(std::size_t& TokenEnd);
+  bool FindEndOfLine(std::size_t& EndOfLine);
+
+  std::istream& Stream;
+  std::vector<char> Buffer;
+
+  // Unread characters are in [Begin, End) and Buffer[End] is always 0, so
+  // that numbers can be decoded with the C library in place.
+  std::size_t Begin = 0;
+  std::size_t End = 0;
+  std::streamoff BufferOffset = 0;
+  bool EndOfStream = false;
+  bool Failed = false;
+  bool Truncated = false;
+  Trace* Tracer = nullptr;
+};
+}
+
+#endif
@@ -0,0 +1,194 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshTrace.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshTrace.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Quote a string as a JSON string.
+std::string Quote(const std::string& text)
+{
+  std::string quoted = "\"";
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + '"';
+}
+
+//----------------------------------------------------------------------------
+// Format a number of microseconds or an argument value.
+std::string Format(double value)
+{
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.3f", value);
+  return text;
+}
+}
+
+namespace GmshCore
+{
+//----------------------------------------------------------------------------
+Trace::Trace()
+  : Start(std::chrono::steady_clock::now())
+{
+}
+
+//----------------------------------------------------------------------------
+double Trace::Now() const
+{
+  const std::chrono::duration<double, std::micro> elapsed =
+    std::chrono::steady_clock::now() - this->Start;
+  return elapsed.count();
+}
+
+//----------------------------------------------------------------------------
+void Trace::AddSpan(const char* category, std::string name, double start,
+		    double end, Arguments arguments)
+{
+  Event event;
+  event.Category = category;
+  event.Name = std::move(name);
+  event.Timestamp = start;
+  event.Duration = end - start;
+  event.Values = std::move(arguments);
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  event.Thread = this->GetThread();
+  this->Events.push_back(std::move(event));
+}
+
+//----------------------------------------------------------------------------
+void Trace::SetCounter(const std::string& name, double value)
+{
+  this->AddCounter(name, value, false);
+}
+
+//----------------------------------------------------------------------------
+void Trace::AddToCounter(const std::string& name, double value)
+{
+  this->AddCounter(name, value, true);
+}
+
+//----------------------------------------------------------------------------
+void Trace::AddCounter(const std::string& name, double value, bool add)
+{
+  Event event;
+  event.Phase = 'C';
+  event.Name = name;
+  event.Timestamp = this->Now();
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  double& counter = this->Counters[name];
+  counter = add ? counter + value : value;
+  event.Values.emplace_back("value", counter);
+  this->Events.push_back(std::move(event));
+}
+
+//----------------------------------------------------------------------------
+// Track of the calling thread, numbered in order of first use.
+int Trace::GetThread()
+{
+  const auto inserted = this->Threads.emplace(
+    std::this_thread::get_id(), static_cast<int>(this->Threads.size()));
+  return inserted.first->second;
+}
+
+//----------------------------------------------------------------------------
+bool Trace::Write(const std::string& FileName) const
+{
+  std::ofstream file(FileName);
+  if (!file) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  const char* separator = "\n";
+
+  // The first thread to record is the one driving the reader.
+  for (const auto& thread : this->Threads) {
+    const std::string name = thread.second == 0
+      ? "Reader" : "Worker " + std::to_string(thread.second);
+    file << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+	 << "\"tid\":" << thread.second << ",\"args\":{\"name\":"
+	 << Quote(name) << "}}";
+    separator = ",\n";
+  }
+
+  for (const Event& event : this->Events) {
+    file << separator << "{\"name\":" << Quote(event.Name) << ",\"ph\":\""
+	 << event.Phase << "\",\"ts\":" << Format(event.Timestamp)
+	 << ",\"pid\":1";
+    if (event.Phase == 'X') {
+      file << ",\"tid\":" << event.Thread << ",\"cat\":"
+	   << Quote(event.Category) << ",\"dur\":" << Format(event.Duration);
+    }
+    if (!event.Values.empty()) {
+      file << ",\"args\":{";
+      for (std::size_t i = 0; i < event.Values.size(); ++i) {
+	file << (i > 0 ? "," : "") << Quote(event.Values[i].first) << ":"
+	     << Format(event.Values[i].second);
+      }
+      file << "}";
+    }
+    file << "}";
+    separator = ",\n";
+  }
+
+  file << "\n]}\n";
+  return static_cast<bool>(file);
+}
+
+//----------------------------------------------------------------------------
+Trace::Scope::Scope(Trace* trace, const char* category, std::string name)
+  : Owner(trace)
+  , Category(category)
+  , Name(std::move(name))
+{
+  if (this->Owner) {
+    this->Start = this->Owner->Now();
+  }
+}
+
+//----------------------------------------------------------------------------
+Trace::Scope::~Scope()
+{
+  if (this->Owner) {
+    this->Owner->AddSpan(this->Category, std::move(this->Name), this->Start,
+			 this->Owner->Now(), std::move(this->Values));
+  }
+}
+
+//----------------------------------------------------------------------------
+Trace::Scope& Trace::Scope::Argument(const char* name, double value)
+{
+  if (this->Owner) {
+    this->Values.emplace_back(name, value);
+  }
+  return *this;
+}
+}
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshTrace.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   GmshCore::Trace
+ * @brief   Recorder of timed spans and counters, written as Chrome trace
+ * events.
+ *
+ * Spans are recorded on the track of the thread that closes them, and
+ * counters on tracks of their own, so that the written JSON file shows the
+ * work of each thread over time when loaded in Perfetto or
+ * chrome://tracing. Recording is thread-safe. Code paths take a possibly
+ * null Trace pointer, a null pointer recording nothing.
+ */
+
+#ifndef GmshTrace_h
+#define GmshTrace_h
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace GmshCore
+{
+class Trace
+{
+public:
+  // Numeric arguments shown with an event.
+  using Arguments = std::vector<std::pair<std::string, double>>;
+
+  Trace();
+
+  /**
+   * Microseconds elapsed since the trace was created.
+   */
+  double Now() const;
+
+  /**
+   * Record a span of the calling thread between two times given by Now.
+   */
+  void AddSpan(const char* category, std::string name, double start,
+	       double end, Arguments arguments = Arguments());
+
+  //@{
+  /**
+   * Record the value of a counter at the current time, either as given or
+   * added to its previous value, for totals of several threads.
+   */
+  void SetCounter(const std::string& name, double value);
+  void AddToCounter(const std::string& name, double value);
+  //@}
+
+  /**
+   * Write the events recorded so far as a Chrome trace event JSON file.
+   */
+  bool Write(const std::string& FileName) const;
+
+  /**
+   * Span of the calling thread from the construction of the scope to its
+   * destruction.
+   */
+  class Scope
+  {
+  public:
+    Scope(Trace* trace, const char* category, std::string name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    Scope& Argument(const char* name, double value);
+
+  private:
+    Trace* Owner;
+    const char* Category;
+    std::string Name;
+    double Start = 0.0;
+    Arguments Values;
+  };
+
+private:
+  struct Event
+  {
+    char Phase = 'X';
+    const char* Category = "";
+    std::string Name;
+    double Timestamp = 0.0;
+    double Duration = 0.0;
+    int Thread = 0;
+    Arguments Values;
+  };
+
+  void AddCounter(const std::string& name, double value, bool add);
+  int GetThread();
+
+  std::chrono::steady_clock::time_point Start;
+  mutable std::mutex Mutex;
+  std::vector<Event> Events;
+  std::map<std::thread::id, int> Threads;
+  std::map<std::string, double> Counters;
+};
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    GmshTesting.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @brief   Checks shared by the GmshCore tests.
+ *
+ * A failed GMSH_CHECK prints the failed expression and its location and
+ * is counted, so that a test reports every failure before returning
+ * GmshTesting::Result() from main.
+ */
+
+#ifndef GmshTesting_h
+#define GmshTesting_h
+
+#include <cstdlib>
+#include <iostream>
+
+namespace GmshTesting
+{
+inline int& Failures()
+{
+  static int count = 0;
+  return count;
+}
+
+inline bool Check(bool condition, const char* expression, const char* file,
+		  int line)
+{
+  if (!condition) {
+    std::cerr << file << ":" << line << ": check failed: " << expression
+	      << "\n";
+    ++Failures();
+  }
+  return condition;
+}
+
+inline int Result()
+{
+  return Failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}
+
+#define GMSH_CHECK(condition)                                                  \
+  GmshTesting::Check((condition), #condition, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshBlockCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshBlockCache.h"
+#include "GmshTesting.h"
+
+#include <memory>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Node block of count nodes, of 32 bytes each.
+std::shared_ptr<const GmshCore::DecodedBlock> MakeBlock(std::size_t count)
+{
+  auto block = std::make_shared<GmshCore::DecodedBlock>();
+  block->Tags.assign(count, 1);
+  block->Coordinates.assign(3 * count, 0.0);
+  return block;
+}
+
+//----------------------------------------------------------------------------
+// The least recently used blocks are evicted beyond the capacity, and
+// blocks are keyed by file and offset.
+void TestEviction()
+{
+  GmshCore::BlockCache cache;
+  cache.SetCapacity(64);
+  const auto a = MakeBlock(1);
+  const auto b = MakeBlock(1);
+  const auto c = MakeBlock(1);
+  cache.Insert({ "a.msh", 0 }, a);
+  cache.Insert({ "a.msh", 10 }, b);
+  GMSH_CHECK(cache.GetSize() == 64);
+  GMSH_CHECK(cache.Find({ "a.msh", 0 }) == a);
+  GMSH_CHECK(!cache.Find({ "b.msh", 0 }));
+
+  // b is the least recently used once a is found.
+  cache.Insert({ "a.msh", 20 }, c);
+  GMSH_CHECK(cache.GetSize() == 64);
+  GMSH_CHECK(!cache.Find({ "a.msh", 10 }));
+  GMSH_CHECK(cache.Find({ "a.msh", 0 }) == a);
+  GMSH_CHECK(cache.Find({ "a.msh", 20 }) == c);
+
+  // A block in use stays alive once evicted.
+  cache.SetCapacity(32);
+  GMSH_CHECK(cache.GetSize() == 32);
+  GMSH_CHECK(!cache.Find({ "a.msh", 0 }) && a->Tags.size() == 1);
+}
+
+//----------------------------------------------------------------------------
+// A single block larger than the capacity is held on its own, without
+// evicting the others, until another one replaces it.
+void TestOversized()
+{
+  GmshCore::BlockCache cache;
+  cache.SetCapacity(64);
+  const auto small = MakeBlock(2);
+  const auto large = MakeBlock(10);
+  const auto larger = MakeBlock(20);
+  cache.Insert({ "a.msh", 0 }, small);
+  cache.Insert({ "a.msh", 100 }, large);
+  GMSH_CHECK(cache.Find({ "a.msh", 100 }) == large);
+  GMSH_CHECK(cache.Find({ "a.msh", 0 }) == small);
+  GMSH_CHECK(cache.GetSize() == 64 + 320);
+
+  cache.Insert({ "a.msh", 200 }, larger);
+  GMSH_CHECK(!cache.Find({ "a.msh", 100 }));
+  GMSH_CHECK(cache.Find({ "a.msh", 200 }) == larger);
+
+  // Nothing is held without capacity.
+  cache.SetCapacity(0);
+  GMSH_CHECK(cache.GetSize() == 0 && !cache.Find({ "a.msh", 200 }));
+  cache.Insert({ "a.msh", 200 }, larger);
+  GMSH_CHECK(!cache.Find({ "a.msh", 200 }));
+}
+
+//----------------------------------------------------------------------------
+// Element blocks delivered in several calls are decoded whole.
+void TestDecode()
+{
+  GmshCore::DecodedBlock decoded;
+  GmshCore::ElementBlock block;
+  block.EntityDim = 2;
+  block.EntityTag = 3;
+  block.Type = GmshCore::GetElementType(2);
+  const std::vector<std::size_t> tags[2] = { { 1, 2 }, { 3 } };
+  const std::vector<std::size_t> nodes[2] = { { 1, 2, 3, 2, 3, 4 },
+					      { 3, 4, 5 } };
+  for (int i = 0; i < 2; ++i) {
+    block.Tags = tags[i];
+    block.NodeTags = nodes[i];
+    decoded.OnElementBlock(block);
+  }
+  const GmshCore::ElementBlock whole = decoded.GetElementBlock();
+  GMSH_CHECK(whole.EntityTag == 3 && whole.Tags.size() == 3 &&
+	     whole.NodeTags.size() == 9 && whole.NodeTags[8] == 5);
+  GMSH_CHECK(decoded.GetSize() == 12 * sizeof(std::size_t));
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestEviction();
+  TestOversized();
+  TestDecode();
+  return GmshTesting::Result();
+}
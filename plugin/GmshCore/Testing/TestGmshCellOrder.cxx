@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshCellOrder.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshCellOrder.h"
+#include "GmshTesting.h"
+
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Consecutive blocks of one entity are joined, others are not.
+void TestAppend()
+{
+  std::vector<GmshCore::CellBlock> blocks;
+  GmshCore::AppendCellBlock(blocks, 2, 1, 0, 4);
+  GmshCore::AppendCellBlock(blocks, 2, 1, 4, 2);
+  GmshCore::AppendCellBlock(blocks, 1, 1, 6, 3);
+  GmshCore::AppendCellBlock(blocks, 2, 1, 9, 1);
+  GMSH_CHECK(blocks.size() == 3);
+  GMSH_CHECK(blocks[0].NumberOfCells == 6);
+  GMSH_CHECK(blocks[2].FirstCell == 9);
+}
+
+//----------------------------------------------------------------------------
+// Blocks are ordered by dimension then tag, keeping the file order within
+// an entity, with the ranges of the dimensions and entities.
+void TestOrder()
+{
+  // Surface 2 (2 triangles), curve 5 (2 lines), surface 1 (1 quadrangle),
+  // surface 2 again (1 triangle).
+  std::vector<GmshCore::CellBlock> blocks;
+  GmshCore::AppendCellBlock(blocks, 2, 2, 0, 2);
+  GmshCore::AppendCellBlock(blocks, 1, 5, 2, 2);
+  GmshCore::AppendCellBlock(blocks, 2, 1, 4, 1);
+  GmshCore::AppendCellBlock(blocks, 2, 2, 5, 1);
+  const std::vector<int> offsets = { 0, 3, 6, 8, 10, 14, 17 };
+
+  GmshCore::CellOrder order;
+  GmshCore::OrderCells(blocks, offsets.data(), order);
+  GMSH_CHECK(order.Blocks.size() == 4);
+  if (order.Blocks.size() == 4) {
+    GMSH_CHECK(order.Blocks[0].EntityTag == 5 &&
+	       order.Blocks[1].EntityTag == 1 &&
+	       order.Blocks[2].FirstCell == 0 &&
+	       order.Blocks[3].FirstCell == 5);
+  }
+  GMSH_CHECK(order.FirstCells ==
+	     std::vector<long long>({ 0, 2, 3, 5, 6 }));
+  GMSH_CHECK(order.FirstVertices ==
+	     std::vector<long long>({ 0, 4, 8, 14, 17 }));
+
+  GMSH_CHECK(order.DimensionRanges[0][0] == 0 &&
+	     order.DimensionRanges[0][1] == 0);
+  GMSH_CHECK(order.DimensionRanges[1][0] == 0 &&
+	     order.DimensionRanges[1][1] == 2);
+  GMSH_CHECK(order.DimensionRanges[2][0] == 2 &&
+	     order.DimensionRanges[2][1] == 6);
+  GMSH_CHECK(order.DimensionRanges[3][0] == 6 &&
+	     order.DimensionRanges[3][1] == 6);
+
+  // The two blocks of surface 2 make one entity range.
+  using Range = std::array<long long, 4>;
+  GMSH_CHECK(order.EntityRanges ==
+	     std::vector<Range>({ { 1, 5, 0, 2 }, { 2, 1, 2, 3 },
+				  { 2, 2, 3, 6 } }));
+}
+
+//----------------------------------------------------------------------------
+// A mesh without cells has empty ranges.
+void TestEmpty()
+{
+  const long long offsets[] = { 0 };
+  GmshCore::CellOrder order;
+  GmshCore::OrderCells(std::vector<GmshCore::CellBlock>(), offsets, order);
+  GMSH_CHECK(order.Blocks.empty() && order.EntityRanges.empty());
+  GMSH_CHECK(order.FirstCells == std::vector<long long>({ 0 }));
+  GMSH_CHECK(order.DimensionRanges[3][1] == 0);
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestAppend();
+  TestOrder();
+  TestEmpty();
+  return GmshTesting::Result();
+}
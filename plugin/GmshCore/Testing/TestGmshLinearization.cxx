@@ -0,0 +1,246 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshLinearization.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshElementTypes.h"
+#include "GmshLinearization.h"
+#include "GmshTesting.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Node values of an element placed at its reference coordinates, with the
+// given number of extra field components set to 0.
+std::vector<double> GetReferenceValues(int type, int NumberOfFields)
+{
+  std::vector<double> uvw;
+  GmshCore::GetReferenceNodes(type, uvw);
+  std::vector<double> values;
+  for (std::size_t i = 0; i < uvw.size(); i += 3) {
+    values.insert(values.end(), uvw.begin() + i, uvw.begin() + i + 3);
+    values.insert(values.end(), NumberOfFields, 0.0);
+  }
+  return values;
+}
+
+//----------------------------------------------------------------------------
+// Coordinates of a point of linear cells, given the node values they were
+// made from.
+const double* GetPoint(const GmshCore::LinearCells& cells,
+		       const std::vector<double>& values, int NumberOfValues,
+		       int point)
+{
+  if (cells.Points[point] >= 0) {
+    return values.data() + cells.Points[point] * NumberOfValues;
+  }
+  int inner = 0;
+  for (int i = 0; i < point; ++i) {
+    inner += cells.Points[i] < 0;
+  }
+  return cells.Values.data() + inner * NumberOfValues;
+}
+
+//----------------------------------------------------------------------------
+// The basis interpolates every node and sums to 1.
+void TestBasis()
+{
+  for (int type = 1; type < 256; ++type) {
+    const GmshCore::ElementType* element = GmshCore::GetElementType(type);
+    if (!element || element->Topology == 1) {
+      continue;
+    }
+
+    GmshCore::LagrangeBasis basis;
+    const bool initialized = basis.Initialize(type);
+    if (!GMSH_CHECK(initialized == (element->Topology != 6))) {
+      std::cerr << "  type " << type << "\n";
+    }
+    if (!initialized) {
+      continue;
+    }
+
+    const int n = basis.GetNumberOfNodes();
+    GMSH_CHECK(n == element->NumberOfNodes);
+    std::vector<double> values(n);
+    bool kronecker = true;
+    for (int i = 0; i < n; ++i) {
+      basis.Evaluate(basis.GetNodes().data() + 3 * i, values.data());
+      for (int j = 0; j < n; ++j) {
+	kronecker = kronecker && std::abs(values[j] - (i == j)) < 1e-8;
+      }
+    }
+    if (!GMSH_CHECK(kronecker)) {
+      std::cerr << "  type " << type << "\n";
+    }
+
+    const double uvw[3] = { 0.2, 0.1, 0.3 };
+    basis.Evaluate(uvw, values.data());
+    double sum = 0.0;
+    for (const double value : values) {
+      sum += value;
+    }
+    GMSH_CHECK(std::abs(sum - 1.0) < 1e-8);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Straight elements with linear fields stay whole, with their corners.
+void TestStraight()
+{
+  for (const int type : { 8, 9, 10, 11, 12, 13, 16, 17, 18, 21, 29, 92 }) {
+    GmshCore::Linearizer linearizer;
+    GMSH_CHECK(linearizer.Initialize(type, 3, nullptr, 1e-3, 4));
+    const std::vector<double> values = GetReferenceValues(type, 0);
+    GmshCore::LinearCells cells;
+    linearizer.Subdivide(values.data(), cells);
+
+    const int corners = linearizer.GetNumberOfCorners();
+    bool whole = static_cast<int>(cells.Corners.size()) == corners &&
+      cells.Values.empty();
+    for (int i = 0; whole && i < corners; ++i) {
+      whole = cells.Points[cells.Corners[i]] == i;
+    }
+    if (!GMSH_CHECK(whole)) {
+      std::cerr << "  type " << type << "\n";
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// A curved edge splits the element, reusing its edge node, down to the
+// tolerance.
+void TestCurved()
+{
+  std::vector<double> values = GetReferenceValues(9, 0);
+  values[3 * 3 + 1] = -0.1;
+
+  GmshCore::Linearizer linearizer;
+  GmshCore::LinearCells cells;
+  GMSH_CHECK(linearizer.Initialize(9, 3, nullptr, 1e-2, 6));
+  linearizer.Subdivide(values.data(), cells);
+  const std::size_t fine = cells.Corners.size() / 3;
+  GMSH_CHECK(fine > 4);
+
+  bool reused = false;
+  for (const int point : cells.Points) {
+    reused = reused || point == 3;
+  }
+  GMSH_CHECK(reused);
+
+  // Inner points lie on the parabola through the displaced node.
+  bool curved = true;
+  for (std::size_t i = 0; i < cells.Points.size(); ++i) {
+    const double* p = GetPoint(cells, values, 3, static_cast<int>(i));
+    if (cells.Points[i] < 0 && std::abs(p[1]) < 1e-12) {
+      curved = false;
+    }
+    if (p[1] < 0) {
+      curved = curved && std::abs(p[1] + 0.4 * p[0] * (1 - p[0])) < 1e-12;
+    }
+  }
+  GMSH_CHECK(curved);
+
+  // A looser tolerance gives fewer cells.
+  GMSH_CHECK(linearizer.Initialize(9, 3, nullptr, 1e-1, 6));
+  linearizer.Subdivide(values.data(), cells);
+  GMSH_CHECK(cells.Corners.size() / 3 < fine);
+}
+
+//----------------------------------------------------------------------------
+// Fields split straight elements relative to their range, and fields
+// without range do not.
+void TestFields()
+{
+  std::vector<double> values = GetReferenceValues(8, 1);
+  values[2 * 4 + 3] = 1.0;
+
+  GmshCore::Linearizer linearizer;
+  GmshCore::LinearCells cells;
+  double range = 1.0;
+  GMSH_CHECK(linearizer.Initialize(8, 4, &range, 1e-3, 2));
+  linearizer.Subdivide(values.data(), cells);
+  GMSH_CHECK(cells.Corners.size() == 8);
+  GMSH_CHECK(cells.Values.size() == 2 * 4);
+
+  range = 0.0;
+  GMSH_CHECK(linearizer.Initialize(8, 4, &range, 1e-3, 2));
+  linearizer.Subdivide(values.data(), cells);
+  GMSH_CHECK(cells.Corners.size() == 2);
+}
+
+//----------------------------------------------------------------------------
+// A tolerance of 0 splits down to the maximum depth, into cells covering
+// the element with their orientation.
+void TestDepth()
+{
+  const struct
+  {
+    int Type;
+    int Depth;
+    std::size_t NumberOfCells;
+  } cases[] = { { 1, 3, 8 }, { 2, 2, 16 }, { 3, 2, 16 }, { 4, 2, 64 },
+		{ 5, 1, 8 }, { 6, 1, 8 }, { 9, 0, 1 } };
+  for (const auto& c : cases) {
+    GmshCore::Linearizer linearizer;
+    GMSH_CHECK(linearizer.Initialize(c.Type, 3, nullptr, 0.0, c.Depth));
+    const std::vector<double> values = GetReferenceValues(c.Type, 0);
+    GmshCore::LinearCells cells;
+    linearizer.Subdivide(values.data(), cells);
+    const int corners = linearizer.GetNumberOfCorners();
+    if (!GMSH_CHECK(cells.Corners.size() / corners == c.NumberOfCells)) {
+      std::cerr << "  type " << c.Type << "\n";
+    }
+  }
+
+  // Tetrahedra fill the reference tetrahedron without inverting.
+  GmshCore::Linearizer linearizer;
+  GMSH_CHECK(linearizer.Initialize(4, 3, nullptr, 0.0, 2));
+  const std::vector<double> values = GetReferenceValues(4, 0);
+  GmshCore::LinearCells cells;
+  linearizer.Subdivide(values.data(), cells);
+  double volume = 0.0;
+  bool positive = true;
+  for (std::size_t i = 0; i < cells.Corners.size(); i += 4) {
+    const double* p[4];
+    for (int k = 0; k < 4; ++k) {
+      p[k] = GetPoint(cells, values, 3, cells.Corners[i + k]);
+    }
+    double e[3][3];
+    for (int k = 0; k < 3; ++k) {
+      for (int c = 0; c < 3; ++c) {
+	e[k][c] = p[k + 1][c] - p[0][c];
+      }
+    }
+    const double v = (e[0][0] * (e[1][1] * e[2][2] - e[1][2] * e[2][1]) -
+		      e[0][1] * (e[1][0] * e[2][2] - e[1][2] * e[2][0]) +
+		      e[0][2] * (e[1][0] * e[2][1] - e[1][1] * e[2][0])) / 6;
+    positive = positive && v > 0.0;
+    volume += v;
+  }
+  GMSH_CHECK(positive);
+  GMSH_CHECK(std::abs(volume - 1.0 / 6) < 1e-12);
+}
+}
+
+int main()
+{
+  TestBasis();
+  TestStraight();
+  TestCurved();
+  TestFields();
+  TestDepth();
+  return GmshTesting::Result();
+}
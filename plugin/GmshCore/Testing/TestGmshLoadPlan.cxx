@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshLoadPlan.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshLoadPlan.h"
+#include "GmshTesting.h"
+
+namespace
+{
+//----------------------------------------------------------------------------
+// 100 tetrahedra and 20 boundary triangles on 50 nodes.
+GmshCore::OutputSizes MakeSizes()
+{
+  std::vector<GmshCore::ElementBlockHeader> blocks(2);
+  blocks[0].EntityDim = 3;
+  blocks[0].Type = GmshCore::GetElementType(4);
+  blocks[0].NumberOfElements = 100;
+  blocks[1].EntityDim = 2;
+  blocks[1].Type = GmshCore::GetElementType(2);
+  blocks[1].NumberOfElements = 20;
+  return GmshCore::PredictOutputSizes(blocks, 50);
+}
+
+//----------------------------------------------------------------------------
+// Sizes count the cells of lower dimension apart, and each level reduces
+// the predicted bytes.
+void TestSizes()
+{
+  const GmshCore::OutputSizes sizes = MakeSizes();
+  GMSH_CHECK(sizes.Points == 50 && sizes.Cells == 120 &&
+	     sizes.Connectivity == 460 && sizes.MeshDimension == 3);
+  GMSH_CHECK(sizes.BoundaryCells == 20 && sizes.BoundaryConnectivity == 60);
+
+  using GmshCore::Degradation;
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::None,
+					  false) == 5968);
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::Connectivity,
+					  false) == 3644);
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::Coordinates,
+					  false) == 3044);
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::Boundary,
+					  false) == 944);
+
+  // Exploded cells have a point per vertex.
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::None, true) ==
+	     5968 + 3 * 8 * (460 - 50));
+}
+
+//----------------------------------------------------------------------------
+// The lowest level that fits is planned, up to the maximum level.
+void TestLevels()
+{
+  using GmshCore::Degradation;
+  const GmshCore::OutputSizes sizes = MakeSizes();
+  GmshCore::LoadPlan plan;
+  GMSH_CHECK(GmshCore::PlanLoad(sizes, 1e6, Degradation::Boundary, false,
+				plan));
+  GMSH_CHECK(plan.Level == Degradation::None && !plan.NarrowConnectivity &&
+	     !plan.FloatCoordinates && plan.Bytes == plan.Estimate);
+
+  GMSH_CHECK(GmshCore::PlanLoad(sizes, 4000, Degradation::Boundary, false,
+				plan));
+  GMSH_CHECK(plan.Level == Degradation::Connectivity &&
+	     plan.NarrowConnectivity && !plan.FloatCoordinates);
+  GMSH_CHECK(plan.Estimate == 5968 && plan.Bytes == 3644);
+
+  GMSH_CHECK(GmshCore::PlanLoad(sizes, 1000, Degradation::Boundary, false,
+				plan));
+  GMSH_CHECK(plan.Level == Degradation::Boundary && plan.FloatCoordinates &&
+	     plan.MeshDimension == 3);
+
+  GMSH_CHECK(!GmshCore::PlanLoad(sizes, 1000, Degradation::Coordinates,
+				 false, plan));
+  GMSH_CHECK(plan.Level == Degradation::Coordinates && plan.Bytes == 3044);
+  GMSH_CHECK(!GmshCore::PlanLoad(sizes, 100, Degradation::Boundary, false,
+				 plan));
+  GMSH_CHECK(plan.Level == Degradation::Boundary && plan.Bytes == 944);
+}
+
+//----------------------------------------------------------------------------
+// Fields selected explicitly are kept when the others are dropped.
+void TestFields()
+{
+  using GmshCore::Degradation;
+  GmshCore::OutputSizes sizes = MakeSizes();
+  sizes.PointComponents = 4;
+  sizes.ExplicitPointComponents = 1;
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::Coordinates,
+					  false) == 3044 + 8 * 4 * 50);
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::Fields,
+					  false) == 3044 + 8 * 1 * 50);
+
+  GmshCore::LoadPlan plan;
+  GMSH_CHECK(GmshCore::PlanLoad(sizes, 3500, Degradation::Boundary, false,
+				plan));
+  GMSH_CHECK(plan.Level == Degradation::Fields);
+}
+
+//----------------------------------------------------------------------------
+// Elements of the mesh dimension are only dropped for lower ones, and
+// connectivity stays 64-bit beyond the 32-bit range.
+void TestLimits()
+{
+  using GmshCore::Degradation;
+  GmshCore::OutputSizes sizes = MakeSizes();
+  sizes.BoundaryCells = sizes.BoundaryConnectivity = 0;
+  GmshCore::LoadPlan plan;
+  GMSH_CHECK(!GmshCore::PlanLoad(sizes, 100, Degradation::Boundary, false,
+				 plan));
+  GMSH_CHECK(plan.Level == Degradation::Fields);
+
+  sizes.Points = 3e9;
+  GMSH_CHECK(GmshCore::PredictOutputBytes(sizes, Degradation::Connectivity,
+					  false) ==
+	     GmshCore::PredictOutputBytes(sizes, Degradation::None, false));
+  GMSH_CHECK(GmshCore::PlanLoad(sizes, 5e10, Degradation::Boundary, false,
+				plan));
+  GMSH_CHECK(plan.Level == Degradation::Coordinates &&
+	     !plan.NarrowConnectivity && plan.FloatCoordinates);
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestSizes();
+  TestLevels();
+  TestFields();
+  TestLimits();
+  return GmshTesting::Result();
+}
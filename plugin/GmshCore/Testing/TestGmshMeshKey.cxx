@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshMeshKey.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshMeshKey.h"
+#include "GmshTesting.h"
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Update of a reader keeping the mesh of key kept: the mesh is read again,
+// and its key replaced, unless it serves the request. Returns whether the
+// mesh was read.
+bool Update(GmshCore::MeshKey& kept, const GmshCore::MeshKey& request)
+{
+  if (GmshCore::CanReuseMesh(kept, request)) {
+    return false;
+  }
+  kept = request;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+GmshCore::MeshKey MakeRequest()
+{
+  GmshCore::MeshKey request;
+  request.Signature = "$Nodes 1 4 1 4\n$Elements 1 2 1 2\n";
+  return request;
+}
+
+//----------------------------------------------------------------------------
+// Turning validation on between two updates reads the unvalidated mesh
+// again; a validated mesh serves later updates with validation on or off.
+void TestValidation()
+{
+  GmshCore::MeshKey kept;
+  GmshCore::MeshKey request = MakeRequest();
+  GMSH_CHECK(Update(kept, request));
+  GMSH_CHECK(!Update(kept, request));
+
+  request.Validated = true;
+  GMSH_CHECK(Update(kept, request));
+  GMSH_CHECK(kept.Validated);
+  GMSH_CHECK(!Update(kept, request));
+
+  request.Validated = false;
+  GMSH_CHECK(!Update(kept, request));
+  request.Validated = true;
+  GMSH_CHECK(!Update(kept, request));
+}
+
+//----------------------------------------------------------------------------
+// Parametric coordinates are read when first requested, and kept.
+void TestParametric()
+{
+  GmshCore::MeshKey kept = MakeRequest();
+  GmshCore::MeshKey request = MakeRequest();
+  request.Parametric = true;
+  GMSH_CHECK(Update(kept, request));
+  request.Parametric = false;
+  GMSH_CHECK(!Update(kept, request));
+}
+
+//----------------------------------------------------------------------------
+// Any other change of how the mesh is built reads it again.
+void TestChanges()
+{
+  const GmshCore::MeshKey base = MakeRequest();
+  GmshCore::MeshKey request = base;
+  request.Signature = "$Nodes 1 5 1 5\n$Elements 1 2 1 2\n";
+  GMSH_CHECK(!GmshCore::CanReuseMesh(base, request));
+
+  request = base;
+  request.Partial = true;
+  request.NumberOfPieces = 2;
+  GMSH_CHECK(!GmshCore::CanReuseMesh(base, request));
+  GmshCore::MeshKey other = request;
+  other.Piece = 1;
+  GMSH_CHECK(!GmshCore::CanReuseMesh(request, other));
+
+  request = base;
+  request.Partial = true;
+  request.Entities = "Volume 1\n";
+  GMSH_CHECK(!GmshCore::CanReuseMesh(base, request));
+
+  request = base;
+  request.SortedCells = true;
+  GMSH_CHECK(!GmshCore::CanReuseMesh(base, request));
+  GMSH_CHECK(!GmshCore::CanReuseMesh(request, base));
+
+  // Dropping fields keeps the mesh arrays; narrowing them does not.
+  request = base;
+  request.Plan.Level = GmshCore::Degradation::Fields;
+  request.Plan.NarrowConnectivity = true;
+  request.Plan.FloatCoordinates = true;
+  GMSH_CHECK(!GmshCore::CanReuseMesh(base, request));
+  other = request;
+  other.Plan.Level = GmshCore::Degradation::Coordinates;
+  GMSH_CHECK(GmshCore::CanReuseMesh(request, other));
+  other.Plan.Level = GmshCore::Degradation::Boundary;
+  GMSH_CHECK(!GmshCore::CanReuseMesh(request, other));
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestValidation();
+  TestParametric();
+  TestChanges();
+  return GmshTesting::Result();
+}
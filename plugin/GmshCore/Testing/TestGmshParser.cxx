@@ -0,0 +1,474 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshParser.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshParser.h"
+#include "GmshTesting.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Two triangles on three nodes of a point entity and one parametric node
+// of a surface, with a node view and an element node view.
+const char* const Mesh = "$MeshFormat\n"
+			 "4.1 0 8\n"
+			 "$EndMeshFormat\n"
+			 "$Nodes\n"
+			 "2 4 1 4\n"
+			 "2 1 0 3\n"
+			 "1\n"
+			 "2\n"
+			 "3\n"
+			 "0 0 0\n"
+			 "1 0 0\n"
+			 "0 1 0\n"
+			 "2 2 1 1\n"
+			 "4\n"
+			 "1 1 0 0.5 0.5\n"
+			 "$EndNodes\n"
+			 "$Elements\n"
+			 "1 2 1 2\n"
+			 "2 1 2 2\n"
+			 "1 1 2 3\n"
+			 "2 2 4 3\n"
+			 "$EndElements\n"
+			 "$NodeData\n"
+			 "1\n"
+			 "\"T\"\n"
+			 "1\n"
+			 "0.5\n"
+			 "3\n"
+			 "0\n"
+			 "1\n"
+			 "4\n"
+			 "1 1.0\n"
+			 "2 2.0\n"
+			 "3 3e0\n"
+			 "4 -4\n"
+			 "$EndNodeData\n"
+			 "$ElementNodeData\n"
+			 "1\n"
+			 "\"U\"\n"
+			 "1\n"
+			 "1\n"
+			 "3\n"
+			 "0\n"
+			 "1\n"
+			 "2\n"
+			 "1 3 1 2 3\n"
+			 "2 3 4 5 6\n"
+			 "$EndElementNodeData\n";
+
+//----------------------------------------------------------------------------
+// Copy of everything delivered by the parser.
+class Recorder : public GmshCore::Handler
+{
+public:
+  bool WantsParametricCoordinates() override { return this->Parametric; }
+
+  void OnNodeBlock(const GmshCore::NodeBlock& block) override
+  {
+    this->NodeEntities.push_back(block.EntityTag);
+    this->NodeTags.insert(this->NodeTags.end(), block.Tags.begin(),
+			  block.Tags.end());
+    this->Coordinates.insert(this->Coordinates.end(),
+			     block.Coordinates.begin(),
+			     block.Coordinates.end());
+    this->ParametricCoordinates.insert(
+      this->ParametricCoordinates.end(), block.ParametricCoordinates.begin(),
+      block.ParametricCoordinates.end());
+  }
+
+  void OnElementBlock(const GmshCore::ElementBlock& block) override
+  {
+    this->ElementTypes.push_back(block.Type->Type);
+    this->ElementTags.insert(this->ElementTags.end(), block.Tags.begin(),
+			     block.Tags.end());
+    this->ElementNodeTags.insert(this->ElementNodeTags.end(),
+				 block.NodeTags.begin(),
+				 block.NodeTags.end());
+  }
+
+  void OnInterpolationScheme(
+    const std::string& name,
+    const GmshCore::InterpolationScheme& scheme) override
+  {
+    this->Schemes[name] = scheme;
+  }
+
+  bool WantsRecord(std::size_t tag) override
+  {
+    return this->Wanted.empty() || this->Wanted.count(tag) > 0;
+  }
+
+  void OnDataRecords(const GmshCore::DataRecords& records) override
+  {
+    this->Views.push_back(records.Header->GetName());
+    this->RecordTags.insert(this->RecordTags.end(), records.Tags.begin(),
+			    records.Tags.end());
+    this->Values.insert(this->Values.end(), records.Values.begin(),
+			records.Values.end());
+  }
+
+  bool Parametric = false;
+  std::set<std::size_t> Wanted;
+  std::vector<int> NodeEntities;
+  std::vector<std::size_t> NodeTags;
+  std::vector<double> Coordinates;
+  std::vector<double> ParametricCoordinates;
+  std::vector<int> ElementTypes;
+  std::vector<std::size_t> ElementTags;
+  std::vector<std::size_t> ElementNodeTags;
+  std::map<std::string, GmshCore::InterpolationScheme> Schemes;
+  std::vector<std::string> Views;
+  std::vector<std::size_t> RecordTags;
+  std::vector<double> Values;
+};
+
+//----------------------------------------------------------------------------
+const GmshCore::Section* FindSection(
+  const std::vector<GmshCore::Section>& sections, const std::string& name)
+{
+  for (const GmshCore::Section& section : sections) {
+    if (section.Name == name) {
+      return &section;
+    }
+  }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+void TestIndexSections()
+{
+  std::istringstream stream(Mesh);
+  GmshCore::Tokenizer tokens(stream);
+  std::vector<GmshCore::Section> sections;
+  const GmshCore::IndexResult result = GmshCore::IndexSections(tokens,
+							       sections);
+  GMSH_CHECK(result.Status == GmshCore::IndexStatus::Complete);
+  GMSH_CHECK(result.Offset == static_cast<std::streamoff>(
+				std::string(Mesh).size()));
+  GMSH_CHECK(sections.size() == 5);
+  if (sections.size() != 5) {
+    return;
+  }
+
+  GMSH_CHECK(sections[0].Name == "MeshFormat" &&
+	     sections[0].FirstLine == "4.1 0 8");
+  GMSH_CHECK(sections[1].Name == "Nodes" && sections[1].Offset == 35);
+  GMSH_CHECK(sections[1].ContentOffset == 42);
+
+  const GmshCore::Section* view = FindSection(sections, "NodeData");
+  GMSH_CHECK(view && view->View.GetName() == "T" &&
+	     view->View.GetTime() == 0.5 &&
+	     view->View.GetNumberOfComponents() == 1 &&
+	     view->View.GetNumberOfEntities() == 4);
+
+  // Records are found again from their offset.
+  if (view) {
+    tokens.Seek(view->RecordsOffset);
+    std::size_t tag = 0;
+    double value = 0.0;
+    GMSH_CHECK(tokens.Read(tag) && tag == 1 && tokens.Read(value) &&
+	       value == 1.0);
+  }
+}
+
+//----------------------------------------------------------------------------
+// A file cut in the middle of a section, as written by a running solver,
+// is indexed up to that section, from which indexing can resume.
+void TestIndexIncomplete()
+{
+  const std::string text(Mesh);
+  const std::size_t ViewOffset = text.find("$NodeData");
+  const std::string cut = text.substr(0, text.find("3 3e0"));
+  std::istringstream stream(cut);
+  GmshCore::Tokenizer tokens(stream);
+  std::vector<GmshCore::Section> sections;
+  GmshCore::IndexResult result = GmshCore::IndexSections(tokens, sections);
+  GMSH_CHECK(result.Status == GmshCore::IndexStatus::Incomplete);
+  GMSH_CHECK(result.SectionName == "NodeData");
+  GMSH_CHECK(result.Offset == static_cast<std::streamoff>(ViewOffset));
+  GMSH_CHECK(sections.size() == 3);
+
+  // Completing the file lets indexing resume.
+  std::istringstream completed(text);
+  GmshCore::Tokenizer resumed(completed);
+  resumed.Seek(result.Offset);
+  result = GmshCore::IndexSections(resumed, sections);
+  GMSH_CHECK(result.Status == GmshCore::IndexStatus::Complete);
+  GMSH_CHECK(sections.size() == 5);
+}
+
+//----------------------------------------------------------------------------
+// A view with more records than announced misses its end marker.
+void TestIndexMalformed()
+{
+  std::string text(Mesh);
+  text.insert(text.find("$EndNodeData"), "5 5.0\n");
+  std::istringstream stream(text);
+  GmshCore::Tokenizer tokens(stream);
+  std::vector<GmshCore::Section> sections;
+  const GmshCore::IndexResult result = GmshCore::IndexSections(tokens,
+							       sections);
+  GMSH_CHECK(result.Status == GmshCore::IndexStatus::Malformed);
+  GMSH_CHECK(result.SectionName == "NodeData");
+}
+
+//----------------------------------------------------------------------------
+void TestReadNodes()
+{
+  const std::string text(Mesh);
+  std::istringstream stream(text);
+  GmshCore::Tokenizer tokens(stream);
+  tokens.Seek(static_cast<std::streamoff>(text.find("$Nodes") + 7));
+
+  Recorder recorder;
+  recorder.Parametric = true;
+  std::string error;
+  GMSH_CHECK(GmshCore::ReadNodes(tokens, recorder, error));
+  GMSH_CHECK(recorder.NodeEntities == std::vector<int>({ 1, 2 }));
+  GMSH_CHECK(recorder.NodeTags == std::vector<std::size_t>({ 1, 2, 3, 4 }));
+  GMSH_CHECK(recorder.Coordinates ==
+	     std::vector<double>({ 0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0 }));
+  GMSH_CHECK(recorder.ParametricCoordinates ==
+	     std::vector<double>({ 0.5, 0.5 }));
+
+  // Parametric coordinates are skipped unless asked for.
+  tokens.Seek(static_cast<std::streamoff>(text.find("$Nodes") + 7));
+  Recorder plain;
+  GMSH_CHECK(GmshCore::ReadNodes(tokens, plain, error));
+  GMSH_CHECK(plain.NodeTags.size() == 4 &&
+	     plain.ParametricCoordinates.empty());
+
+  // Blocks are read again one at a time from their headers.
+  tokens.Seek(static_cast<std::streamoff>(text.find("$Nodes") + 7));
+  GmshCore::BlockSectionHeader header;
+  std::vector<GmshCore::NodeBlockHeader> blocks;
+  GMSH_CHECK(GmshCore::ReadNodeBlockHeaders(tokens, header, blocks, error));
+  GMSH_CHECK(header.NumberOfBlocks == 2 && header.MaxTag == 4);
+  if (blocks.size() == 2) {
+    GMSH_CHECK(blocks[1].EntityDim == 2 && blocks[1].Parametric &&
+	       blocks[1].NumberOfNodes == 1);
+    Recorder single;
+    GMSH_CHECK(GmshCore::ReadNodeBlock(tokens, blocks[1], single, error));
+    GMSH_CHECK(single.NodeTags == std::vector<std::size_t>({ 4 }));
+    GMSH_CHECK(single.Coordinates == std::vector<double>({ 1, 1, 0 }));
+
+    // Blocks know the range of their tags, and the lines of the nodes
+    // that are not wanted are skipped, parametric coordinates included.
+    GMSH_CHECK(blocks[0].MinTag == 1 && blocks[0].MaxTag == 3);
+    GMSH_CHECK(blocks[1].MinTag == 4 && blocks[1].MaxTag == 4);
+    Recorder subset;
+    subset.Parametric = true;
+    const std::vector<std::size_t> wanted = { 1, 3, 4 };
+    GMSH_CHECK(
+      GmshCore::ReadNodeBlock(tokens, blocks[0], wanted, subset, error));
+    GMSH_CHECK(
+      GmshCore::ReadNodeBlock(tokens, blocks[1], wanted, subset, error));
+    GMSH_CHECK(subset.NodeTags == std::vector<std::size_t>({ 1, 3, 4 }));
+    GMSH_CHECK(subset.Coordinates ==
+	       std::vector<double>({ 0, 0, 0, 0, 1, 0, 1, 1, 0 }));
+    GMSH_CHECK(subset.ParametricCoordinates ==
+	       std::vector<double>({ 0.5, 0.5 }));
+  } else {
+    GMSH_CHECK(blocks.size() == 2);
+  }
+}
+
+//----------------------------------------------------------------------------
+void TestReadElements()
+{
+  const std::string text(Mesh);
+  const std::streamoff content =
+    static_cast<std::streamoff>(text.find("$Elements") + 10);
+  std::istringstream stream(text);
+  GmshCore::Tokenizer tokens(stream);
+  tokens.Seek(content);
+
+  Recorder recorder;
+  std::string error;
+  GMSH_CHECK(GmshCore::ReadElements(tokens, recorder, error));
+  GMSH_CHECK(recorder.ElementTypes == std::vector<int>({ 2 }));
+  GMSH_CHECK(recorder.ElementTags == std::vector<std::size_t>({ 1, 2 }));
+  GMSH_CHECK(recorder.ElementNodeTags ==
+	     std::vector<std::size_t>({ 1, 2, 3, 2, 4, 3 }));
+
+  // A range of a block is read from its header.
+  tokens.Seek(content);
+  GmshCore::BlockSectionHeader header;
+  std::vector<GmshCore::ElementBlockHeader> blocks;
+  GMSH_CHECK(
+    GmshCore::ReadElementBlockHeaders(tokens, header, blocks, error));
+  if (blocks.size() == 1) {
+    GMSH_CHECK(blocks[0].NumberOfElements == 2 && blocks[0].Type->Type == 2);
+    Recorder range;
+    GMSH_CHECK(
+      GmshCore::ReadElementBlock(tokens, blocks[0], 1, 1, range, error));
+    GMSH_CHECK(range.ElementTags == std::vector<std::size_t>({ 2 }));
+    GMSH_CHECK(range.ElementNodeTags == std::vector<std::size_t>({ 2, 4, 3 }));
+  } else {
+    GMSH_CHECK(blocks.size() == 1);
+  }
+
+  // Unknown types and truncated blocks are reported.
+  std::string unknown = text;
+  unknown.replace(unknown.find("2 1 2 2"), 7, "2 1 77 2");
+  std::istringstream UnknownStream(unknown);
+  GmshCore::Tokenizer UnknownTokens(UnknownStream);
+  UnknownTokens.Seek(content);
+  error.clear();
+  GMSH_CHECK(!GmshCore::ReadElements(UnknownTokens, recorder, error));
+  GMSH_CHECK(error == "Unknown element type 77.");
+
+  const std::string cut = text.substr(0, text.find("2 2 4 3") + 3);
+  std::istringstream CutStream(cut);
+  GmshCore::Tokenizer CutTokens(CutStream);
+  CutTokens.Seek(content);
+  error.clear();
+  GMSH_CHECK(!GmshCore::ReadElements(CutTokens, recorder, error));
+  GMSH_CHECK(!error.empty() && CutTokens.EndReached());
+}
+
+//----------------------------------------------------------------------------
+void TestParse()
+{
+  std::istringstream stream(Mesh);
+  GmshCore::Tokenizer tokens(stream);
+  Recorder recorder;
+  std::string error;
+  GMSH_CHECK(GmshCore::Parse(tokens, recorder, error));
+  GMSH_CHECK(recorder.NodeTags.size() == 4 &&
+	     recorder.ElementTags.size() == 2);
+  GMSH_CHECK(recorder.Views == std::vector<std::string>({ "T", "U" }));
+  GMSH_CHECK(recorder.Values ==
+	     std::vector<double>({ 1, 2, 3, -4, 1, 2, 3, 4, 5, 6 }));
+
+  std::string binary(Mesh);
+  binary.replace(binary.find("4.1 0 8"), 7, "4.1 1 8");
+  std::istringstream BinaryStream(binary);
+  GmshCore::Tokenizer BinaryTokens(BinaryStream);
+  GMSH_CHECK(!GmshCore::Parse(BinaryTokens, recorder, error));
+  GMSH_CHECK(error == "Binary files are not supported.");
+}
+
+//----------------------------------------------------------------------------
+// Records the handler does not want are skipped, element node records
+// included.
+void TestReadDataRecords()
+{
+  std::istringstream stream(Mesh);
+  GmshCore::Tokenizer tokens(stream);
+  Recorder recorder;
+  recorder.Wanted = { 2, 4 };
+  std::string error;
+  GMSH_CHECK(GmshCore::Parse(tokens, recorder, error));
+  GMSH_CHECK(recorder.RecordTags ==
+	     std::vector<std::size_t>({ 2, 4, 2 }));
+  GMSH_CHECK(recorder.Values == std::vector<double>({ 2, -4, 4, 5, 6 }));
+}
+
+//----------------------------------------------------------------------------
+// Interpolation schemes are read with their quoted name, and exponent
+// matrices of fewer than three columns are padded with zeros.
+void TestReadInterpolationScheme()
+{
+  const std::string text = "$InterpolationScheme\n"
+			   "\"P1\"\n"
+			   "1\n"
+			   "2 2\n"
+			   "2 2\n"
+			   "1 -1\n"
+			   "0 1\n"
+			   "2 1\n"
+			   "0\n"
+			   "1\n"
+			   "$EndInterpolationScheme\n";
+  std::istringstream stream(text);
+  GmshCore::Tokenizer tokens(stream);
+  Recorder recorder;
+  std::string error;
+  GMSH_CHECK(GmshCore::Parse(tokens, recorder, error));
+  GMSH_CHECK(recorder.Schemes.size() == 1 && recorder.Schemes.count("P1"));
+  const GmshCore::InterpolationScheme& scheme = recorder.Schemes["P1"];
+  GMSH_CHECK(scheme.size() == 1 && scheme.count(2));
+  if (scheme.count(2)) {
+    const GmshCore::InterpolationMatrices& matrices = scheme.at(2);
+    GMSH_CHECK(matrices.NumberOfBasisFunctions == 2 &&
+	       matrices.NumberOfMonomials == 2);
+    GMSH_CHECK(matrices.Coefficients ==
+	       std::vector<double>({ 1, -1, 0, 1 }));
+    GMSH_CHECK(matrices.Exponents ==
+	       std::vector<double>({ 0, 0, 0, 1, 0, 0 }));
+  }
+
+  // Coefficients must have a column per monomial.
+  std::string mismatched = text;
+  mismatched.replace(mismatched.find("2 1\n0\n1"), 3, "1 1");
+  std::istringstream MismatchedStream(mismatched);
+  GmshCore::Tokenizer MismatchedTokens(MismatchedStream);
+  error.clear();
+  GMSH_CHECK(!GmshCore::Parse(MismatchedTokens, recorder, error));
+  GMSH_CHECK(error == "Mismatched matrices in interpolation scheme \"P1\".");
+}
+
+//----------------------------------------------------------------------------
+// Records of a view long enough to be bisected are found by tag, a tag
+// missing from the view keeps its tuple, and records out of order are found
+// by the sequential scan.
+void TestProbeDataRecords()
+{
+  std::string records;
+  for (int tag = 1; tag <= 2000; ++tag) {
+    const int written = tag == 700 ? 1500 : tag == 1500 ? 700 : tag;
+    records += std::to_string(written) + " " + std::to_string(10 * written) +
+      " " + std::to_string(-written) + "\n";
+  }
+  const std::string text = "$NodeData\n" + records + "$EndNodeData\n";
+  const std::streamoff begin = text.find(records);
+  const std::streamoff end =
+    begin + static_cast<std::streamoff>(records.size());
+
+  std::istringstream stream(text);
+  GmshCore::Tokenizer tokens(stream, GmshCore::ProbeWindow);
+  const std::vector<std::size_t> tags = { 1, 2, 700, 999, 1500, 2000, 3000 };
+  std::vector<double> values(2 * tags.size(), -1.0);
+  GMSH_CHECK(GmshCore::ProbeDataRecords(tokens, begin, end, 2000, 2, tags,
+					values.data()));
+  for (std::size_t j = 0; j + 1 < tags.size(); ++j) {
+    const double tag = static_cast<double>(tags[j]);
+    GMSH_CHECK(values[2 * j] == 10.0 * tag && values[2 * j + 1] == -tag);
+  }
+  GMSH_CHECK(values[12] == -1.0 && values[13] == -1.0);
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestIndexSections();
+  TestIndexIncomplete();
+  TestIndexMalformed();
+  TestReadNodes();
+  TestReadElements();
+  TestParse();
+  TestReadDataRecords();
+  TestReadInterpolationScheme();
+  TestProbeDataRecords();
+  return GmshTesting::Result();
+}
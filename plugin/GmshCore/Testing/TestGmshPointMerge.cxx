@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshPointMerge.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshPointMerge.h"
+#include "GmshTesting.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Entries of the points of coordinates, sorted, of which the listed points
+// only if given.
+std::vector<GmshCore::MergeEntry> GetEntries(
+  const std::vector<double>& coordinates, double tolerance,
+  const std::vector<std::size_t>& points = std::vector<std::size_t>())
+{
+  std::vector<GmshCore::MergeEntry> entries;
+  for (std::size_t p = 0; p < coordinates.size() / 3; ++p) {
+    if (points.empty() ||
+	std::find(points.begin(), points.end(), p) != points.end()) {
+      entries.push_back(
+	{ GmshCore::GetMergeKey(coordinates.data() + 3 * p, tolerance), p });
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+  return entries;
+}
+
+//----------------------------------------------------------------------------
+// At a zero tolerance, points at the same place, -0 and 0 alike, are merged
+// into the first of them, whatever the ranges the entries are merged by.
+void TestEqual()
+{
+  const std::vector<double> coordinates = { 1, 2, 3, 0, 0, 0, 1, 2, 3,
+					    -0.0, 0, 0, 1, 2, 3.0000001 };
+  const auto entries = GetEntries(coordinates, 0.0);
+  std::vector<long long> target(5, -1);
+  GmshCore::MergeEqualPoints(entries, 0, 2, target);
+  GmshCore::MergeEqualPoints(entries, 2, entries.size(), target);
+  GMSH_CHECK(target == std::vector<long long>({ 0, 1, 0, 1, 4 }));
+}
+
+//----------------------------------------------------------------------------
+// Within a tolerance, points are merged into the representative of
+// smallest id close enough, across grid cells, and a chain of points each
+// close to the next is not merged whole.
+void TestNearby()
+{
+  const double tolerance = 0.1;
+  const std::vector<double> coordinates = {
+    0.0,  0, 0, // representative
+    0.08, 0, 0, // within the tolerance of 0
+    0.16, 0, 0, // within the tolerance of 1 only, a representative
+    0.24, 0, 0, // within the tolerance of 2
+    0.55, 0, 0, // unused
+    0.5,  0, 0, // alone
+    0.15, 0, 0  // within the tolerance of 2, and of 1 which is merged
+  };
+  const auto entries =
+    GetEntries(coordinates, tolerance, { 0, 1, 2, 3, 5, 6 });
+  std::vector<long long> target(7);
+  GmshCore::MergeNearbyPoints(entries, coordinates.data(), tolerance, target);
+  GMSH_CHECK(target == std::vector<long long>({ 0, 0, 2, 2, -1, 5, 2 }));
+
+  // Single precision coordinates merge alike.
+  std::vector<float> single(coordinates.begin(), coordinates.end());
+  std::vector<long long> SingleTarget(7);
+  GmshCore::MergeNearbyPoints(entries, single.data(), tolerance,
+			      SingleTarget);
+  GMSH_CHECK(SingleTarget == target);
+}
+
+//----------------------------------------------------------------------------
+// Points on either side of a grid cell boundary are found in the
+// neighboring cells, diagonal ones and those of negative coordinates
+// included.
+void TestNeighbors()
+{
+  const double tolerance = 0.1;
+  const std::vector<double> coordinates = { 0.99, 0.99, 0.99, 1.01,
+					    1.01, 1.01, -0.01, 0.5,
+					    0.5,  0.01, 0.5,   0.5 };
+  const auto entries = GetEntries(coordinates, tolerance);
+  std::vector<long long> target(4);
+  GmshCore::MergeNearbyPoints(entries, coordinates.data(), tolerance, target);
+  GMSH_CHECK(target == std::vector<long long>({ 0, 0, 2, 2 }));
+}
+
+//----------------------------------------------------------------------------
+// Merging by rounds over ranges of points gives the targets of the single
+// pass, whatever the order the ranges of a round are resolved in, and a
+// chain of close points across ranges takes several rounds.
+void TestRounds()
+{
+  const double tolerance = 0.1;
+  std::vector<double> coordinates;
+  for (int p = 0; p < 40; ++p) {
+    // A chain of points each close to the next, and pairs of coincident
+    // points far apart.
+    const double x = p < 20 ? 0.06 * p : 10.0 * (p / 2);
+    coordinates.insert(coordinates.end(), { x, 0.5, 0.5 });
+  }
+  const auto entries = GetEntries(coordinates, tolerance);
+  std::vector<long long> expected(40);
+  GmshCore::MergeNearbyPoints(entries, coordinates.data(), tolerance,
+			      expected);
+
+  std::vector<long long> target(40, -1);
+  for (const auto& entry : entries) {
+    target[entry.Point] = GmshCore::PendingTarget;
+  }
+  std::vector<long long> next(40);
+  const std::size_t range = 3;
+  int rounds = 0;
+  std::size_t pending = 0;
+  do {
+    pending = 0;
+    for (std::size_t first = 39 / range * range; first <= 39;
+	 first -= range) {
+      pending += GmshCore::ResolveNearbyPoints(
+	entries, coordinates.data(), tolerance, target, first,
+	std::min<std::size_t>(first + range, 40), next);
+    }
+    target.swap(next);
+    ++rounds;
+  } while (pending > 0 && rounds < 40);
+  GMSH_CHECK(target == expected);
+  GMSH_CHECK(rounds > 1);
+  GMSH_CHECK(expected[0] == 0 && expected[1] == 0 && expected[2] == 2 &&
+	     expected[19] == 18 && expected[21] == 20);
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestEqual();
+  TestNearby();
+  TestNeighbors();
+  TestRounds();
+  return GmshTesting::Result();
+}
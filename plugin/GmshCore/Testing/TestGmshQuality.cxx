@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshQuality.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshQuality.h"
+#include "GmshTesting.h"
+
+#include <cmath>
+
+namespace
+{
+//----------------------------------------------------------------------------
+bool Near(double a, double b)
+{
+  return std::abs(a - b) < 1e-12;
+}
+
+//----------------------------------------------------------------------------
+GmshCore::CellQuality Compute(int topology, const double (*corners)[3])
+{
+  const GmshCore::QualityKernel* kernel = GmshCore::GetQualityKernel(topology);
+  return kernel->Compute(corners);
+}
+
+//----------------------------------------------------------------------------
+// Ideal shapes have a scaled Jacobian and an aspect ratio of 1.
+void TestIdeal()
+{
+  const double h = std::sqrt(3.0) / 2;
+  const double triangle[3][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 0.5, h, 0 } };
+  GmshCore::CellQuality q = Compute(3, triangle);
+  GMSH_CHECK(Near(q.Size, h / 2));
+  GMSH_CHECK(Near(q.ScaledJacobian, 1.0));
+  GMSH_CHECK(Near(q.AspectRatio, 1.0));
+
+  const double square[4][3] = {
+    { 0, 0, 0 }, { 2, 0, 0 }, { 2, 2, 0 }, { 0, 2, 0 } };
+  q = Compute(4, square);
+  GMSH_CHECK(Near(q.Size, 4.0));
+  GMSH_CHECK(Near(q.ScaledJacobian, 1.0));
+  GMSH_CHECK(Near(q.AspectRatio, 1.0));
+
+  const double tetrahedron[4][3] = {
+    { 1, 1, 1 }, { 1, -1, -1 }, { -1, 1, -1 }, { -1, -1, 1 } };
+  q = Compute(5, tetrahedron);
+  GMSH_CHECK(Near(std::abs(q.Size), 8.0 / 3));
+  GMSH_CHECK(Near(std::abs(q.ScaledJacobian), 1.0));
+
+  const double cube[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 },
+			      { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 1 },
+			      { 1, 1, 1 }, { 0, 1, 1 } };
+  q = Compute(8, cube);
+  GMSH_CHECK(Near(q.Size, 1.0));
+  GMSH_CHECK(Near(q.ScaledJacobian, 1.0));
+  GMSH_CHECK(Near(q.AspectRatio, 1.0));
+
+  GMSH_CHECK(GmshCore::GetQualityKernel(6) == nullptr);
+  GMSH_CHECK(GmshCore::GetQualityKernel(2) == nullptr);
+}
+
+//----------------------------------------------------------------------------
+// Inverted cells have a negative size and scaled Jacobian, and degenerate
+// ones an infinite aspect ratio.
+void TestInvalid()
+{
+  const double tetrahedron[4][3] = {
+    { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+  const double inverted[4][3] = {
+    { 0, 0, 0 }, { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } };
+  const GmshCore::CellQuality q = Compute(5, tetrahedron);
+  const GmshCore::CellQuality r = Compute(5, inverted);
+  GMSH_CHECK(Near(q.Size, -r.Size));
+  GMSH_CHECK(q.ScaledJacobian * r.ScaledJacobian < 0.0);
+
+  const double flat[3][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 } };
+  const GmshCore::CellQuality s = Compute(3, flat);
+  GMSH_CHECK(s.Size == 0.0);
+  GMSH_CHECK(s.ScaledJacobian == 0.0);
+  GMSH_CHECK(std::isinf(s.AspectRatio));
+}
+
+//----------------------------------------------------------------------------
+// Statistics merged from several accumulators match those of one.
+void TestStatistics()
+{
+  GmshCore::QualityStatistics a, b;
+  a.Add({ 1.0, 0.5, 1.0 });
+  a.Add({ 3.0, 1.0, 2.0 });
+  b.Add({ 5.0, 0.0, 3.0 });
+  a.Merge(b);
+
+  GMSH_CHECK(a.NumberOfCells == 3);
+  GMSH_CHECK(a.Min[0] == 1.0 && a.Max[0] == 5.0);
+  GMSH_CHECK(a.Min[1] == 0.0 && a.Max[1] == 1.0);
+  GMSH_CHECK(Near(a.GetMean(0), 3.0));
+  GMSH_CHECK(Near(a.GetStandardDeviation(0), std::sqrt(8.0 / 3)));
+  GMSH_CHECK(Near(a.GetMean(2), 2.0));
+}
+}
+
+int main()
+{
+  TestIdeal();
+  TestInvalid();
+  TestStatistics();
+  return GmshTesting::Result();
+}
@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshReferenceElements.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshElementTypes.h"
+#include "GmshReferenceElements.h"
+#include "GmshTesting.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+bool Near(const std::vector<double>& a, const std::vector<double>& b)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (std::abs(a[i] - b[i]) > 1e-12) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Every type of the table has as many distinct nodes as it declares.
+void TestAllTypes()
+{
+  for (int type = 1; type < 256; ++type) {
+    const GmshCore::ElementType* element = GmshCore::GetElementType(type);
+    std::vector<double> uvw;
+    const bool found = GmshCore::GetReferenceNodes(type, uvw);
+    GMSH_CHECK(found == (element != nullptr));
+    if (!found) {
+      continue;
+    }
+
+    const std::size_t n = uvw.size() / 3;
+    GMSH_CHECK(static_cast<int>(n) == element->NumberOfNodes);
+    bool distinct = true;
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < i; ++j) {
+	distinct = distinct &&
+	  !Near({ uvw[3 * i], uvw[3 * i + 1], uvw[3 * i + 2] },
+		{ uvw[3 * j], uvw[3 * j + 1], uvw[3 * j + 2] });
+      }
+    }
+    if (!GMSH_CHECK(distinct)) {
+      std::cerr << "  type " << type << "\n";
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void TestLowOrder()
+{
+  std::vector<double> uvw;
+  GMSH_CHECK(GmshCore::GetReferenceNodes(9, uvw));
+  GMSH_CHECK(Near(uvw, { 0, 0, 0, 1, 0, 0, 0, 1, 0, 0.5, 0, 0, 0.5, 0.5, 0,
+			 0, 0.5, 0 }));
+
+  GMSH_CHECK(GmshCore::GetReferenceNodes(16, uvw));
+  GMSH_CHECK(Near(uvw, { -1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, 0, 0, -1, 0,
+			 1, 0, 0, 0, 1, 0, -1, 0, 0 }));
+
+  // Hexahedron 27: edge midpoints, then face centers, then the center.
+  GMSH_CHECK(GmshCore::GetReferenceNodes(12, uvw) && uvw.size() == 81);
+  GMSH_CHECK(Near({ uvw.begin() + 24, uvw.begin() + 30 },
+		  { 0, -1, -1, -1, 0, -1 }));
+  GMSH_CHECK(Near({ uvw.begin() + 60, uvw.begin() + 66 },
+		  { 0, 0, -1, 0, -1, 0 }));
+  GMSH_CHECK(Near({ uvw.begin() + 78, uvw.end() }, { 0, 0, 0 }));
+
+  // Prism 18: the centers of the quadrangular faces close the list.
+  GMSH_CHECK(GmshCore::GetReferenceNodes(13, uvw) && uvw.size() == 54);
+  GMSH_CHECK(Near({ uvw.begin() + 45, uvw.end() },
+		  { 0.5, 0, 0, 0, 0.5, 0, 0.5, 0.5, 0 }));
+
+  GMSH_CHECK(GmshCore::GetReferenceNodes(14, uvw) && uvw.size() == 42);
+  GMSH_CHECK(Near({ uvw.begin() + 21, uvw.begin() + 24 }, { -0.5, -0.5, 0.5 }));
+  GMSH_CHECK(Near({ uvw.begin() + 39, uvw.end() }, { 0, 0, 0 }));
+}
+
+//----------------------------------------------------------------------------
+void TestHighOrder()
+{
+  const double t = 1.0 / 3.0;
+  std::vector<double> uvw;
+
+  // Line 4: corners, then the inner nodes from the first corner.
+  GMSH_CHECK(GmshCore::GetReferenceNodes(26, uvw));
+  GMSH_CHECK(Near(uvw, { -1, 0, 0, 1, 0, 0, -t, 0, 0, t, 0, 0 }));
+
+  // Triangle 10 and its incomplete counterpart, Triangle 9.
+  const std::vector<double> triangle = { 0, 0, 0, 1, 0, 0, 0, 1, 0,
+					 t, 0, 0, 2 * t, 0, 0,
+					 2 * t, t, 0, t, 2 * t, 0,
+					 0, 2 * t, 0, 0, t, 0 };
+  GMSH_CHECK(GmshCore::GetReferenceNodes(20, uvw) && Near(uvw, triangle));
+  std::vector<double> complete = triangle;
+  complete.insert(complete.end(), { t, t, 0 });
+  GMSH_CHECK(GmshCore::GetReferenceNodes(21, uvw) && Near(uvw, complete));
+
+  // Tetrahedron 20: a node inside each face, in the orientation of
+  // gmsh faces v0-v2-v1, v0-v1-v3, v0-v3-v2 and v3-v1-v2.
+  GMSH_CHECK(GmshCore::GetReferenceNodes(29, uvw) && uvw.size() == 60);
+  GMSH_CHECK(Near({ uvw.begin() + 48, uvw.end() },
+		  { t, t, 0, t, 0, t, 0, t, t, t, t, t }));
+
+  // Tetrahedron 35: nine nodes inside each face, then one in the middle.
+  GMSH_CHECK(GmshCore::GetReferenceNodes(30, uvw) && uvw.size() == 105);
+  GMSH_CHECK(Near({ uvw.begin() + 102, uvw.end() }, { 0.25, 0.25, 0.25 }));
+  GMSH_CHECK(Near({ uvw.begin() + 66, uvw.begin() + 75 },
+		  { 0.25, 0.25, 0, 0.25, 0.5, 0, 0.5, 0.25, 0 }));
+
+  // Hexahedron 64: edge 2-6 runs from corner 2, the first face node is
+  // next to corner 0 on face 0-3-2-1, and the inner nodes form a
+  // hexahedron of their own.
+  GMSH_CHECK(GmshCore::GetReferenceNodes(92, uvw) && uvw.size() == 192);
+  GMSH_CHECK(Near({ uvw.begin() + 60, uvw.begin() + 66 },
+		  { 1, 1, -t, 1, 1, t }));
+  GMSH_CHECK(Near({ uvw.begin() + 96, uvw.begin() + 102 },
+		  { -t, -t, -1, -t, t, -1 }));
+  GMSH_CHECK(Near({ uvw.begin() + 168, uvw.begin() + 174 },
+		  { -t, -t, -t, t, -t, -t }));
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestAllTypes();
+  TestLowOrder();
+  TestHighOrder();
+  return GmshTesting::Result();
+}
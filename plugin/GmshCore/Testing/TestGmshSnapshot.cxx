@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshSnapshot.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshSnapshot.h"
+#include "GmshTesting.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t PageSize = 256;
+
+const double Points[] = { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+const unsigned char Types[] = { 5 };
+
+//----------------------------------------------------------------------------
+// Writer of a snapshot with two sections.
+GmshCore::SnapshotWriter GetWriter()
+{
+  GmshCore::SnapshotWriter writer(PageSize);
+  writer.AddSection("Points", Points, 9, sizeof(double), 3);
+  writer.AddSection("CellTypes", Types, 1, 1);
+  return writer;
+}
+
+//----------------------------------------------------------------------------
+// Sections start on distinct pages and the snapshot reads back.
+void TestLayout()
+{
+  const GmshCore::SnapshotWriter writer = GetWriter();
+  const GmshCore::SnapshotStamp stamp{ 1234, 5678 };
+  std::vector<char> buffer(writer.GetSize());
+  writer.Write(buffer.data(), stamp);
+
+  std::vector<GmshCore::SnapshotSection> sections;
+  GMSH_CHECK(!GmshCore::ReadSnapshot(buffer.data(), buffer.size(), stamp,
+				     sections));
+
+  GmshCore::SnapshotWriter::Publish(buffer.data());
+  GMSH_CHECK(GmshCore::ReadSnapshot(buffer.data(), buffer.size(), stamp,
+				    sections));
+  if (!GMSH_CHECK(sections.size() == 2)) {
+    return;
+  }
+
+  GMSH_CHECK(std::string(sections[0].Name) == "Points");
+  GMSH_CHECK(sections[0].Offset == PageSize);
+  GMSH_CHECK(sections[0].NumberOfValues == 9);
+  GMSH_CHECK(sections[0].NumberOfComponents == 3);
+  GMSH_CHECK(std::memcmp(buffer.data() + sections[0].Offset, Points,
+			 sizeof(Points)) == 0);
+  GMSH_CHECK(std::string(sections[1].Name) == "CellTypes");
+  GMSH_CHECK(sections[1].Offset == 2 * PageSize);
+  GMSH_CHECK(buffer[sections[1].Offset] == 5);
+  GMSH_CHECK(writer.GetSize() == 2 * PageSize + 1);
+}
+
+//----------------------------------------------------------------------------
+// Snapshots of another file, with a damaged table or truncated are
+// rejected.
+void TestRejected()
+{
+  const GmshCore::SnapshotWriter writer = GetWriter();
+  const GmshCore::SnapshotStamp stamp{ 1234, 5678 };
+  std::vector<char> buffer(writer.GetSize());
+  writer.Write(buffer.data(), stamp);
+  GmshCore::SnapshotWriter::Publish(buffer.data());
+
+  std::vector<GmshCore::SnapshotSection> sections;
+  GMSH_CHECK(!GmshCore::ReadSnapshot(buffer.data(), buffer.size(),
+				     GmshCore::SnapshotStamp{ 1234, 5679 },
+				     sections));
+  GMSH_CHECK(!GmshCore::ReadSnapshot(buffer.data(), buffer.size() - 1, stamp,
+				     sections));
+  GMSH_CHECK(!GmshCore::ReadSnapshot(buffer.data(), 16, stamp, sections));
+
+  // The section table starts right after the header.
+  std::vector<char> damaged = buffer;
+  for (std::size_t i = 0; i < PageSize; ++i) {
+    if (std::string(damaged.data() + i) == "CellTypes") {
+      damaged[i] = 'c';
+    }
+  }
+  GMSH_CHECK(damaged != buffer);
+  GMSH_CHECK(!GmshCore::ReadSnapshot(damaged.data(), damaged.size(), stamp,
+				     sections));
+}
+}
+
+int main()
+{
+  TestLayout();
+  TestRejected();
+  return GmshTesting::Result();
+}
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGmshTokenizer.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "GmshTesting.h"
+#include "GmshTokenizer.h"
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+//----------------------------------------------------------------------------
+void TestNumbers()
+{
+  std::istringstream stream("1 -2\t+3\n4.5e1 -0.25\r\n18446744073709551615");
+  GmshCore::Tokenizer tokens(stream);
+
+  int i = 0;
+  long long l = 0;
+  std::size_t u = 0;
+  double d = 0.0;
+  GMSH_CHECK(tokens.Read(i) && i == 1);
+  GMSH_CHECK(tokens.Read(l) && l == -2);
+  GMSH_CHECK(tokens.Read(u) && u == 3);
+  GMSH_CHECK(tokens.Read(d) && d == 45.0);
+  GMSH_CHECK(tokens.Read(d) && d == -0.25);
+  GMSH_CHECK(tokens.Read(u) && u == 18446744073709551615u);
+  GMSH_CHECK(!tokens.Fail());
+
+  // Reading past the end fails as a truncated stream.
+  GMSH_CHECK(!tokens.Read(i));
+  GMSH_CHECK(tokens.Fail() && tokens.EndReached());
+}
+
+//----------------------------------------------------------------------------
+void TestMalformed()
+{
+  std::istringstream stream("12x 7\n-3 8");
+  GmshCore::Tokenizer tokens(stream);
+
+  int i = 0;
+  GMSH_CHECK(!tokens.Read(i));
+  GMSH_CHECK(tokens.Fail() && !tokens.EndReached());
+
+  // The failed state sticks until the next Seek.
+  GMSH_CHECK(!tokens.Skip());
+  tokens.Seek(4);
+  GMSH_CHECK(tokens.Read(i) && i == 7);
+
+  std::size_t u = 0;
+  GMSH_CHECK(!tokens.Read(u));
+  tokens.Seek(6);
+  GMSH_CHECK(tokens.Skip(1) && tokens.Read(i) && i == 8);
+}
+
+//----------------------------------------------------------------------------
+// A number at the end of a stream still being written is returned, but
+// the tokenizer remembers that it may have been cut.
+void TestTruncated()
+{
+  std::istringstream stream("1 2\n3 4");
+  GmshCore::Tokenizer tokens(stream);
+
+  int i = 0;
+  GMSH_CHECK(tokens.Skip(3) && tokens.Read(i) && i == 4);
+  GMSH_CHECK(!tokens.Read(i) && tokens.EndReached());
+
+  std::istringstream empty("");
+  GmshCore::Tokenizer NoTokens(empty);
+  GMSH_CHECK(!NoTokens.Skip() && NoTokens.EndReached());
+}
+
+//----------------------------------------------------------------------------
+void TestLines()
+{
+  std::istringstream stream("first line\r\n\nthird 3\nunterminated");
+  GmshCore::Tokenizer tokens(stream);
+
+  std::string line;
+  GMSH_CHECK(tokens.ReadLine(line) && line == "first line");
+  GMSH_CHECK(tokens.ReadLine(line) && line.empty());
+
+  int i = 0;
+  GMSH_CHECK(tokens.Skip() && tokens.Read(i) && i == 3);
+  GMSH_CHECK(tokens.SkipLine());
+  const std::streamoff LastLine = tokens.Tell();
+
+  // The last line is only returned when unterminated lines are accepted,
+  // and is left unread otherwise.
+  GMSH_CHECK(!tokens.ReadLine(line));
+  GMSH_CHECK(!tokens.SkipLine());
+  GMSH_CHECK(tokens.Tell() == LastLine);
+  GMSH_CHECK(tokens.ReadLine(line, true) && line == "unterminated");
+  GMSH_CHECK(!tokens.ReadLine(line, true));
+}
+
+//----------------------------------------------------------------------------
+// Tokens and lines longer than the buffer make it grow.
+void TestSmallBuffer()
+{
+  std::istringstream stream("123456789 -987654321.5\n"
+			    "a line much longer than the buffer\n42");
+  GmshCore::Tokenizer tokens(stream, 4);
+
+  long long l = 0;
+  double d = 0.0;
+  GMSH_CHECK(tokens.Read(l) && l == 123456789);
+  GMSH_CHECK(tokens.Read(d) && d == -987654321.5);
+  GMSH_CHECK(tokens.Tell() == 22);
+
+  std::string line;
+  GMSH_CHECK(tokens.SkipLine());
+  GMSH_CHECK(tokens.ReadLine(line) &&
+	     line == "a line much longer than the buffer");
+
+  int i = 0;
+  GMSH_CHECK(tokens.Read(i) && i == 42);
+}
+
+//----------------------------------------------------------------------------
+void TestSeek()
+{
+  std::istringstream stream("10 20 30\n40");
+  GmshCore::Tokenizer tokens(stream);
+
+  int i = 0;
+  GMSH_CHECK(tokens.Read(i) && tokens.Tell() == 2);
+  tokens.Seek(6);
+  GMSH_CHECK(tokens.Read(i) && i == 30);
+  tokens.Seek(0);
+  GMSH_CHECK(tokens.Read(i) && i == 10);
+  tokens.Seek(9);
+  std::string line;
+  GMSH_CHECK(tokens.ReadLine(line, true) && line == "40");
+}
+}
+
+//----------------------------------------------------------------------------
+int main()
+{
+  TestNumbers();
+  TestMalformed();
+  TestTruncated();
+  TestLines();
+  TestSmallBuffer();
+  TestSeek();
+  return GmshTesting::Result();
+}
@@ -14,19 +14,2687 @@
 =========================================================================*/
 #include "vtkGmshReader.h"
 
+#include "GmshBlockCache.h"
+#include "GmshCellOrder.h"
+#include "GmshFileStream.h"
+#include "GmshLinearization.h"
+#include "GmshLoadPlan.h"
+#include "GmshMeshKey.h"
+#include "GmshParser.h"
+#include "GmshPointMerge.h"
+#include "GmshQuality.h"
+#include "GmshReferenceElements.h"
+#include "GmshSnapshot.h"
+#include "GmshTrace.h"
+
+#include <vtkDataArraySelection.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
+#include <vtkIntArray.h>
 #include <vtkObjectFactory.h>
+#include <vtkPartitionedDataSet.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStaticCellLinks.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkTable.h>
+#include <vtkTypeInt32Array.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkCellType.h>
 
-#include <string>
-#include <vector>
-#include <fstream>
-#include <limits>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Header of a $NodeData, $ElementData or $ElementNodeData section, along
+// with the position of its first value record in the file and that of the
+// next section.
+struct DataView
+{
+  GmshCore::DataKind Kind = GmshCore::DataKind::Node;
+  std::string Name;
+  double Time = 0.0;
+  int TimeStep = 0;
+  int NumberOfComponents = 1;
+  std::size_t NumberOfEntities = 0;
+  std::streamoff Offset = 0;
+  std::streamoff EndOffset = 0;
+  std::string InterpolationScheme;
+};
+
+//----------------------------------------------------------------------------
+// Mesh arrays, as parsed from the $Nodes and $Elements sections or attached
+// from a cache.
+// Points are double arrays, and offsets and connectivity vtkIdTypeArrays,
+// unless the memory budget reads them as float and 32-bit arrays.
+struct MeshArrays
+{
+  vtkSmartPointer<vtkDataArray> Points;
+  vtkSmartPointer<vtkDataArray> Offsets;
+  vtkSmartPointer<vtkDataArray> Connectivity;
+  vtkSmartPointer<vtkUnsignedCharArray> CellTypes;
+  // Gmsh element type of each cell.
+  vtkSmartPointer<vtkUnsignedCharArray> ElementTypes;
+  // Cell id of each element tag, starting from MinElementTag.
+  vtkSmartPointer<vtkIdTypeArray> CellIds;
+  vtkIdType MinElementTag = 0;
+  // Parametric coordinates of each point, NaN where the file gives none.
+  // Only read on request, and not kept by the caches.
+  vtkSmartPointer<vtkDoubleArray> Parametric;
+  // Whether the mesh is a piece of the file mesh or its selected entities,
+  // whose points are then its nodes in increasing NodeTags order rather
+  // than indexed by tag.
+  bool Piece = false;
+  std::vector<std::size_t> NodeTags;
+  // Cell ranges of each dimension and entity, when the cells are sorted by
+  // entity. Sorted meshes are not kept by the caches either.
+  vtkSmartPointer<vtkIdTypeArray> DimensionRanges;
+  vtkSmartPointer<vtkIdTypeArray> EntityRanges;
+};
+
+//----------------------------------------------------------------------------
+// Call functor with the values of an array of point coordinates, which
+// are stored in single or double precision.
+template <typename Functor>
+void VisitCoordinates(vtkDataArray* coordinates, Functor&& functor)
+{
+  if (vtkDoubleArray* values = vtkDoubleArray::SafeDownCast(coordinates)) {
+    functor(values->GetPointer(0));
+  } else if (vtkFloatArray* values = vtkFloatArray::SafeDownCast(coordinates)) {
+    functor(values->GetPointer(0));
+  }
+}
+
+//----------------------------------------------------------------------------
+// Call functor with an array of cell offsets or point ids, which is a
+// vtkIdTypeArray or a 32-bit array.
+template <typename Functor>
+void VisitIds(vtkDataArray* ids, Functor&& functor)
+{
+  if (vtkIdTypeArray* values = vtkIdTypeArray::SafeDownCast(ids)) {
+    functor(values);
+  } else if (vtkTypeInt32Array* values =
+	       vtkTypeInt32Array::SafeDownCast(ids)) {
+    functor(values);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Call functor with the offsets and the connectivity arrays of cells,
+// which have the same type.
+template <typename Functor>
+void VisitCellArrays(vtkDataArray* offsets, vtkDataArray* connectivity,
+		     Functor&& functor)
+{
+  VisitIds(offsets, [&](auto* OffsetArray) {
+    using ArrayType = std::remove_pointer_t<decltype(OffsetArray)>;
+    if (ArrayType* ConnectivityArray = ArrayType::SafeDownCast(connectivity)) {
+      functor(OffsetArray, ConnectivityArray);
+    }
+  });
+}
+
+//----------------------------------------------------------------------------
+// Call functor with the values of the offsets and the connectivity of
+// cells.
+template <typename Functor>
+void VisitCells(vtkDataArray* offsets, vtkDataArray* connectivity,
+		Functor&& functor)
+{
+  VisitCellArrays(offsets, connectivity,
+		  [&](auto* OffsetArray, auto* ConnectivityArray) {
+		    functor(OffsetArray->GetPointer(0),
+			    ConnectivityArray->GetPointer(0));
+		  });
+}
+
+//----------------------------------------------------------------------------
+// Whether an array of cell offsets or point ids is a 32-bit one.
+bool IsNarrow(vtkDataArray* ids)
+{
+  return vtkTypeInt32Array::SafeDownCast(ids) != nullptr;
+}
+
+//----------------------------------------------------------------------------
+// New array of cell offsets or point ids, a 32-bit one if narrow.
+vtkSmartPointer<vtkDataArray> NewIdArray(bool narrow)
+{
+  if (narrow) {
+    return vtkSmartPointer<vtkTypeInt32Array>::New();
+  }
+  return vtkSmartPointer<vtkIdTypeArray>::New();
+}
+
+//----------------------------------------------------------------------------
+// Placement of the pages of large output arrays.
+struct MemoryPolicy
+{
+  // Touch the pages of each array from the vtkSMPTools threads that will
+  // process them, so that they are spread over the NUMA nodes.
+  bool ParallelFirstTouch = false;
+  // Back large arrays with transparent huge pages.
+  bool HugePages = false;
+};
+
+// Arrays smaller than this are left on regular pages.
+constexpr std::size_t HugePageThreshold = std::size_t(64) << 20;
+
+//----------------------------------------------------------------------------
+void AdviseHugePages(void* data, std::size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+  if (size < HugePageThreshold) {
+    return;
+  }
+
+  // madvise needs page aligned ranges; the partial pages at both ends of
+  // the allocation are left alone.
+  const std::uintptr_t PageSize =
+    static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+  const std::uintptr_t first = (reinterpret_cast<std::uintptr_t>(data) +
+				PageSize - 1) & ~(PageSize - 1);
+  const std::uintptr_t last =
+    (reinterpret_cast<std::uintptr_t>(data) + size) & ~(PageSize - 1);
+  if (last > first) {
+    madvise(reinterpret_cast<void*>(first), last - first, MADV_HUGEPAGE);
+  }
+#else
+  (void)data;
+  (void)size;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Prepare an array that was just sized and is about to be written: its
+// untouched pages are faulted in in parallel, with the partitioning of
+// vtkSMPTools::For over its values.
+template <typename ArrayType>
+void TouchArray(ArrayType* array, const MemoryPolicy& policy)
+{
+  using ValueType = typename ArrayType::ValueType;
+  ValueType* data = array->GetPointer(0);
+  const vtkIdType NumberOfValues = array->GetNumberOfValues();
+
+  if (policy.HugePages) {
+    AdviseHugePages(data, NumberOfValues * sizeof(ValueType));
+  }
+
+  if (policy.ParallelFirstTouch) {
+    vtkSMPTools::For(0, NumberOfValues,
+		     [data](vtkIdType begin, vtkIdType end) {
+		       std::fill(data + begin, data + end, ValueType());
+		     });
+  }
+}
+
+#ifndef _WIN32
+//----------------------------------------------------------------------------
+bool GetSourceStamp(const char* FileName, GmshCore::SnapshotStamp& stamp)
+{
+  struct stat info;
+  if (stat(FileName, &info) != 0) {
+    return false;
+  }
+  stamp.Size = static_cast<std::uint64_t>(info.st_size);
+  stamp.ModificationTime = static_cast<std::int64_t>(info.st_mtime);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Sections of a snapshot of mesh, in file order.
+GmshCore::SnapshotWriter GetSnapshotWriter(const MeshArrays& mesh)
+{
+  GmshCore::SnapshotWriter writer(static_cast<std::size_t>(getpagesize()));
+  auto AddSection = [&writer](const char* name, vtkDataArray* array) {
+    writer.AddSection(name, array->GetVoidPointer(0),
+		      array->GetNumberOfValues(),
+		      static_cast<std::uint32_t>(array->GetDataTypeSize()),
+		      array->GetNumberOfComponents());
+  };
+
+  AddSection("Points", mesh.Points);
+  AddSection("Offsets", mesh.Offsets);
+  AddSection("Connectivity", mesh.Connectivity);
+  AddSection("CellTypes", mesh.CellTypes);
+  AddSection("ElementTypes", mesh.ElementTypes);
+  AddSection("CellIds", mesh.CellIds);
+  writer.AddSection("MinElementTag", &mesh.MinElementTag, 1,
+		    sizeof(vtkIdType));
+  return writer;
+}
+
+//----------------------------------------------------------------------------
+// Write a snapshot to a shared writable mapping of GetSize bytes, and
+// publish it once its contents are flushed to the mapped object.
+bool WriteSnapshot(char* base, const GmshCore::SnapshotWriter& writer,
+		   const GmshCore::SnapshotStamp& stamp)
+{
+  writer.Write(base, stamp);
+  if (msync(base, writer.GetSize(), MS_SYNC) != 0) {
+    return false;
+  }
+  GmshCore::SnapshotWriter::Publish(base);
+  return msync(base, writer.GetSize(), MS_SYNC) == 0;
+}
+
+//----------------------------------------------------------------------------
+// Private mappings backing arrays that wrap snapshot sections. Each
+// section registers the mapping it lives in; the mapping is released with
+// the last array that wraps one of its sections.
+struct MappedRegion
+{
+  void* Address;
+  std::size_t Size;
+
+  ~MappedRegion() { munmap(this->Address, this->Size); }
+};
+
+std::mutex& GetMappedSectionsMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<const void*, std::shared_ptr<MappedRegion>>& GetMappedSections()
+{
+  static std::map<const void*, std::shared_ptr<MappedRegion>> sections;
+  return sections;
+}
+
+void ReleaseMappedSection(void* data)
+{
+  std::shared_ptr<MappedRegion> region;
+  std::lock_guard<std::mutex> lock(GetMappedSectionsMutex());
+  auto it = GetMappedSections().find(data);
+  if (it != GetMappedSections().end()) {
+    region = std::move(it->second);
+    GetMappedSections().erase(it);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename ArrayType>
+vtkSmartPointer<ArrayType> WrapSection(
+  const std::shared_ptr<MappedRegion>& region,
+  const GmshCore::SnapshotSection& section)
+{
+  using ValueType = typename std::remove_pointer<
+    decltype(std::declval<ArrayType>().GetPointer(0))>::type;
+
+  if (section.ValueSize != sizeof(ValueType)) {
+    return nullptr;
+  }
+  ValueType* data = reinterpret_cast<ValueType*>(
+    static_cast<char*>(region->Address) + section.Offset);
+
+  {
+    std::lock_guard<std::mutex> lock(GetMappedSectionsMutex());
+    GetMappedSections()[data] = region;
+  }
+
+  auto array = vtkSmartPointer<ArrayType>::New();
+  array->SetNumberOfComponents(static_cast<int>(section.NumberOfComponents));
+  array->SetArray(data, static_cast<vtkIdType>(section.NumberOfValues), 0,
+		  ArrayType::VTK_DATA_ARRAY_USER_DEFINED);
+  array->SetArrayFreeFunction(&ReleaseMappedSection);
+  return array;
+}
+
+//----------------------------------------------------------------------------
+// Map the snapshot held by fd and wrap its sections as the arrays of mesh,
+// without copying. The mapping is private and writable, so that consumers
+// writing to the arrays get their own copy of the pages they touch instead
+// of a fault or a change to the shared snapshot. Fails if the snapshot is
+// incomplete or was not made from a file with the given stamp.
+bool MapSnapshot(int fd, const GmshCore::SnapshotStamp& stamp,
+		 MeshArrays& mesh)
+{
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    return false;
+  }
+
+  const std::size_t size = static_cast<std::size_t>(info.st_size);
+  void* address =
+    mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (address == MAP_FAILED) {
+    return false;
+  }
+  auto region = std::make_shared<MappedRegion>(MappedRegion{ address, size });
+
+  const char* base = static_cast<const char*>(address);
+  std::vector<GmshCore::SnapshotSection> sections;
+  if (!GmshCore::ReadSnapshot(base, size, stamp, sections)) {
+    return false;
+  }
+
+  MeshArrays mapped;
+  for (const GmshCore::SnapshotSection& section : sections) {
+    const std::string name(section.Name);
+    if (name == "Points") {
+      mapped.Points = WrapSection<vtkDoubleArray>(region, section);
+    } else if (name == "Offsets") {
+      mapped.Offsets = WrapSection<vtkIdTypeArray>(region, section);
+    } else if (name == "Connectivity") {
+      mapped.Connectivity = WrapSection<vtkIdTypeArray>(region, section);
+    } else if (name == "CellTypes") {
+      mapped.CellTypes = WrapSection<vtkUnsignedCharArray>(region, section);
+    } else if (name == "ElementTypes") {
+      mapped.ElementTypes = WrapSection<vtkUnsignedCharArray>(region, section);
+    } else if (name == "CellIds") {
+      mapped.CellIds = WrapSection<vtkIdTypeArray>(region, section);
+    } else if (name == "MinElementTag" &&
+	       section.ValueSize == sizeof(vtkIdType)) {
+      std::memcpy(&mapped.MinElementTag, base + section.Offset,
+		  sizeof(vtkIdType));
+    }
+  }
+
+  if (!mapped.Points || !mapped.Offsets || !mapped.Connectivity ||
+      !mapped.CellTypes || !mapped.ElementTypes || !mapped.CellIds) {
+    return false;
+  }
+
+  mesh = mapped;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Name of the shared memory segment caching the mesh of a file, keyed by
+// its path, size and modification time. Empty if the file cannot be
+// stat'ed.
+std::string GetSharedMemoryName(const char* FileName)
+{
+  GmshCore::SnapshotStamp stamp;
+  char* path = realpath(FileName, nullptr);
+  if (!path || !GetSourceStamp(path, stamp)) {
+    free(path);
+    return std::string();
+  }
+
+  std::ostringstream name;
+  name << "/vtkGmshReader-" << std::hex << std::hash<std::string>()(path)
+       << "-" << stamp.Size << "-" << stamp.ModificationTime;
+  free(path);
+  return name.str();
+}
+
+//----------------------------------------------------------------------------
+bool AttachSharedMesh(const char* FileName, const std::string& name,
+		      MeshArrays& mesh)
+{
+  GmshCore::SnapshotStamp stamp;
+  if (!GetSourceStamp(FileName, stamp)) {
+    return false;
+  }
+
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return false;
+  }
+  const bool attached = MapSnapshot(fd, stamp, mesh);
+  close(fd);
+  return attached;
+}
+
+//----------------------------------------------------------------------------
+// Remove the segments caching earlier versions of the file of a segment,
+// named after the same path but another size or modification time, so
+// that editing the file does not leave them in memory until reboot. They
+// are listed from /dev/shm, where Linux keeps them, and left elsewhere.
+// Processes that mapped them keep their mapping.
+void UnlinkStaleSharedMeshes(const std::string& name)
+{
+  const std::string prefix =
+    name.substr(0, name.find('-', std::strlen("/vtkGmshReader-")) + 1);
+  DIR* directory = opendir("/dev/shm");
+  if (!directory) {
+    return;
+  }
+  while (const dirent* entry = readdir(directory)) {
+    const std::string other = std::string("/") + entry->d_name;
+    if (other != name && other.compare(0, prefix.size(), prefix) == 0) {
+      shm_unlink(other.c_str());
+    }
+  }
+  closedir(directory);
+}
+
+//----------------------------------------------------------------------------
+// Copy mesh into a new shared memory segment, removing those of earlier
+// versions of the file. Succeeds without doing anything if another process
+// created the segment first.
+bool PublishSharedMesh(const char* FileName, const std::string& name,
+		       const MeshArrays& mesh)
+{
+  GmshCore::SnapshotStamp stamp;
+  if (!GetSourceStamp(FileName, stamp)) {
+    return false;
+  }
+  UnlinkStaleSharedMeshes(name);
+
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    return errno == EEXIST;
+  }
+
+  const GmshCore::SnapshotWriter writer = GetSnapshotWriter(mesh);
+  const std::size_t size = writer.GetSize();
+  void* address = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  const bool written =
+    WriteSnapshot(static_cast<char*>(address), writer, stamp);
+  munmap(address, size);
+  if (!written) {
+    shm_unlink(name.c_str());
+  }
+  return written;
+}
+
+//----------------------------------------------------------------------------
+// Path of the snapshot file caching the mesh of a file.
+std::string GetSnapshotName(const char* FileName)
+{
+  return std::string(FileName) + ".snap";
+}
+
+//----------------------------------------------------------------------------
+bool AttachSnapshotFile(const char* FileName, MeshArrays& mesh)
+{
+  GmshCore::SnapshotStamp stamp;
+  if (!GetSourceStamp(FileName, stamp)) {
+    return false;
+  }
+
+  const int fd = open(GetSnapshotName(FileName).c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  const bool attached = MapSnapshot(fd, stamp, mesh);
+  close(fd);
+  return attached;
+}
+
+//----------------------------------------------------------------------------
+// Write a snapshot of mesh next to the file. The snapshot is written to a
+// temporary file first and renamed into place, so that concurrent readers
+// never see it half written.
+bool WriteSnapshotFile(const char* FileName, const MeshArrays& mesh)
+{
+  GmshCore::SnapshotStamp stamp;
+  if (!GetSourceStamp(FileName, stamp)) {
+    return false;
+  }
+
+  const std::string name = GetSnapshotName(FileName);
+  std::string temporary = name + ".XXXXXX";
+  const int fd = mkstemp(&temporary[0]);
+  if (fd < 0) {
+    return false;
+  }
+
+  const GmshCore::SnapshotWriter writer = GetSnapshotWriter(mesh);
+  const std::size_t size = writer.GetSize();
+  void* address = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+
+  bool written = false;
+  if (address != MAP_FAILED) {
+    written = WriteSnapshot(static_cast<char*>(address), writer, stamp);
+    written = munmap(address, size) == 0 && written && fchmod(fd, 0644) == 0;
+  }
+  close(fd);
+
+  if (!written || rename(temporary.c_str(), name.c_str()) != 0) {
+    unlink(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+#else
+//----------------------------------------------------------------------------
+std::string GetSharedMemoryName(const char*)
+{
+  return std::string();
+}
+
+bool AttachSharedMesh(const char*, const std::string&, MeshArrays&)
+{
+  return false;
+}
+
+bool PublishSharedMesh(const char*, const std::string&, const MeshArrays&)
+{
+  return false;
+}
+
+bool AttachSnapshotFile(const char*, MeshArrays&)
+{
+  return false;
+}
+
+bool WriteSnapshotFile(const char*, const MeshArrays&)
+{
+  return false;
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Pick, for each enabled field, the latest view that is not past the
+// requested time.
+std::vector<const DataView*> SelectDataViews(
+  const std::vector<DataView>& views, vtkDataArraySelection* selection,
+  double time)
+{
+  std::vector<const DataView*> selected;
+  for (const auto& view : views) {
+    if (!selection->ArrayIsEnabled(view.Name.c_str())) {
+      continue;
+    }
+
+    auto it = std::find_if(selected.begin(), selected.end(),
+			   [&view](const DataView* other) {
+			     return other->Name == view.Name;
+			   });
+    if (it == selected.end()) {
+      selected.push_back(&view);
+    } else if (view.Time <= time &&
+	       (view.Time > (*it)->Time || (*it)->Time > time)) {
+      *it = &view;
+    }
+  }
+  return selected;
+}
+
+//----------------------------------------------------------------------------
+// Decode the records of a view with GmshCore, passing them to a handler,
+// and the records the handler does not want skipped.
+bool ReadViewRecords(GmshCore::Tokenizer& tokens, const DataView& view,
+		     GmshCore::Handler& handler)
+{
+  GmshCore::DataViewHeader header;
+  header.StringTags = { view.Name, view.InterpolationScheme };
+  header.RealTags = { view.Time };
+  header.IntegerTags = { view.TimeStep, view.NumberOfComponents,
+			 static_cast<long long>(view.NumberOfEntities) };
+
+  std::string error;
+  tokens.Seek(view.Offset);
+  return GmshCore::ReadDataRecords(tokens, view.Kind, header, handler,
+				   error);
+}
+
+//----------------------------------------------------------------------------
+// Read the records of a view into an array holding one tuple per point or
+// cell. TupleIndex maps an entity tag to its tuple, or to -1 when the tag
+// is unknown, which fails the view unless it is read for a mesh piece: the
+// records of the entities outside of the piece are then skipped without
+// being decoded.
+template <typename TupleIndexFunctor>
+bool ReadDataView(GmshCore::Tokenizer& tokens, const DataView& view,
+		  TupleIndexFunctor&& TupleIndex, bool piece,
+		  vtkDoubleArray* values)
+{
+  // Receiver of the records, decoded by GmshCore in chunks, each of which
+  // is copied to the tuples of its tags.
+  struct Scatter : GmshCore::Handler
+  {
+    std::remove_reference_t<TupleIndexFunctor>* TupleIndex = nullptr;
+    bool Piece = false;
+    bool Complete = false;
+    int NumberOfComponents = 1;
+    double* Buffer = nullptr;
+    GmshCore::Trace* Trace = nullptr;
+    std::vector<bool> Written;
+    vtkIdType NumberOfRepeated = 0;
+    std::vector<vtkIdType> Indices;
+    std::vector<vtkIdType> Order;
+    bool Failed = false;
+
+    bool WantsRecord(std::size_t tag) override
+    {
+      return !this->Piece || (*this->TupleIndex)(tag) >= 0;
+    }
+
+    void OnDataRecords(const GmshCore::DataRecords& records) override
+    {
+      const vtkIdType count = static_cast<vtkIdType>(records.Tags.size());
+      const int n = this->NumberOfComponents;
+      this->Indices.resize(count);
+      for (vtkIdType i = 0; i < count && !this->Failed; ++i) {
+	this->Indices[i] = (*this->TupleIndex)(records.Tags[i]);
+	this->Failed = this->Indices[i] < 0;
+      }
+      if (this->Failed) {
+	return;
+      }
+
+      // The view has a record per tuple, so each record is copied straight
+      // to its tuple. When records follow the mesh order this is a single
+      // sequential sweep. A repeated tag, whose last record wins, leaves
+      // as many tuples without a record, which are then filled with NaN as
+      // in partial views.
+      if (this->Complete) {
+	for (vtkIdType i = 0; i < count; ++i) {
+	  const vtkIdType index = this->Indices[i];
+	  if (this->Written[index]) {
+	    ++this->NumberOfRepeated;
+	  }
+	  this->Written[index] = true;
+	  std::copy_n(records.Values.data() + i * n, n,
+		      this->Buffer + index * n);
+	}
+	return;
+      }
+
+      // Partial view: order the records of the chunk by destination tuple
+      // and scatter them in parallel over the NaN-filled array. Sorting
+      // keeps the writes of each thread monotonic in memory. Chunks are
+      // scattered in the order of the file.
+      const std::vector<vtkIdType>& Indices = this->Indices;
+      this->Order.resize(count);
+      std::iota(this->Order.begin(), this->Order.end(), 0);
+      vtkSMPTools::Sort(this->Order.begin(), this->Order.end(),
+			[&Indices](vtkIdType a, vtkIdType b) {
+			  return Indices[a] < Indices[b] ||
+			    (Indices[a] == Indices[b] && a < b);
+			});
+
+      const vtkIdType* Order = this->Order.data();
+      double* Buffer = this->Buffer;
+      vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end) {
+	GmshCore::Trace::Scope scope(this->Trace, "worker",
+				     "Scatter records");
+	scope.Argument("begin", begin).Argument("end", end);
+	for (vtkIdType i = begin; i < end; ++i) {
+	  const vtkIdType record = Order[i];
+
+	  // When a tag is repeated, the last record in the file wins.
+	  if (i + 1 < count && Indices[Order[i + 1]] == Indices[record]) {
+	    continue;
+	  }
+
+	  std::copy_n(records.Values.data() + record * n, n,
+		      Buffer + Indices[record] * n);
+	}
+      });
+    }
+  };
+
+  const vtkIdType NumberOfTuples = values->GetNumberOfTuples();
+  Scatter scatter;
+  scatter.TupleIndex = &TupleIndex;
+  scatter.Piece = piece;
+  scatter.Complete = !piece &&
+    static_cast<vtkIdType>(view.NumberOfEntities) == NumberOfTuples;
+  scatter.NumberOfComponents = view.NumberOfComponents;
+  scatter.Buffer = values->GetPointer(0);
+  scatter.Trace = tokens.GetTrace();
+  if (scatter.Complete) {
+    scatter.Written.assign(NumberOfTuples, false);
+  } else {
+    vtkSMPTools::Fill(scatter.Buffer,
+		      scatter.Buffer + values->GetNumberOfValues(),
+		      vtkMath::Nan());
+  }
+
+  if (!ReadViewRecords(tokens, view, scatter) || scatter.Failed) {
+    return false;
+  }
+
+  const int NumberOfComponents = view.NumberOfComponents;
+  for (vtkIdType i = 0; scatter.NumberOfRepeated > 0 && i < NumberOfTuples;
+       ++i) {
+    if (!scatter.Written[i]) {
+      std::fill_n(scatter.Buffer + i * NumberOfComponents,
+		  NumberOfComponents, vtkMath::Nan());
+      --scatter.NumberOfRepeated;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Read the records of an $ElementNodeData view into an array holding one
+// tuple per cell vertex. CellVertexIndex maps an element tag and its
+// number of vertices to the tuple of its first vertex, or to -1 when the
+// element is unknown or does not have that many vertices.
+template <typename CellVertexIndexFunctor>
+bool ReadElementNodeDataView(GmshCore::Tokenizer& tokens, const DataView& view,
+			     CellVertexIndexFunctor&& CellVertexIndex,
+			     vtkDoubleArray* values)
+{
+  struct Scatter : GmshCore::Handler
+  {
+    std::remove_reference_t<CellVertexIndexFunctor>* CellVertexIndex =
+      nullptr;
+    int NumberOfComponents = 1;
+    double* Buffer = nullptr;
+    bool Failed = false;
+
+    void OnDataRecords(const GmshCore::DataRecords& records) override
+    {
+      const double* value = records.Values.data();
+      for (std::size_t i = 0; i < records.Tags.size() && !this->Failed;
+	   ++i) {
+	const int NumberOfVertices = records.NumberOfNodes[i];
+	const vtkIdType index =
+	  (*this->CellVertexIndex)(records.Tags[i], NumberOfVertices);
+	this->Failed = index < 0;
+	if (!this->Failed) {
+	  const int count = NumberOfVertices * this->NumberOfComponents;
+	  std::copy_n(value, count,
+		      this->Buffer + index * this->NumberOfComponents);
+	  value += count;
+	}
+      }
+    }
+  };
+
+  Scatter scatter;
+  scatter.CellVertexIndex = &CellVertexIndex;
+  scatter.NumberOfComponents = view.NumberOfComponents;
+  scatter.Buffer = values->GetPointer(0);
+  vtkSMPTools::Fill(scatter.Buffer,
+		    scatter.Buffer + values->GetNumberOfValues(),
+		    vtkMath::Nan());
+
+  return ReadViewRecords(tokens, view, scatter) && !scatter.Failed;
+}
+
+//----------------------------------------------------------------------------
+// Gmsh parent type (element topology) of an element type.
+int GetElementTopology(int mshElementType)
+{
+  const GmshCore::ElementType* type = GmshCore::GetElementType(mshElementType);
+  return type ? type->Topology : 0;
+}
+
+//----------------------------------------------------------------------------
+// Matrix evaluating, at the nodes of an element type, a field given by its
+// coefficients in the basis of an interpolation scheme. The matrix is
+// stored row-major with one row per node and one column per basis
+// function.
+bool GetEvaluationMatrix(int mshElementType,
+			 const GmshCore::InterpolationMatrices& matrices,
+			 std::vector<double>& evaluation)
+{
+  std::vector<double> uvw;
+  if (!GmshCore::GetReferenceNodes(mshElementType, uvw)) {
+    return false;
+  }
+
+  const int NumberOfNodes = static_cast<int>(uvw.size() / 3);
+  const int NumberOfBasisFunctions = matrices.NumberOfBasisFunctions;
+  const int NumberOfMonomials = matrices.NumberOfMonomials;
+
+  std::vector<double> monomials(NumberOfMonomials);
+  evaluation.assign(NumberOfNodes * NumberOfBasisFunctions, 0.0);
+  for (int n = 0; n < NumberOfNodes; ++n) {
+    for (int j = 0; j < NumberOfMonomials; ++j) {
+      const double* exponents = matrices.Exponents.data() + 3 * j;
+      monomials[j] = std::pow(uvw[3 * n], exponents[0]) *
+	std::pow(uvw[3 * n + 1], exponents[1]) *
+	std::pow(uvw[3 * n + 2], exponents[2]);
+    }
+
+    for (int i = 0; i < NumberOfBasisFunctions; ++i) {
+      const double* F = matrices.Coefficients.data() + i * NumberOfMonomials;
+      evaluation[n * NumberOfBasisFunctions + i] =
+	std::inner_product(F, F + NumberOfMonomials, monomials.begin(), 0.0);
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Read the records of an $ElementNodeData view holding the coefficients of
+// a high-order field, and evaluate the field at the nodes of each cell into
+// an array holding one tuple per cell vertex. CellIndex maps an element tag
+// to its cell, or to -1 when the tag is unknown.
+template <typename CellIndexFunctor, typename OffsetType>
+bool ReadInterpolatedElementNodeDataView(
+  GmshCore::Tokenizer& tokens, const DataView& view,
+  const GmshCore::InterpolationScheme& scheme, CellIndexFunctor&& CellIndex,
+  const unsigned char* ElementTypes, const OffsetType* CellOffsets,
+  vtkDoubleArray* values)
+{
+  // Receiver of the records, decoded by GmshCore in chunks, each of which
+  // is evaluated into the tuples of its cells.
+  struct Evaluation : GmshCore::Handler
+  {
+    const GmshCore::InterpolationScheme* Scheme = nullptr;
+    std::remove_reference_t<CellIndexFunctor>* CellIndex = nullptr;
+    const unsigned char* ElementTypes = nullptr;
+    const OffsetType* CellOffsets = nullptr;
+    int NumberOfComponents = 1;
+    double* Buffer = nullptr;
+    GmshCore::Trace* Trace = nullptr;
+    bool Failed = false;
+
+    // Evaluation matrix of each element type, built once per view.
+    std::array<std::vector<double>, 256> EvaluationMatrices;
+    std::array<int, 256> NumberOfBasisFunctions{};
+
+    std::vector<vtkIdType> RecordCells;
+    std::vector<std::size_t> RecordOffsets;
+
+    void OnDataRecords(const GmshCore::DataRecords& records) override
+    {
+      const vtkIdType count = static_cast<vtkIdType>(records.Tags.size());
+      const int NumberOfComponents = this->NumberOfComponents;
+      this->RecordCells.resize(count);
+      this->RecordOffsets.assign(count + 1, 0);
+      for (vtkIdType i = 0; i < count && !this->Failed; ++i) {
+	const vtkIdType CellId = (*this->CellIndex)(records.Tags[i]);
+	if (CellId < 0) {
+	  this->Failed = true;
+	  return;
+	}
+
+	const int ElementType = this->ElementTypes[CellId];
+	if (this->EvaluationMatrices[ElementType].empty()) {
+	  auto it = this->Scheme->find(GetElementTopology(ElementType));
+	  if (it == this->Scheme->end() ||
+	      !GetEvaluationMatrix(ElementType, it->second,
+				   this->EvaluationMatrices[ElementType])) {
+	    this->Failed = true;
+	    return;
+	  }
+	  this->NumberOfBasisFunctions[ElementType] =
+	    it->second.NumberOfBasisFunctions;
+	}
+
+	const int NumberOfValues = records.NumberOfNodes[i];
+	this->Failed =
+	  NumberOfValues != this->NumberOfBasisFunctions[ElementType];
+	this->RecordCells[i] = CellId;
+	this->RecordOffsets[i + 1] =
+	  this->RecordOffsets[i] + NumberOfValues * NumberOfComponents;
+      }
+      if (this->Failed) {
+	return;
+      }
+
+      // One small dense product per element: values (nodes x components)
+      // = evaluation (nodes x basis) * coefficients (basis x components).
+      // Gmsh stores elements in homogeneous blocks, so consecutive records
+      // share their evaluation matrix and it stays in cache. The innermost
+      // loop runs over contiguous components and vectorizes.
+      const double* Coefficients = records.Values.data();
+      vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end) {
+	GmshCore::Trace::Scope scope(this->Trace, "worker",
+				     "Evaluate records");
+	scope.Argument("begin", begin).Argument("end", end);
+	for (vtkIdType i = begin; i < end; ++i) {
+	  const vtkIdType CellId = this->RecordCells[i];
+	  const int ElementType = this->ElementTypes[CellId];
+	  const std::vector<double>& E = this->EvaluationMatrices[ElementType];
+	  const int NumberOfBasis = this->NumberOfBasisFunctions[ElementType];
+	  const int NumberOfNodes = static_cast<int>(E.size()) / NumberOfBasis;
+	  const OffsetType* CellOffsets = this->CellOffsets;
+
+	  if (CellOffsets[CellId + 1] - CellOffsets[CellId] != NumberOfNodes) {
+	    continue;
+	  }
+
+	  const double* C = Coefficients + this->RecordOffsets[i];
+	  double* Tuple =
+	    this->Buffer + CellOffsets[CellId] * NumberOfComponents;
+	  for (int n = 0; n < NumberOfNodes; ++n) {
+	    double* out = Tuple + n * NumberOfComponents;
+	    std::fill_n(out, NumberOfComponents, 0.0);
+	    for (int b = 0; b < NumberOfBasis; ++b) {
+	      const double e = E[n * NumberOfBasis + b];
+	      const double* c = C + b * NumberOfComponents;
+	      for (int k = 0; k < NumberOfComponents; ++k) {
+		out[k] += e * c[k];
+	      }
+	    }
+	  }
+	}
+      });
+    }
+  };
+
+  Evaluation evaluation;
+  evaluation.Scheme = &scheme;
+  evaluation.CellIndex = &CellIndex;
+  evaluation.ElementTypes = ElementTypes;
+  evaluation.CellOffsets = CellOffsets;
+  evaluation.NumberOfComponents = view.NumberOfComponents;
+  evaluation.Buffer = values->GetPointer(0);
+  evaluation.Trace = tokens.GetTrace();
+  vtkSMPTools::Fill(evaluation.Buffer,
+		    evaluation.Buffer + values->GetNumberOfValues(),
+		    vtkMath::Nan());
+
+  return ReadViewRecords(tokens, view, evaluation) && !evaluation.Failed;
+}
+
+//----------------------------------------------------------------------------
+// Gather the tuples of source at the given ids, in parallel, into a new
+// array of the same type.
+template <typename IdType>
+vtkSmartPointer<vtkDataArray> GatherTuples(vtkDataArray* source,
+					   const IdType* ids,
+					   vtkIdType NumberOfIds)
+{
+  const int NumberOfComponents = source->GetNumberOfComponents();
+  const std::size_t TupleSize =
+    static_cast<std::size_t>(NumberOfComponents) * source->GetDataTypeSize();
+
+  auto gathered = vtkSmartPointer<vtkDataArray>::Take(source->NewInstance());
+  gathered->SetName(source->GetName());
+  gathered->SetNumberOfComponents(NumberOfComponents);
+  gathered->SetNumberOfTuples(NumberOfIds);
+
+  const char* Source = static_cast<const char*>(source->GetVoidPointer(0));
+  char* Target = static_cast<char*>(gathered->GetVoidPointer(0));
+  vtkSMPTools::For(0, NumberOfIds, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      std::memcpy(Target + i * TupleSize, Source + ids[i] * TupleSize,
+		  TupleSize);
+    }
+  });
+
+  return gathered;
+}
+
+//----------------------------------------------------------------------------
+// Reorder the cells of the mesh by dimension, then by entity tag, in the
+// order given by GmshCore, and record the range of cells of each
+// dimension and entity. The cells of a block stay together, so they are
+// moved with their connectivity as whole ranges, one block per thread.
+void SortCells(MeshArrays& mesh, std::vector<GmshCore::CellBlock> blocks,
+	       const MemoryPolicy& policy)
+{
+  const vtkIdType NumberOfCells = mesh.CellTypes->GetNumberOfValues();
+  auto CellTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  CellTypes->SetNumberOfValues(NumberOfCells);
+  TouchArray(CellTypes.Get(), policy);
+  auto ElementTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  ElementTypes->SetNumberOfValues(NumberOfCells);
+  TouchArray(ElementTypes.Get(), policy);
+  std::vector<vtkIdType> SortedCellIds(NumberOfCells);
+
+  GmshCore::CellOrder order;
+  VisitCellArrays(mesh.Offsets, mesh.Connectivity, [&](auto* OffsetArray,
+						      auto* CellArray) {
+    using ArrayType = std::remove_pointer_t<decltype(OffsetArray)>;
+    const auto* Offsets = OffsetArray->GetPointer(0);
+    GmshCore::OrderCells(std::move(blocks), Offsets, order);
+    const std::vector<GmshCore::CellBlock>& SortedBlocks = order.Blocks;
+    const std::vector<long long>& FirstCells = order.FirstCells;
+    const std::vector<long long>& FirstVertices = order.FirstVertices;
+    const vtkIdType NumberOfBlocks =
+      static_cast<vtkIdType>(SortedBlocks.size());
+
+    auto SortedOffsets = vtkSmartPointer<ArrayType>::New();
+    SortedOffsets->SetNumberOfValues(NumberOfCells + 1);
+    TouchArray(SortedOffsets.Get(), policy);
+    auto Connectivity = vtkSmartPointer<ArrayType>::New();
+    Connectivity->SetNumberOfValues(CellArray->GetNumberOfValues());
+    TouchArray(Connectivity.Get(), policy);
+
+    auto* NewOffsets = SortedOffsets->GetPointer(0);
+    NewOffsets[0] = 0;
+    auto move = [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType b = begin; b < end; ++b) {
+	const vtkIdType first = SortedBlocks[b].FirstCell;
+	const vtkIdType last = first + SortedBlocks[b].NumberOfCells;
+	const vtkIdType target = FirstCells[b];
+	const vtkIdType shift = FirstVertices[b] - Offsets[first];
+
+	std::copy(mesh.CellTypes->GetPointer(first),
+		  mesh.CellTypes->GetPointer(0) + last,
+		  CellTypes->GetPointer(target));
+	std::copy(mesh.ElementTypes->GetPointer(first),
+		  mesh.ElementTypes->GetPointer(0) + last,
+		  ElementTypes->GetPointer(target));
+	std::copy(CellArray->GetPointer(Offsets[first]),
+		  CellArray->GetPointer(0) + Offsets[last],
+		  Connectivity->GetPointer(FirstVertices[b]));
+	for (vtkIdType c = first; c < last; ++c) {
+	  NewOffsets[target + c - first + 1] = Offsets[c + 1] + shift;
+	  SortedCellIds[c] = target + c - first;
+	}
+      }
+    };
+    vtkSMPTools::For(0, NumberOfBlocks, 1, move);
+    mesh.Offsets = SortedOffsets;
+    mesh.Connectivity = Connectivity;
+  });
+
+  vtkIdType* CellIds = mesh.CellIds->GetPointer(0);
+  vtkSMPTools::For(0, mesh.CellIds->GetNumberOfValues(),
+		   [&](vtkIdType begin, vtkIdType end) {
+		     for (vtkIdType i = begin; i < end; ++i) {
+		       if (CellIds[i] >= 0) {
+			 CellIds[i] = SortedCellIds[CellIds[i]];
+		       }
+		     }
+		   });
+
+  mesh.CellTypes = CellTypes;
+  mesh.ElementTypes = ElementTypes;
+
+  // Ranges of the dimensions 0 to 3, empty for those without cells, and
+  // of each entity as (dimension, tag, begin, end).
+  mesh.DimensionRanges = vtkSmartPointer<vtkIdTypeArray>::New();
+  mesh.DimensionRanges->SetName("DimensionCellRanges");
+  mesh.DimensionRanges->SetNumberOfComponents(2);
+  mesh.DimensionRanges->SetNumberOfTuples(4);
+  std::copy_n(order.DimensionRanges.data()->data(), 8,
+	      mesh.DimensionRanges->GetPointer(0));
+
+  mesh.EntityRanges = vtkSmartPointer<vtkIdTypeArray>::New();
+  mesh.EntityRanges->SetName("EntityCellRanges");
+  mesh.EntityRanges->SetNumberOfComponents(4);
+  mesh.EntityRanges->SetNumberOfTuples(
+    static_cast<vtkIdType>(order.EntityRanges.size()));
+  std::copy_n(order.EntityRanges.data()->data(),
+	      4 * order.EntityRanges.size(),
+	      mesh.EntityRanges->GetPointer(0));
+}
+
+//----------------------------------------------------------------------------
+// Points of the mesh cells left once coincident points are merged, in
+// increasing order, with their node tags and the connectivity of the mesh
+// cells rewritten to them. Ids maps each point of the mesh to the merged
+// point it became, or -1 when no cell uses it.
+struct MergedPoints
+{
+  double Tolerance = 0.0;
+  vtkSmartPointer<vtkIdTypeArray> PointIds;
+  vtkSmartPointer<vtkIdTypeArray> NodeTags;
+  vtkSmartPointer<vtkDataArray> Connectivity;
+  std::vector<long long> Ids;
+};
+
+//----------------------------------------------------------------------------
+// Merge the points of the mesh cells lying within the tolerance of a
+// representative point, or at the same place for a zero tolerance, with
+// the spatial hash of GmshCore. Points are keyed by chunks in parallel,
+// sorted in parallel, and merged into representatives chosen in point
+// order, so that no point moves further than the tolerance, resolved by
+// chunks in parallel rounds. Points used by no cell are dropped.
+template <typename ValueType, typename ArrayType>
+void MergeCoincidentPoints(const MeshArrays& mesh, const ValueType* x,
+			   ArrayType* CellArray, double tolerance,
+			   MergedPoints& merged)
+{
+  const vtkIdType NumberOfPoints = mesh.Points->GetNumberOfTuples();
+  const vtkIdType NumberOfVertices = CellArray->GetNumberOfValues();
+  const auto* VertexIds = CellArray->GetPointer(0);
+
+  std::unique_ptr<std::atomic<unsigned char>[]> used(
+    new std::atomic<unsigned char>[NumberOfPoints]());
+  vtkSMPTools::For(0, NumberOfVertices, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      used[VertexIds[i]].store(1, std::memory_order_relaxed);
+    }
+  });
+
+  // Each chunk of points counts its used points, then writes their
+  // entries in point order after those of the chunks before it.
+  constexpr vtkIdType ChunkSize = 4096;
+  const vtkIdType NumberOfChunks =
+    (NumberOfPoints + ChunkSize - 1) / ChunkSize;
+  auto ForEachChunk = [&](auto functor) {
+    auto chunks = [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType c = begin; c < end; ++c) {
+	functor(c, c * ChunkSize,
+		std::min(NumberOfPoints, (c + 1) * ChunkSize));
+      }
+    };
+    vtkSMPTools::For(0, NumberOfChunks, 1, chunks);
+  };
+  std::vector<vtkIdType> counts(NumberOfChunks + 1, 0);
+  ForEachChunk([&](vtkIdType c, vtkIdType first, vtkIdType last) {
+    for (vtkIdType p = first; p < last; ++p) {
+      counts[c + 1] += used[p].load(std::memory_order_relaxed);
+    }
+  });
+  std::partial_sum(counts.begin(), counts.end(), counts.begin());
+
+  std::vector<GmshCore::MergeEntry> entries(counts[NumberOfChunks]);
+  ForEachChunk([&](vtkIdType c, vtkIdType first, vtkIdType last) {
+    vtkIdType e = counts[c];
+    for (vtkIdType p = first; p < last; ++p) {
+      if (used[p].load(std::memory_order_relaxed)) {
+	const double point[3] = { static_cast<double>(x[3 * p]),
+				  static_cast<double>(x[3 * p + 1]),
+				  static_cast<double>(x[3 * p + 2]) };
+	entries[e].Key = GmshCore::GetMergeKey(point, tolerance);
+	entries[e++].Point = static_cast<std::size_t>(p);
+      }
+    }
+  });
+  used.reset();
+  vtkSMPTools::Sort(entries.begin(), entries.end());
+
+  // Point each used point is merged into, -1 for the others. Equal keys
+  // merge independently; representatives are chosen in point order, each
+  // round resolving the points whose closer predecessors are.
+  std::vector<long long> target(NumberOfPoints, -1);
+  if (tolerance > 0.0) {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(entries.size()),
+		     [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType e = begin; e < end; ++e) {
+	target[entries[e].Point] = GmshCore::PendingTarget;
+      }
+    });
+    std::vector<long long> next(NumberOfPoints);
+    std::atomic<std::size_t> pending(0);
+    do {
+      pending = 0;
+      ForEachChunk([&](vtkIdType, vtkIdType first, vtkIdType last) {
+	pending += GmshCore::ResolveNearbyPoints(
+	  entries, x, tolerance, target, static_cast<std::size_t>(first),
+	  static_cast<std::size_t>(last), next);
+      });
+      target.swap(next);
+    } while (pending > 0);
+  } else {
+    auto merge = [&](vtkIdType begin, vtkIdType end) {
+      GmshCore::MergeEqualPoints(entries, static_cast<std::size_t>(begin),
+				 static_cast<std::size_t>(end), target);
+    };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(entries.size()), merge);
+  }
+  std::vector<GmshCore::MergeEntry>().swap(entries);
+
+  // Number the representatives by chunks in parallel, in increasing order.
+  std::fill(counts.begin(), counts.end(), 0);
+  ForEachChunk([&](vtkIdType c, vtkIdType first, vtkIdType last) {
+    for (vtkIdType p = first; p < last; ++p) {
+      counts[c + 1] += target[p] == p;
+    }
+  });
+  std::partial_sum(counts.begin(), counts.end(), counts.begin());
+
+  const vtkIdType NumberOfKept = counts[NumberOfChunks];
+  merged.Tolerance = tolerance;
+  merged.PointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  merged.PointIds->SetNumberOfValues(NumberOfKept);
+  vtkIdType* kept = merged.PointIds->GetPointer(0);
+
+  // Tags of the nodes kept, which are the point ids plus one unless the
+  // mesh is a piece.
+  merged.NodeTags = vtkSmartPointer<vtkIdTypeArray>::New();
+  merged.NodeTags->SetName("gmsh:node");
+  merged.NodeTags->SetNumberOfValues(NumberOfKept);
+  vtkIdType* NodeTags = merged.NodeTags->GetPointer(0);
+
+  std::vector<vtkIdType> ids(NumberOfPoints, -1);
+  ForEachChunk([&](vtkIdType c, vtkIdType first, vtkIdType last) {
+    vtkIdType id = counts[c];
+    for (vtkIdType p = first; p < last; ++p) {
+      if (target[p] == p) {
+	kept[id] = p;
+	NodeTags[id] = mesh.Piece
+	  ? static_cast<vtkIdType>(mesh.NodeTags[p]) : p + 1;
+	ids[p] = id++;
+      }
+    }
+  });
+
+  auto connectivity = vtkSmartPointer<ArrayType>::New();
+  connectivity->SetNumberOfValues(NumberOfVertices);
+  auto* MergedIds = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, NumberOfVertices, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      MergedIds[i] = ids[target[VertexIds[i]]];
+    }
+  });
+  merged.Connectivity = connectivity;
+
+  ForEachChunk([&](vtkIdType, vtkIdType first, vtkIdType last) {
+    for (vtkIdType p = first; p < last; ++p) {
+      target[p] = target[p] < 0 ? -1 : ids[target[p]];
+    }
+  });
+  merged.Ids = std::move(target);
+}
+
+//----------------------------------------------------------------------------
+// Periodic node pairs with their point ids mapped to the merged points,
+// -1 for points that no cell uses.
+vtkSmartPointer<vtkIdTypeArray> MergePeriodicNodes(
+  vtkIdTypeArray* nodes, const MergedPoints& merged)
+{
+  auto MergedNodes = vtkSmartPointer<vtkIdTypeArray>::New();
+  MergedNodes->SetName(nodes->GetName());
+  MergedNodes->SetNumberOfComponents(2);
+  MergedNodes->SetNumberOfTuples(nodes->GetNumberOfTuples());
+  const vtkIdType* ids = nodes->GetPointer(0);
+  vtkIdType* MergedIds = MergedNodes->GetPointer(0);
+  const vtkIdType NumberOfPoints =
+    static_cast<vtkIdType>(merged.Ids.size());
+  vtkSMPTools::For(0, nodes->GetNumberOfValues(),
+		   [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      MergedIds[i] = ids[i] >= 0 && ids[i] < NumberOfPoints
+	? static_cast<vtkIdType>(merged.Ids[ids[i]]) : -1;
+    }
+  });
+  return MergedNodes;
+}
+
+//----------------------------------------------------------------------------
+// Merge coincident points, for points and connectivity of any width.
+void MergeCoincidentPoints(const MeshArrays& mesh, double tolerance,
+			   MergedPoints& merged)
+{
+  VisitCoordinates(mesh.Points, [&](const auto* x) {
+    VisitIds(mesh.Connectivity, [&](auto* CellArray) {
+      MergeCoincidentPoints(mesh, x, CellArray, tolerance, merged);
+    });
+  });
+}
+
+//----------------------------------------------------------------------------
+// Linear VTK cell type of a gmsh element topology, and its number of
+// corners.
+unsigned char GetLinearCellType(int topology, int& NumberOfCorners)
+{
+  static const unsigned char CellTypes[] = {
+    VTK_EMPTY_CELL, VTK_VERTEX, VTK_LINE, VTK_TRIANGLE, VTK_QUAD,
+    VTK_TETRA, VTK_PYRAMID, VTK_WEDGE, VTK_HEXAHEDRON };
+  static const int Corners[] = { 0, 1, 2, 3, 4, 4, 5, 6, 8 };
+  if (topology < 1 || topology > 8) {
+    NumberOfCorners = 0;
+    return VTK_EMPTY_CELL;
+  }
+  NumberOfCorners = Corners[topology];
+  return CellTypes[topology];
+}
+
+//----------------------------------------------------------------------------
+// Replace the cells of output by linear cells. High-order elements are
+// subdivided adaptively by GmshCore::Linearizer, to the given tolerance
+// and maximum depth, through their nodes and through new points
+// interpolated inside them, which are appended to the points with the
+// double point arrays interpolated, other point arrays holding -1 there.
+// High-order pyramids, whose basis is rational, and linear elements are
+// reduced to their corners; the number of high-order pyramids is
+// returned. Elements are subdivided in parallel by chunks of fixed size,
+// and their cells and points placed at offsets given by a prefix sum over
+// the chunks, so the output does not depend on the number of threads.
+vtkIdType LinearizeHighOrderCells(vtkUnstructuredGrid* output,
+				  vtkDataArray* Offsets,
+				  vtkDataArray* Connectivity,
+				  const unsigned char* ElementTypes,
+				  double Tolerance, int MaximumDepth)
+{
+  vtkPoints* points = output->GetPoints();
+  const vtkIdType NumberOfPoints = points->GetNumberOfPoints();
+
+  // Point fields interpolated inside the elements, with the range of each
+  // component.
+  std::vector<vtkDoubleArray*> Fields;
+  std::vector<double> Ranges;
+  vtkPointData* PointData = output->GetPointData();
+  for (int i = 0; i < PointData->GetNumberOfArrays(); ++i) {
+    vtkDoubleArray* values = vtkDoubleArray::SafeDownCast(PointData->GetArray(i));
+    if (!values) {
+      continue;
+    }
+    Fields.push_back(values);
+    for (int k = 0; k < values->GetNumberOfComponents(); ++k) {
+      const double* range = values->GetRange(k);
+      Ranges.push_back(range[1] - range[0]);
+    }
+  }
+  const int NumberOfValues = 3 + static_cast<int>(Ranges.size());
+
+  std::array<GmshCore::Linearizer, 256> Linearizers;
+  std::array<bool, 256> Adaptive{};
+  for (int t = 0; t < 256; ++t) {
+    const GmshCore::ElementType* type = GmshCore::GetElementType(t);
+    Adaptive[t] = type && type->Order > 1 &&
+      Linearizers[t].Initialize(t, NumberOfValues, Ranges.data(), Tolerance,
+				MaximumDepth);
+  }
+
+  const vtkIdType NumberOfCells = Offsets->GetNumberOfValues() - 1;
+  vtkUnsignedCharArray* CellTypes = output->GetCellTypesArray();
+
+  // Linear cells of a chunk of elements. Connectivity entries below 0 are
+  // -1 - i for the new point i of the chunk.
+  struct Chunk
+  {
+    std::vector<unsigned char> Types;
+    std::vector<vtkIdType> Sizes;
+    std::vector<vtkIdType> Parents;
+    std::vector<vtkIdType> Connectivity;
+    std::vector<double> Values;
+  };
+  constexpr vtkIdType ChunkSize = 4096;
+  const vtkIdType NumberOfChunks = (NumberOfCells + ChunkSize - 1) / ChunkSize;
+  std::vector<Chunk> Chunks(NumberOfChunks);
+  std::atomic<vtkIdType> NumberOfPyramids(0);
+
+  auto subdivide = [&](const auto* Coordinates, const auto* CellOffsets,
+		       const auto* CellNodes) {
+    vtkSMPTools::For(0, NumberOfChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<double> values;
+      GmshCore::LinearCells cells;
+      vtkIdType pyramids = 0;
+      for (vtkIdType c = begin; c < end; ++c) {
+	Chunk& chunk = Chunks[c];
+	const vtkIdType last = std::min(NumberOfCells, (c + 1) * ChunkSize);
+	for (vtkIdType i = c * ChunkSize; i < last; ++i) {
+	  const auto* nodes = CellNodes + CellOffsets[i];
+	  const vtkIdType NumberOfNodes = CellOffsets[i + 1] - CellOffsets[i];
+	  const int type = ElementTypes[i];
+	  const GmshCore::ElementType* element = GmshCore::GetElementType(type);
+
+	  int NumberOfCorners = 0;
+	  const unsigned char LinearType = element
+	    ? GetLinearCellType(element->Topology, NumberOfCorners)
+	    : VTK_EMPTY_CELL;
+	  if (!Adaptive[type]) {
+	    // Gmsh numbers the corners of every element first. Unknown
+	    // elements are copied.
+	    pyramids += element && element->Topology == 6 && element->Order > 1;
+	    if (LinearType == VTK_EMPTY_CELL) {
+	      NumberOfCorners = static_cast<int>(NumberOfNodes);
+	    }
+	    chunk.Types.push_back(LinearType == VTK_EMPTY_CELL
+				  ? CellTypes->GetValue(i) : LinearType);
+	    chunk.Sizes.push_back(NumberOfCorners);
+	    chunk.Parents.push_back(i);
+	    chunk.Connectivity.insert(chunk.Connectivity.end(), nodes,
+				      nodes + NumberOfCorners);
+	    continue;
+	  }
+
+	  // Values at the nodes: coordinates, then field components.
+	  values.resize(NumberOfNodes * NumberOfValues);
+	  for (vtkIdType n = 0; n < NumberOfNodes; ++n) {
+	    double* value = values.data() + n * NumberOfValues;
+	    for (int k = 0; k < 3; ++k) {
+	      value[k] = Coordinates[3 * nodes[n] + k];
+	    }
+	    int k = 3;
+	    for (vtkDoubleArray* field : Fields) {
+	      const int m = field->GetNumberOfComponents();
+	      std::copy_n(field->GetPointer(0) + m * nodes[n], m, value + k);
+	      k += m;
+	    }
+	  }
+
+	  Linearizers[type].Subdivide(values.data(), cells);
+	  const vtkIdType first =
+	    static_cast<vtkIdType>(chunk.Values.size()) / NumberOfValues;
+	  std::vector<vtkIdType> ids(cells.Points.size());
+	  vtkIdType inner = first;
+	  for (std::size_t p = 0; p < cells.Points.size(); ++p) {
+	    ids[p] = cells.Points[p] >= 0 ? nodes[cells.Points[p]] : -1 - inner++;
+	  }
+	  chunk.Values.insert(chunk.Values.end(), cells.Values.begin(),
+			      cells.Values.end());
+
+	  for (std::size_t k = 0; k < cells.Corners.size(); ++k) {
+	    if (k % cells.NumberOfCorners == 0) {
+	      chunk.Types.push_back(LinearType);
+	      chunk.Sizes.push_back(cells.NumberOfCorners);
+	      chunk.Parents.push_back(i);
+	    }
+	    chunk.Connectivity.push_back(ids[cells.Corners[k]]);
+	  }
+	}
+      }
+      NumberOfPyramids += pyramids;
+    });
+  };
+  VisitCoordinates(points->GetData(), [&](const auto* Coordinates) {
+    VisitCells(Offsets, Connectivity,
+	       [&](const auto* CellOffsets, const auto* CellNodes) {
+		 subdivide(Coordinates, CellOffsets, CellNodes);
+	       });
+  });
+
+  // Offsets of the cells, connectivity entries and new points of each
+  // chunk.
+  std::vector<vtkIdType> CellCounts(NumberOfChunks + 1, 0);
+  std::vector<vtkIdType> NodeCounts(NumberOfChunks + 1, 0);
+  std::vector<vtkIdType> PointCounts(NumberOfChunks + 1, 0);
+  for (vtkIdType c = 0; c < NumberOfChunks; ++c) {
+    CellCounts[c + 1] = CellCounts[c] + Chunks[c].Types.size();
+    NodeCounts[c + 1] = NodeCounts[c] + Chunks[c].Connectivity.size();
+    PointCounts[c + 1] =
+      PointCounts[c] + Chunks[c].Values.size() / NumberOfValues;
+  }
+  const vtkIdType NumberOfLinearCells = CellCounts[NumberOfChunks];
+  const vtkIdType NumberOfNewPoints = PointCounts[NumberOfChunks];
+
+  // Linear cells keep 32-bit connectivity while their ids fit.
+  const vtkIdType limit = std::numeric_limits<std::int32_t>::max();
+  const bool narrow = IsNarrow(Offsets) &&
+    NodeCounts[NumberOfChunks] <= limit &&
+    NumberOfPoints + NumberOfNewPoints <= limit;
+  vtkNew<vtkUnsignedCharArray> LinearTypes;
+  LinearTypes->SetNumberOfValues(NumberOfLinearCells);
+  vtkSmartPointer<vtkDataArray> LinearOffsets = NewIdArray(narrow);
+  LinearOffsets->SetNumberOfValues(NumberOfLinearCells + 1);
+  vtkSmartPointer<vtkDataArray> LinearConnectivity = NewIdArray(narrow);
+  LinearConnectivity->SetNumberOfValues(NodeCounts[NumberOfChunks]);
+  vtkNew<vtkIdTypeArray> ParentIds;
+  ParentIds->SetName("vtkOriginalCellIds");
+  ParentIds->SetNumberOfValues(NumberOfLinearCells);
+
+  // Points and point arrays extended with the new points, which keep the
+  // precision of the points.
+  vtkSmartPointer<vtkDataArray> coordinates =
+    vtkSmartPointer<vtkDataArray>::Take(points->GetData()->NewInstance());
+  coordinates->DeepCopy(points->GetData());
+  coordinates->Resize(NumberOfPoints + NumberOfNewPoints);
+  coordinates->SetNumberOfTuples(NumberOfPoints + NumberOfNewPoints);
+  vtkNew<vtkPointData> LinearPointData;
+  std::vector<vtkDoubleArray*> LinearFields;
+  for (int i = 0; i < PointData->GetNumberOfArrays(); ++i) {
+    vtkDataArray* source = PointData->GetArray(i);
+    if (!source) {
+      continue;
+    }
+    vtkSmartPointer<vtkDataArray> extended =
+      vtkSmartPointer<vtkDataArray>::Take(source->NewInstance());
+    extended->DeepCopy(source);
+    extended->Resize(NumberOfPoints + NumberOfNewPoints);
+    extended->SetNumberOfTuples(NumberOfPoints + NumberOfNewPoints);
+    if (vtkDoubleArray* field = vtkDoubleArray::SafeDownCast(extended)) {
+      LinearFields.push_back(field);
+    } else {
+      for (vtkIdType p = NumberOfPoints; p < extended->GetNumberOfTuples();
+	   ++p) {
+	for (int k = 0; k < extended->GetNumberOfComponents(); ++k) {
+	  extended->SetComponent(p, k, -1.0);
+	}
+      }
+    }
+    LinearPointData->AddArray(extended);
+  }
+
+  unsigned char* Types = LinearTypes->GetPointer(0);
+  vtkIdType* Parents = ParentIds->GetPointer(0);
+
+  // Fill them in.
+  auto fill = [&](auto* Coordinates, auto* LinearCellOffsets,
+		  auto* LinearNodes) {
+    LinearCellOffsets[NumberOfLinearCells] = NodeCounts[NumberOfChunks];
+    vtkSMPTools::For(0, NumberOfChunks, 1, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType c = begin; c < end; ++c) {
+	const Chunk& chunk = Chunks[c];
+	vtkIdType node = NodeCounts[c];
+	for (std::size_t k = 0; k < chunk.Types.size(); ++k) {
+	  const vtkIdType cell = CellCounts[c] + k;
+	  Types[cell] = chunk.Types[k];
+	  Parents[cell] = chunk.Parents[k];
+	  LinearCellOffsets[cell] = node;
+	  node += chunk.Sizes[k];
+	}
+
+	const vtkIdType first = NumberOfPoints + PointCounts[c];
+	std::transform(chunk.Connectivity.begin(), chunk.Connectivity.end(),
+		       LinearNodes + NodeCounts[c], [first](vtkIdType id) {
+			 return id >= 0 ? id : first - 1 - id;
+		       });
+
+	const double* values = chunk.Values.data();
+	for (vtkIdType p = first; p < NumberOfPoints + PointCounts[c + 1]; ++p) {
+	  for (int k = 0; k < 3; ++k) {
+	    Coordinates[3 * p + k] = values[k];
+	  }
+	  int k = 3;
+	  for (vtkDoubleArray* field : LinearFields) {
+	    const int m = field->GetNumberOfComponents();
+	    std::copy_n(values + k, m, field->GetPointer(0) + m * p);
+	    k += m;
+	  }
+	  values += NumberOfValues;
+	}
+      }
+    });
+  };
+  VisitCoordinates(coordinates, [&](auto* Coordinates) {
+    VisitCells(LinearOffsets, LinearConnectivity,
+	       [&](auto* LinearCellOffsets, auto* LinearNodes) {
+		 fill(Coordinates, LinearCellOffsets, LinearNodes);
+	       });
+  });
+
+  vtkNew<vtkCellData> LinearCellData;
+  vtkCellData* CellData = output->GetCellData();
+  for (int i = 0; i < CellData->GetNumberOfArrays(); ++i) {
+    if (vtkDataArray* values = CellData->GetArray(i)) {
+      LinearCellData->AddArray(
+	GatherTuples(values, Parents, NumberOfLinearCells));
+    }
+  }
+  LinearCellData->AddArray(ParentIds);
+
+  vtkNew<vtkCellArray> LinearCells;
+  LinearCells->SetData(LinearOffsets, LinearConnectivity);
+  vtkNew<vtkPoints> LinearPoints;
+  LinearPoints->SetData(coordinates);
+  output->SetPoints(LinearPoints);
+  output->GetPointData()->ShallowCopy(LinearPointData);
+  output->SetCells(LinearTypes, LinearCells);
+  output->GetCellData()->ShallowCopy(LinearCellData);
+  return NumberOfPyramids;
+}
+
+//----------------------------------------------------------------------------
+// Evaluate the quality kernel of one topology over a range of cells of
+// that topology, in parallel, from their corners.
+using QualityStatistics = vtkSMPThreadLocal<GmshCore::QualityStatistics>;
+
+template <typename ValueType, typename IdType>
+void ComputeQualityRange(vtkIdType first, vtkIdType last,
+			 const GmshCore::QualityKernel& kernel,
+			 const ValueType* Points, const IdType* CellOffsets,
+			 const IdType* CellNodes, double* const* Values,
+			 QualityStatistics& statistics)
+{
+  vtkSMPTools::For(first, last, [&](vtkIdType begin, vtkIdType end) {
+    GmshCore::QualityStatistics& local = statistics.Local();
+    double corners[8][3];
+    for (vtkIdType i = begin; i < end; ++i) {
+      const IdType* nodes = CellNodes + CellOffsets[i];
+      for (int c = 0; c < kernel.NumberOfCorners; ++c) {
+	for (int k = 0; k < 3; ++k) {
+	  corners[c][k] = Points[3 * nodes[c] + k];
+	}
+      }
+      const GmshCore::CellQuality q = kernel.Compute(corners);
+      Values[0][i] = q.Size;
+      Values[1][i] = q.ScaledJacobian;
+      Values[2][i] = q.AspectRatio;
+      local.Add(q);
+    }
+  });
+}
+
+//----------------------------------------------------------------------------
+// Compute the quality metrics of the triangles, quadrangles, tetrahedra and
+// hexahedra of the mesh, high-order ones from their corners, as cell arrays
+// that are NaN on other cells. Cells come in blocks of one element type, so
+// the GmshCore kernel is looked up once per run of cells of one type. The
+// minimum, maximum, mean and standard deviation of each metric are
+// returned as field data arrays.
+void ComputeQualityArrays(
+  const MeshArrays& mesh,
+  std::vector<vtkSmartPointer<vtkDoubleArray>>& QualityArrays,
+  std::vector<vtkSmartPointer<vtkDoubleArray>>& StatisticsArrays)
+{
+  const vtkIdType NumberOfCells = mesh.CellTypes->GetNumberOfValues();
+  const unsigned char* ElementTypes = mesh.ElementTypes->GetPointer(0);
+
+  QualityArrays.clear();
+  double* Values[3];
+  for (int i = 0; i < 3; ++i) {
+    auto values = vtkSmartPointer<vtkDoubleArray>::New();
+    values->SetName(GmshCore::QualityMetricNames[i]);
+    values->SetNumberOfValues(NumberOfCells);
+    Values[i] = values->GetPointer(0);
+    QualityArrays.push_back(values);
+  }
+
+  QualityStatistics statistics;
+  auto compute = [&](const auto* Points, const auto* CellOffsets,
+		     const auto* CellNodes) {
+    for (vtkIdType first = 0; first < NumberOfCells;) {
+      vtkIdType last = first + 1;
+      while (last < NumberOfCells &&
+	     ElementTypes[last] == ElementTypes[first]) {
+	++last;
+      }
+
+      const GmshCore::QualityKernel* kernel =
+	GmshCore::GetQualityKernel(GetElementTopology(ElementTypes[first]));
+      if (kernel) {
+	ComputeQualityRange(first, last, *kernel, Points, CellOffsets,
+			    CellNodes, Values, statistics);
+      } else {
+	for (int i = 0; i < 3; ++i) {
+	  std::fill(Values[i] + first, Values[i] + last, vtkMath::Nan());
+	}
+      }
+      first = last;
+    }
+  };
+  VisitCoordinates(mesh.Points, [&](const auto* Points) {
+    VisitCells(mesh.Offsets, mesh.Connectivity,
+	       [&](const auto* CellOffsets, const auto* CellNodes) {
+		 compute(Points, CellOffsets, CellNodes);
+	       });
+  });
+
+  GmshCore::QualityStatistics total;
+  for (const GmshCore::QualityStatistics& local : statistics) {
+    total.Merge(local);
+  }
+
+  StatisticsArrays.clear();
+  if (total.NumberOfCells == 0) {
+    return;
+  }
+  for (int i = 0; i < 3; ++i) {
+    const double tuple[4] = { total.Min[i], total.Max[i], total.GetMean(i),
+			      total.GetStandardDeviation(i) };
+
+    auto values = vtkSmartPointer<vtkDoubleArray>::New();
+    values->SetName(
+      (std::string(GmshCore::QualityMetricNames[i]) + "Statistics").c_str());
+    values->SetNumberOfComponents(4);
+    values->SetComponentName(0, "Minimum");
+    values->SetComponentName(1, "Maximum");
+    values->SetComponentName(2, "Mean");
+    values->SetComponentName(3, "StandardDeviation");
+    values->SetNumberOfTuples(1);
+    values->SetTypedTuple(0, tuple);
+    StatisticsArrays.push_back(values);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Index of the data sections of one file, built by RequestInformation.
+struct FileIndex
+{
+  std::string FileName;
+  std::vector<DataView> NodeDataViews;
+  std::vector<DataView> ElementDataViews;
+  std::vector<DataView> ElementNodeDataViews;
+  std::map<std::string, GmshCore::InterpolationScheme> InterpolationSchemes;
+  std::vector<double> TimeSteps;
+
+  // Header lines of the $Nodes and $Elements sections. Files of a series
+  // with the same signature share the mesh read from the first of them.
+  std::string MeshSignature;
+
+  // Offset of the first section not indexed yet, and the fingerprint of
+  // the indexed part of the file.
+  std::streamoff IndexedOffset = 0;
+  std::string IndexedFingerprint;
+
+  // Offset of the content of the $Periodic section, or -1.
+  std::streamoff PeriodicOffset = -1;
+
+  // Offset of the content of the $Elements section, or -1, and the
+  // largest node tag, which sizes the points.
+  std::streamoff ElementsOffset = -1;
+  std::size_t MaxNodeTag = 0;
+
+  // Offset of the content of the $Nodes section, or -1, and the node and
+  // element block headers, indexed when the mesh is first read in pieces
+  // or by entity.
+  std::streamoff NodesOffset = -1;
+  std::vector<GmshCore::NodeBlockHeader> NodeBlocks;
+  std::vector<GmshCore::ElementBlockHeader> ElementBlocks;
+
+  // Name, size and modification time of the file when first indexed,
+  // which key its decoded blocks.
+  std::string Identity;
+};
+
+//----------------------------------------------------------------------------
+std::string GetFileIdentity(const std::string& FileName, std::streamoff size)
+{
+  std::string identity = FileName + ':' + std::to_string(size);
+#ifndef _WIN32
+  GmshCore::SnapshotStamp stamp;
+  if (GetSourceStamp(FileName.c_str(), stamp)) {
+    identity += ':' + std::to_string(stamp.ModificationTime);
+  }
+#endif
+  return identity;
+}
+
+//----------------------------------------------------------------------------
+// First and last bytes of the first size bytes of a stream, which tell
+// whether a file that grew still starts with the sections indexed from it:
+// the $MeshFormat section and $Nodes header, and the end of the last
+// indexed section. The position of the stream is left undefined.
+std::string GetFingerprint(std::istream& stream, std::streamoff size)
+{
+  constexpr std::streamoff window = 4096;
+  const std::streamoff head = std::min(size, window);
+  const std::streamoff tail = std::min(size - head, window);
+  std::string fingerprint(static_cast<std::size_t>(head + tail), '\0');
+  stream.clear();
+  stream.seekg(0);
+  stream.read(&fingerprint[0], head);
+  stream.seekg(size - tail);
+  stream.read(&fingerprint[head], tail);
+  if (!stream) {
+    fingerprint.clear();
+  }
+  stream.clear();
+  return fingerprint;
+}
+
+//----------------------------------------------------------------------------
+// Identity of a file as it is now, or an empty string if it cannot be
+// opened.
+std::string GetFileIdentity(const std::string& FileName)
+{
+  std::ifstream file(FileName, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::string();
+  }
+  return GetFileIdentity(FileName, file.tellg());
+}
+
+//----------------------------------------------------------------------------
+// Name of an entity in the entity selection.
+std::string GetEntityName(int EntityDim, int EntityTag)
+{
+  static const char* const names[] = { "Point", "Curve", "Surface",
+				       "Volume" };
+  const char* name =
+    EntityDim >= 0 && EntityDim <= 3 ? names[EntityDim] : "Entity";
+  return name + (' ' + std::to_string(EntityTag));
+}
+
+//----------------------------------------------------------------------------
+// Index the element block headers of a file and, when nodes is set, its
+// node block headers, unless an earlier read did.
+bool IndexMeshBlocks(FileIndex& file, GmshCore::Tokenizer& tokens,
+		     bool nodes, std::string& error)
+{
+  if (file.NodesOffset < 0 || file.ElementsOffset < 0) {
+    error = "Missing $Nodes or $Elements section.";
+    return false;
+  }
+
+  GmshCore::BlockSectionHeader header;
+  if (file.ElementBlocks.empty()) {
+    tokens.Seek(file.ElementsOffset);
+    if (!GmshCore::ReadElementBlockHeaders(tokens, header,
+					   file.ElementBlocks, error)) {
+      file.ElementBlocks.clear();
+      return false;
+    }
+  }
+  if (nodes && file.NodeBlocks.empty()) {
+    tokens.Seek(file.NodesOffset);
+    if (!GmshCore::ReadNodeBlockHeaders(tokens, header, file.NodeBlocks,
+					error)) {
+      file.NodeBlocks.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Whether some of the sorted node tags are in the range of the tags of a
+// node block.
+bool HasNodeTags(const GmshCore::NodeBlockHeader& block,
+		 const std::vector<std::size_t>& NodeTags)
+{
+  const auto it =
+    std::lower_bound(NodeTags.begin(), NodeTags.end(), block.MinTag);
+  return it != NodeTags.end() && *it <= block.MaxTag;
+}
+
+//----------------------------------------------------------------------------
+// Point, cell and cell vertex arrays read from the views of one file.
+struct FieldArrays
+{
+  std::vector<vtkSmartPointer<vtkDoubleArray>> PointArrays;
+  std::vector<vtkSmartPointer<vtkDoubleArray>> CellArrays;
+  std::vector<vtkSmartPointer<vtkDoubleArray>> CellVertexArrays;
+
+  // Views that were skipped, and the reason reading stopped if it failed.
+  std::vector<std::string> Warnings;
+  std::string Error;
+};
+
+//----------------------------------------------------------------------------
+// Read the enabled views of a file, picking for each field the latest view
+// that is not past the given time. The file is opened here so that several
+// files of a series can be read concurrently against the same mesh.
+bool ReadFieldArrays(const FileIndex& file, double time,
+		     const MeshArrays& mesh,
+		     vtkDataArraySelection* PointSelection,
+		     vtkDataArraySelection* CellSelection,
+		     GmshCore::IOPolicy io, const MemoryPolicy& policy,
+		     GmshCore::Trace* trace, FieldArrays& arrays)
+{
+  GmshCore::FileStream MshFile(file.FileName, io);
+  if (!MshFile) {
+    arrays.Error = "Cannot open " + file.FileName + ".";
+    return false;
+  }
+  GmshCore::Tokenizer tokens(MshFile);
+  tokens.SetTrace(trace);
+
+  const vtkIdType NumberOfPoints = mesh.Points->GetNumberOfTuples();
+  const vtkIdType NumberOfCells = mesh.CellTypes->GetNumberOfValues();
+  const std::vector<std::size_t>& NodeTags = mesh.NodeTags;
+  auto PointIndex = [&](std::size_t NodeTag) -> vtkIdType {
+    if (mesh.Piece) {
+      auto it = std::lower_bound(NodeTags.begin(), NodeTags.end(), NodeTag);
+      return it != NodeTags.end() && *it == NodeTag
+	? static_cast<vtkIdType>(it - NodeTags.begin()) : -1;
+    }
+    return NodeTag >= 1 && NodeTag <= static_cast<std::size_t>(NumberOfPoints)
+      ? static_cast<vtkIdType>(NodeTag - 1) : -1;
+  };
+
+  // The records of the points and cells outside of a mesh piece are
+  // skipped.
+  auto ReadView = [&mesh, &tokens](const DataView& view, auto&& TupleIndex,
+				   vtkDoubleArray* values) {
+    return ReadDataView(tokens, view, TupleIndex, mesh.Piece, values);
+  };
+
+  for (const DataView* view :
+	 SelectDataViews(file.NodeDataViews, PointSelection, time)) {
+    GmshCore::Trace::Scope scope(trace, "view", "$NodeData " + view->Name);
+    scope.Argument("records", static_cast<double>(view->NumberOfEntities));
+    auto values = vtkSmartPointer<vtkDoubleArray>::New();
+    values->SetName(view->Name.c_str());
+    values->SetNumberOfComponents(view->NumberOfComponents);
+    values->SetNumberOfTuples(NumberOfPoints);
+    TouchArray(values.Get(), policy);
+
+    if (!ReadView(*view, PointIndex, values)) {
+      arrays.Error = "Failed to read values of view \"" + view->Name + "\".";
+      return false;
+    }
+
+    arrays.PointArrays.push_back(values);
+  }
+
+  const vtkIdType* CellIds = mesh.CellIds->GetPointer(0);
+  const std::size_t NumberOfCellIds =
+    static_cast<std::size_t>(mesh.CellIds->GetNumberOfValues());
+  const std::size_t MinElementTag = static_cast<std::size_t>(mesh.MinElementTag);
+  auto CellIndex = [=](std::size_t ElementTag) {
+    const std::size_t i = ElementTag - MinElementTag;
+    return ElementTag >= MinElementTag && i < NumberOfCellIds
+      ? CellIds[i] : -1;
+  };
+
+  for (const DataView* view :
+	 SelectDataViews(file.ElementDataViews, CellSelection, time)) {
+    GmshCore::Trace::Scope scope(trace, "view", "$ElementData " + view->Name);
+    scope.Argument("records", static_cast<double>(view->NumberOfEntities));
+    auto values = vtkSmartPointer<vtkDoubleArray>::New();
+    values->SetName(view->Name.c_str());
+    values->SetNumberOfComponents(view->NumberOfComponents);
+    values->SetNumberOfTuples(NumberOfCells);
+    TouchArray(values.Get(), policy);
+
+    if (!ReadView(*view, CellIndex, values)) {
+      arrays.Error = "Failed to read values of view \"" + view->Name + "\".";
+      return false;
+    }
+
+    arrays.CellArrays.push_back(values);
+  }
+
+  // $ElementNodeData views hold one tuple per cell vertex. They are loaded
+  // as compact arrays laid out like the connectivity array, which is also
+  // the point order of the exploded mesh.
+  const unsigned char* ElementTypes = mesh.ElementTypes->GetPointer(0);
+  auto ReadCellVertexViews = [&](const auto* CellOffsets) {
+    auto CellVertexIndex = [&](std::size_t ElementTag, int NumberOfVertices) {
+      const vtkIdType CellId = CellIndex(ElementTag);
+      return CellId >= 0 &&
+	CellOffsets[CellId + 1] - CellOffsets[CellId] == NumberOfVertices
+	? CellOffsets[CellId] : -1;
+    };
+
+    for (const DataView* view :
+	   SelectDataViews(file.ElementNodeDataViews, CellSelection, time)) {
+      GmshCore::Trace::Scope scope(trace, "view",
+				   "$ElementNodeData " + view->Name);
+      scope.Argument("records",
+		     static_cast<double>(view->NumberOfEntities));
+      if (mesh.Piece) {
+	arrays.Warnings.push_back("Skipping view \"" + view->Name +
+				  "\": $ElementNodeData views are not read " +
+				  "in pieces.");
+	continue;
+      }
+
+      auto values = vtkSmartPointer<vtkDoubleArray>::New();
+      values->SetName(view->Name.c_str());
+      values->SetNumberOfComponents(view->NumberOfComponents);
+      values->SetNumberOfTuples(mesh.Connectivity->GetNumberOfValues());
+      TouchArray(values.Get(), policy);
+
+      // Views bound to an interpolation scheme hold polynomial coefficients,
+      // which are evaluated at the nodes of each cell.
+      bool status;
+      if (view->InterpolationScheme.empty()) {
+	status =
+	  ReadElementNodeDataView(tokens, *view, CellVertexIndex, values);
+      } else {
+	auto it = file.InterpolationSchemes.find(view->InterpolationScheme);
+	if (it == file.InterpolationSchemes.end()) {
+	  arrays.Warnings.push_back("Skipping view \"" + view->Name +
+				    "\": unknown interpolation scheme \"" +
+				    view->InterpolationScheme + "\".");
+	  continue;
+	}
+	status = ReadInterpolatedElementNodeDataView(
+	  tokens, *view, it->second, CellIndex, ElementTypes, CellOffsets,
+	  values);
+      }
+
+      if (!status) {
+	arrays.Error =
+	  "Failed to read values of view \"" + view->Name + "\".";
+	return false;
+      }
+
+      arrays.CellVertexArrays.push_back(values);
+    }
+    return true;
+  };
+
+  bool read = true;
+  VisitIds(mesh.Offsets, [&](auto* OffsetArray) {
+    read = ReadCellVertexViews(OffsetArray->GetPointer(0));
+  });
+  return read;
+}
+
+//----------------------------------------------------------------------------
+// Time histories of the enabled fields, as field data arrays.
+struct HistoryArrays
+{
+  std::vector<vtkSmartPointer<vtkDataArray>> Arrays;
+
+  // Views that were skipped, and the reason reading stopped if it failed.
+  std::vector<std::string> Warnings;
+  std::string Error;
+};
+
+//----------------------------------------------------------------------------
+// Read the enabled $NodeData and $ElementData fields at every time step of
+// the files sharing the mesh, into one array per field with a tuple per
+// point or cell, or per given id, holding the components of every step
+// side by side. Each file is read in one forward pass over its views, and
+// the records of the points or cells that are not kept are skipped
+// without being decoded.
+bool ReadHistoryArrays(const std::vector<FileIndex>& files,
+		       const std::string& signature, const MeshArrays& mesh,
+		       vtkDataArraySelection* PointSelection,
+		       vtkDataArraySelection* CellSelection,
+		       const std::vector<vtkIdType>& PointIds,
+		       const std::vector<vtkIdType>& CellIds,
+		       GmshCore::IOPolicy io, HistoryArrays& history)
+{
+  // Rows of the points and cells, -1 for those that are not kept.
+  const vtkIdType NumberOfEntities[2] = {
+    mesh.Points->GetNumberOfTuples(), mesh.CellTypes->GetNumberOfValues()
+  };
+  const std::vector<vtkIdType>* Ids[2] = { &PointIds, &CellIds };
+  std::vector<vtkIdType> Rows[2];
+  for (int kind = 0; kind < 2; ++kind) {
+    if (Ids[kind]->empty()) {
+      continue;
+    }
+    Rows[kind].assign(NumberOfEntities[kind], -1);
+    for (std::size_t j = Ids[kind]->size(); j-- > 0;) {
+      const vtkIdType id = (*Ids[kind])[j];
+      if (id >= 0 && id < NumberOfEntities[kind]) {
+	Rows[kind][id] = static_cast<vtkIdType>(j);
+      }
+    }
+  }
+
+  // Steps of each field, in the order of the files and of their views.
+  struct Field
+  {
+    const DataView* First;
+    int Kind;
+    std::vector<double> Times;
+    vtkSmartPointer<vtkDoubleArray> Values;
+  };
+  struct Step
+  {
+    std::size_t File;
+    const DataView* View;
+    std::size_t Field;
+    std::size_t Index;
+  };
+  std::vector<Field> fields;
+  std::vector<Step> steps;
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    if (files[i].MeshSignature != signature) {
+      continue;
+    }
+    for (int kind = 0; kind < 2; ++kind) {
+      vtkDataArraySelection* selection =
+	kind == 0 ? PointSelection : CellSelection;
+      for (const DataView& view :
+	     kind == 0 ? files[i].NodeDataViews : files[i].ElementDataViews) {
+	if (!selection->ArrayIsEnabled(view.Name.c_str())) {
+	  continue;
+	}
+
+	auto it = std::find_if(fields.begin(), fields.end(),
+			       [&](const Field& field) {
+				 return field.Kind == kind &&
+				   field.First->Name == view.Name;
+			       });
+	if (it == fields.end()) {
+	  it = fields.insert(fields.end(), Field{ &view, kind, {}, nullptr });
+	} else if (view.NumberOfComponents != it->First->NumberOfComponents) {
+	  history.Warnings.push_back(
+	    "Skipped view \"" + view.Name + "\" at time " +
+	    std::to_string(view.Time) + " of " + files[i].FileName +
+	    " from its time history: its number of components differs.");
+	  continue;
+	}
+	steps.push_back(Step{ i, &view,
+			      static_cast<std::size_t>(it - fields.begin()),
+			      it->Times.size() });
+	it->Times.push_back(view.Time);
+      }
+    }
+  }
+
+  for (Field& field : fields) {
+    const vtkIdType NumberOfRows = Ids[field.Kind]->empty()
+      ? NumberOfEntities[field.Kind]
+      : static_cast<vtkIdType>(Ids[field.Kind]->size());
+    field.Values = vtkSmartPointer<vtkDoubleArray>::New();
+    field.Values->SetName((field.First->Name + " History").c_str());
+    field.Values->SetNumberOfComponents(
+      static_cast<int>(field.Times.size()) * field.First->NumberOfComponents);
+    field.Values->SetNumberOfTuples(NumberOfRows);
+    double* Buffer = field.Values->GetPointer(0);
+    vtkSMPTools::Fill(Buffer, Buffer + field.Values->GetNumberOfValues(),
+		      vtkMath::Nan());
+  }
+
+  const vtkIdType* CellIdsOfTags = mesh.CellIds->GetPointer(0);
+  const std::size_t NumberOfCellIds =
+    static_cast<std::size_t>(mesh.CellIds->GetNumberOfValues());
+  const std::size_t MinElementTag = static_cast<std::size_t>(mesh.MinElementTag);
+  auto EntityIndex = [&](int kind, std::size_t tag) -> vtkIdType {
+    if (kind == 0) {
+      return tag >= 1 && tag <= static_cast<std::size_t>(NumberOfEntities[0])
+	? static_cast<vtkIdType>(tag - 1) : -1;
+    }
+    const std::size_t i = tag - MinElementTag;
+    return tag >= MinElementTag && i < NumberOfCellIds ? CellIdsOfTags[i] : -1;
+  };
+
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    std::vector<const Step*> FileSteps;
+    for (const Step& step : steps) {
+      if (step.File == i) {
+	FileSteps.push_back(&step);
+      }
+    }
+    if (FileSteps.empty()) {
+      continue;
+    }
+    std::sort(FileSteps.begin(), FileSteps.end(),
+	      [](const Step* a, const Step* b) {
+		return a->View->Offset < b->View->Offset;
+	      });
+
+    GmshCore::FileStream MshFile(files[i].FileName, io);
+    if (!MshFile) {
+      history.Error = "Cannot open " + files[i].FileName + ".";
+      return false;
+    }
+    GmshCore::Tokenizer tokens(MshFile);
+
+    for (const Step* step : FileSteps) {
+      const DataView& view = *step->View;
+      const Field& field = fields[step->Field];
+      const int kind = field.Kind;
+      const int NumberOfComponents = view.NumberOfComponents;
+      const vtkIdType Width = field.Values->GetNumberOfComponents();
+
+      // The records of the rows that are not kept are skipped, those of
+      // unknown tags being still delivered to fail the view.
+      struct Scatter : GmshCore::Handler
+      {
+	const decltype(EntityIndex)* Index = nullptr;
+	int Kind = 0;
+	const vtkIdType* RowOf = nullptr;
+	int NumberOfComponents = 1;
+	vtkIdType Width = 0;
+	double* Buffer = nullptr;
+	bool Failed = false;
+
+	bool WantsRecord(std::size_t tag) override
+	{
+	  const vtkIdType index = (*this->Index)(this->Kind, tag);
+	  return index < 0 || !this->RowOf || this->RowOf[index] >= 0;
+	}
+
+	void OnDataRecords(const GmshCore::DataRecords& records) override
+	{
+	  for (std::size_t r = 0; r < records.Tags.size() && !this->Failed;
+	       ++r) {
+	    const vtkIdType index = (*this->Index)(this->Kind, records.Tags[r]);
+	    this->Failed = index < 0;
+	    if (!this->Failed) {
+	      const vtkIdType row = this->RowOf ? this->RowOf[index] : index;
+	      std::copy_n(records.Values.data() + r * this->NumberOfComponents,
+			  this->NumberOfComponents,
+			  this->Buffer + row * this->Width);
+	    }
+	  }
+	}
+      };
+
+      Scatter scatter;
+      scatter.Index = &EntityIndex;
+      scatter.Kind = kind;
+      scatter.RowOf = Rows[kind].empty() ? nullptr : Rows[kind].data();
+      scatter.NumberOfComponents = NumberOfComponents;
+      scatter.Width = Width;
+      scatter.Buffer =
+	field.Values->GetPointer(0) + step->Index * NumberOfComponents;
+      if (!ReadViewRecords(tokens, view, scatter) || scatter.Failed) {
+	history.Error = "Failed to read values of view \"" + view.Name + "\".";
+	return false;
+      }
+    }
+  }
+
+  bool UsedKind[2] = { false, false };
+  for (const Field& field : fields) {
+    // A repeated id gets a copy of the row of its first occurrence.
+    const std::vector<vtkIdType>& FieldIds = *Ids[field.Kind];
+    const vtkIdType Width = field.Values->GetNumberOfComponents();
+    double* Buffer = field.Values->GetPointer(0);
+    for (std::size_t j = 0; j < FieldIds.size(); ++j) {
+      const vtkIdType id = FieldIds[j];
+      if (id >= 0 && id < NumberOfEntities[field.Kind] &&
+	  Rows[field.Kind][id] != static_cast<vtkIdType>(j)) {
+	std::copy_n(Buffer + Rows[field.Kind][id] * Width, Width,
+		    Buffer + j * Width);
+      }
+    }
+
+    auto times = vtkSmartPointer<vtkDoubleArray>::New();
+    times->SetName((field.First->Name + " HistoryTimes").c_str());
+    times->SetNumberOfValues(static_cast<vtkIdType>(field.Times.size()));
+    std::copy(field.Times.begin(), field.Times.end(), times->GetPointer(0));
+
+    history.Arrays.push_back(field.Values);
+    history.Arrays.push_back(times);
+    UsedKind[field.Kind] = true;
+  }
+
+  // The ids the rows stand for, when only some points or cells are kept.
+  const char* IdsNames[2] = { "TimeHistoryPointIds", "TimeHistoryCellIds" };
+  for (int kind = 0; kind < 2; ++kind) {
+    if (UsedKind[kind] && !Ids[kind]->empty()) {
+      auto ids = vtkSmartPointer<vtkIdTypeArray>::New();
+      ids->SetName(IdsNames[kind]);
+      ids->SetNumberOfValues(static_cast<vtkIdType>(Ids[kind]->size()));
+      std::copy(Ids[kind]->begin(), Ids[kind]->end(), ids->GetPointer(0));
+      history.Arrays.push_back(ids);
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Periodic links of the mesh, from its $Periodic section, as exposed in
+// the field data of the output.
+struct PeriodicArrays
+{
+  // Entity dimension, entity tag and master entity tag of each link.
+  vtkSmartPointer<vtkIntArray> Links;
+  // Row-major 4x4 affine transform of each link, NaN when not given.
+  vtkSmartPointer<vtkDoubleArray> Transforms;
+  // Offset of the node pairs of each link, and the point id and master
+  // point id of each pair.
+  vtkSmartPointer<vtkIdTypeArray> NodeOffsets;
+  vtkSmartPointer<vtkIdTypeArray> Nodes;
+};
+
+//----------------------------------------------------------------------------
+bool ReadPeriodicArrays(const FileIndex& file, GmshCore::IOPolicy io,
+			PeriodicArrays& periodic, std::string& error)
+{
+  struct PeriodicBuilder : GmshCore::Handler
+  {
+    PeriodicArrays Arrays;
+
+    void OnPeriodicLink(const GmshCore::PeriodicLink& link) override
+    {
+      const int LinkTags[3] = { link.EntityDim, link.EntityTag,
+				link.MasterTag };
+      this->Arrays.Links->InsertNextTypedTuple(LinkTags);
+
+      std::array<double, 16> affine;
+      affine.fill(vtkMath::Nan());
+      std::copy(link.Affine.begin(), link.Affine.end(), affine.begin());
+      this->Arrays.Transforms->InsertNextTypedTuple(affine.data());
+
+      vtkIdTypeArray* nodes = this->Arrays.Nodes;
+      const vtkIdType first = nodes->GetNumberOfValues();
+      const vtkIdType count = static_cast<vtkIdType>(link.NodeTags.size());
+      vtkIdType* PointIds = nodes->WritePointer(first, count);
+      for (vtkIdType k = 0; k < count; ++k) {
+	PointIds[k] = static_cast<vtkIdType>(link.NodeTags[k]) - 1;
+      }
+      this->Arrays.NodeOffsets->InsertNextValue(nodes->GetNumberOfTuples());
+    }
+  };
+
+  PeriodicBuilder builder;
+  PeriodicArrays& arrays = builder.Arrays;
+  arrays.Links = vtkSmartPointer<vtkIntArray>::New();
+  arrays.Links->SetName("PeriodicLinks");
+  arrays.Links->SetNumberOfComponents(3);
+  arrays.Links->SetComponentName(0, "EntityDim");
+  arrays.Links->SetComponentName(1, "EntityTag");
+  arrays.Links->SetComponentName(2, "MasterTag");
+  arrays.Transforms = vtkSmartPointer<vtkDoubleArray>::New();
+  arrays.Transforms->SetName("PeriodicTransforms");
+  arrays.Transforms->SetNumberOfComponents(16);
+  arrays.NodeOffsets = vtkSmartPointer<vtkIdTypeArray>::New();
+  arrays.NodeOffsets->SetName("PeriodicNodeOffsets");
+  arrays.NodeOffsets->InsertNextValue(0);
+  arrays.Nodes = vtkSmartPointer<vtkIdTypeArray>::New();
+  arrays.Nodes->SetName("PeriodicNodes");
+  arrays.Nodes->SetNumberOfComponents(2);
+
+  if (file.PeriodicOffset >= 0) {
+    GmshCore::FileStream MshFile(file.FileName, io);
+    GmshCore::Tokenizer tokens(MshFile);
+    tokens.Seek(file.PeriodicOffset);
+    if (!MshFile || !GmshCore::ReadPeriodic(tokens, builder, error)) {
+      if (error.empty()) {
+	error = "Could not read the $Periodic section of " + file.FileName +
+	  ".";
+      }
+      return false;
+    }
+  }
+
+  periodic = arrays;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Fill the partitioned dataset with copies of the output, copy k being
+// transformed by the k-th power of the affine transform of the
+// highest-dimensional periodic link. Copies share the cells and the point,
+// cell and field arrays of the output, and its points too unless they are
+// transformed; the transform of each copy is attached as field data.
+bool BuildPeriodicCopies(vtkUnstructuredGrid* output,
+			 const PeriodicArrays& periodic, int NumberOfCopies,
+			 bool TransformPoints, vtkPartitionedDataSet* copies)
+{
+  vtkIdType link = -1;
+  for (vtkIdType i = 0; i < periodic.Links->GetNumberOfTuples(); ++i) {
+    if (!vtkMath::IsNan(periodic.Transforms->GetComponent(i, 0)) &&
+	(link < 0 || periodic.Links->GetComponent(i, 0) >
+	 periodic.Links->GetComponent(link, 0))) {
+      link = i;
+    }
+  }
+  if (link < 0) {
+    return false;
+  }
+
+  std::array<double, 16> step;
+  periodic.Transforms->GetTypedTuple(link, step.data());
+  std::array<double, 16> transform = { { 1, 0, 0, 0, 0, 1, 0, 0,
+					 0, 0, 1, 0, 0, 0, 0, 1 } };
+
+  // Transformed points keep the precision of the points.
+  vtkDataArray* points = output->GetPoints()->GetData();
+  const vtkIdType NumberOfPoints = points->GetNumberOfTuples();
+
+  copies->SetNumberOfPartitions(static_cast<unsigned int>(NumberOfCopies));
+  for (int k = 0; k < NumberOfCopies; ++k) {
+    vtkNew<vtkUnstructuredGrid> copy;
+    copy->ShallowCopy(output);
+
+    if (TransformPoints && k > 0) {
+      auto transformed =
+	vtkSmartPointer<vtkDataArray>::Take(points->NewInstance());
+      transformed->SetNumberOfComponents(3);
+      transformed->SetNumberOfTuples(NumberOfPoints);
+      const double* M = transform.data();
+      VisitCoordinates(points, [&](const auto* source) {
+	using ValueType =
+	  std::remove_const_t<std::remove_pointer_t<decltype(source)>>;
+	ValueType* target =
+	  static_cast<ValueType*>(transformed->GetVoidPointer(0));
+	vtkSMPTools::For(0, NumberOfPoints,
+			 [&](vtkIdType begin, vtkIdType end) {
+			   for (vtkIdType i = begin; i < end; ++i) {
+			     const ValueType* x = source + 3 * i;
+			     for (int r = 0; r < 3; ++r) {
+			       target[3 * i + r] = static_cast<ValueType>(
+				 M[4 * r] * x[0] + M[4 * r + 1] * x[1] +
+				 M[4 * r + 2] * x[2] + M[4 * r + 3]);
+			     }
+			   }
+			 });
+      });
+      vtkNew<vtkPoints> CopyPoints;
+      CopyPoints->SetData(transformed);
+      copy->SetPoints(CopyPoints);
+    }
+
+    vtkNew<vtkDoubleArray> CopyTransform;
+    CopyTransform->SetName("PeriodicTransform");
+    CopyTransform->SetNumberOfComponents(16);
+    CopyTransform->InsertNextTypedTuple(transform.data());
+    copy->GetFieldData()->AddArray(CopyTransform);
+    copies->SetPartition(static_cast<unsigned int>(k), copy);
+
+    std::array<double, 16> next{};
+    for (int r = 0; r < 4; ++r) {
+      for (int c = 0; c < 4; ++c) {
+	for (int j = 0; j < 4; ++j) {
+	  next[4 * r + c] += step[4 * r + j] * transform[4 * j + c];
+	}
+      }
+    }
+    transform = next;
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// State of the optional mesh validation: the node tags defined so far and
+// the element blocks, so that failures are reported with their block and
+// position. Only the first failure is kept.
+struct MeshValidation
+{
+  struct Block
+  {
+    int EntityDim;
+    int EntityTag;
+    int Type;
+    vtkIdType FirstCell;
+    vtkIdType NumberOfCells;
+  };
+
+  std::vector<unsigned char> DefinedNodes;
+  std::size_t NumberOfNodes = 0;
+  std::vector<Block> ElementBlocks;
+  std::string Error;
+
+  void Fail(const std::string& message)
+  {
+    if (this->Error.empty()) {
+      this->Error = message;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+std::string DescribeBlock(const char* section, int EntityDim, int EntityTag)
+{
+  return std::string("$") + section + " block of entity (" +
+    std::to_string(EntityDim) + ", " + std::to_string(EntityTag) + ")";
+}
+
+//----------------------------------------------------------------------------
+// Check in parallel that every cell vertex is a node defined in $Nodes,
+// reporting the first cell that is not.
+bool ValidateConnectivity(const MeshArrays& mesh, MeshValidation& validation)
+{
+  const vtkIdType NumberOfCells = mesh.CellTypes->GetNumberOfValues();
+  const vtkIdType NumberOfNodes =
+    static_cast<vtkIdType>(validation.DefinedNodes.size());
+  const unsigned char* Defined = validation.DefinedNodes.data();
+
+  // First cell with an undefined vertex, and that vertex.
+  vtkIdType cell = NumberOfCells;
+  vtkIdType node = 0;
+  VisitCells(mesh.Offsets, mesh.Connectivity, [&](const auto* CellOffsets,
+						 const auto* CellNodes) {
+    std::atomic<vtkIdType> FirstInvalid(NumberOfCells);
+    vtkSMPTools::For(0, NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i) {
+	if (i >= FirstInvalid.load(std::memory_order_relaxed)) {
+	  return;
+	}
+	for (vtkIdType k = CellOffsets[i]; k < CellOffsets[i + 1]; ++k) {
+	  const vtkIdType vertex = CellNodes[k];
+	  if (vertex < 0 || vertex >= NumberOfNodes || !Defined[vertex]) {
+	    vtkIdType current = FirstInvalid.load();
+	    while (i < current &&
+		   !FirstInvalid.compare_exchange_weak(current, i)) {
+	    }
+	    return;
+	  }
+	}
+      }
+    });
+
+    cell = FirstInvalid.load();
+    if (cell == NumberOfCells) {
+      return;
+    }
+    for (vtkIdType k = CellOffsets[cell]; k < CellOffsets[cell + 1]; ++k) {
+      node = CellNodes[k];
+      if (node < 0 || node >= NumberOfNodes || !Defined[node]) {
+	break;
+      }
+    }
+  });
+  if (cell == NumberOfCells) {
+    return true;
+  }
+
+  const auto& blocks = validation.ElementBlocks;
+  const auto block = std::upper_bound(blocks.begin(), blocks.end(), cell,
+    [](vtkIdType id, const MeshValidation::Block& b) {
+      return id < b.FirstCell;
+    }) - 1;
+  validation.Fail("Element " + std::to_string(cell - block->FirstCell) +
+		  " of the " +
+		  DescribeBlock("Elements", block->EntityDim,
+				block->EntityTag) +
+		  " references node tag " + std::to_string(node + 1) +
+		  ", which is not defined in $Nodes.");
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Count the components of the fields of the views enabled in selection,
+// once per field with the largest number of components of its views, and
+// of those of them the user selected.
+void CountComponents(const std::vector<DataView>& views,
+		     vtkDataArraySelection* selection,
+		     const std::set<std::string>& selected,
+		     double& components, double& SelectedComponents)
+{
+  std::map<std::string, int> counts;
+  for (const DataView& view : views) {
+    if (selection->ArrayIsEnabled(view.Name.c_str())) {
+      int& count = counts[view.Name];
+      count = std::max(count, view.NumberOfComponents);
+    }
+  }
+  components = 0.0;
+  SelectedComponents = 0.0;
+  for (const auto& field : counts) {
+    components += field.second;
+    if (selected.count(field.first)) {
+      SelectedComponents += field.second;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Selection of the arrays enabled in selection that the user selected,
+// which are read when the other fields are dropped for the memory budget.
+vtkSmartPointer<vtkDataArraySelection> GetSelectedArrays(
+  vtkDataArraySelection* selection, const std::set<std::string>& selected)
+{
+  auto restricted = vtkSmartPointer<vtkDataArraySelection>::New();
+  for (int i = 0; i < selection->GetNumberOfArrays(); ++i) {
+    const char* name = selection->GetArrayName(i);
+    restricted->AddArray(
+      name, selection->ArrayIsEnabled(name) && selected.count(name) > 0);
+  }
+  return restricted;
+}
+
+//----------------------------------------------------------------------------
+// Record whether the user selected an array, returning whether that
+// changed.
+bool UpdateSelected(std::set<std::string>& selected, const char* name,
+		    int status)
+{
+  return status ? selected.insert(name).second : selected.erase(name) > 0;
+}
+
+//----------------------------------------------------------------------------
+// Names of the reductions of each degradation level, for messages. The
+// levels are those of GmshCore.
+static_assert(vtkGmshReader::DEGRADE_BOUNDARY ==
+		static_cast<int>(GmshCore::Degradation::Boundary),
+	      "Degradation levels differ from GmshCore");
+const char* const DegradationNames[] = {
+  "", "32-bit connectivity", "float coordinates",
+  "no field data but the selected fields", "lower-dimensional elements only"
+};
+
+//----------------------------------------------------------------------------
+// File reading policy of a vtkGmshReader::IOPolicies value.
+GmshCore::IOPolicy ToIOPolicy(int policy)
+{
+  switch (policy) {
+  case vtkGmshReader::DROP_BEHIND_IO:
+    return GmshCore::IOPolicy::DropBehind;
+  case vtkGmshReader::DIRECT_IO:
+    return GmshCore::IOPolicy::Direct;
+  default:
+    return GmshCore::IOPolicy::Buffered;
+  }
+}
+}
+
+//----------------------------------------------------------------------------
+struct vtkGmshReader::vtkInternals
+{
+  // Files given through AddFileName, each of them one time step.
+  std::vector<std::string> FileNames;
+
+  // Index of each file read, and the time steps they provide.
+  std::vector<FileIndex> Files;
+  std::vector<double> TimeSteps;
+
+  // Mesh, with the properties it was read with: the signature of the
+  // files it applies to, the piece of their mesh and the entities it
+  // holds, and the options it was built and checked with.
+  MeshArrays Mesh;
+  GmshCore::MeshKey MeshKey;
+
+  // Decoded node and element blocks of the meshes read by entity, kept
+  // across selections and file indexing.
+  GmshCore::BlockCache Blocks;
+
+  // Trace of the current indexing pass and update, when recorded.
+  std::unique_ptr<GmshCore::Trace> Trace;
+
+  // Arrays of every file sharing the mesh, decoded at once when
+  // LoadFilesConcurrently is on and valid until the reader is modified.
+  std::vector<std::shared_ptr<const FieldArrays>> DecodedFiles;
+  vtkMTimeType DecodedTime = 0;
+
+  // Point-to-cell links of the mesh cells, kept with the mesh when the
+  // cells are neither exploded nor linearized.
+  vtkSmartPointer<vtkStaticCellLinks> Links;
+
+  // Quality metrics of the mesh cells and their statistics.
+  std::vector<vtkSmartPointer<vtkDoubleArray>> QualityArrays;
+  std::vector<vtkSmartPointer<vtkDoubleArray>> QualityStatistics;
+
+  // Periodic links of the mesh, read when first needed.
+  PeriodicArrays Periodic;
+
+  // Reductions planned for the memory budget at the last update.
+  GmshCore::LoadPlan Plan;
+
+  // Point and cell arrays selected through SetPointArrayStatus and
+  // SetCellArrayStatus, which are kept when the other fields are dropped
+  // for the memory budget.
+  std::set<std::string> SelectedPointArrays;
+  std::set<std::string> SelectedCellArrays;
+
+  // Points of the mesh left once coincident points are merged.
+  MergedPoints Merged;
+
+  // Ids of the points and cells whose time history is read, all of them
+  // when empty, and the histories read, valid until the reader is
+  // modified.
+  std::vector<vtkIdType> HistoryPointIds;
+  std::vector<vtkIdType> HistoryCellIds;
+  std::shared_ptr<const HistoryArrays> History;
+  vtkMTimeType HistoryTime = 0;
+};
 
 vtkStandardNewMacro(vtkGmshReader);
 
@@ -34,13 +2702,51 @@ vtkStandardNewMacro(vtkGmshReader);
 vtkGmshReader::vtkGmshReader()
 {
   this->FileName = nullptr;
+  this->PointDataArraySelection = vtkDataArraySelection::New();
+  this->CellDataArraySelection = vtkDataArraySelection::New();
+  this->ExplodeCells = false;
+  this->LinearizeCells = false;
+  this->LinearizationTolerance = 1e-3;
+  this->MaximumLinearizationDepth = 3;
+  this->UseSharedMemoryCache = false;
+  this->UseSnapshotCache = false;
+  this->FollowFile = false;
+  this->LoadFilesConcurrently = false;
+  this->ParallelFirstTouch = false;
+  this->UseHugePages = false;
+  this->IOPolicy = vtkGmshReader::BUFFERED_IO;
+  this->BuildCellLinks = false;
+  this->ComputeCellQuality = false;
+  this->ReadPeriodicLinks = false;
+  this->NumberOfPeriodicCopies = 0;
+  this->TransformPeriodicCopies = true;
+  this->ReadParametricCoordinates = false;
+  this->ValidateMesh = false;
+  this->MemoryBudget = 0;
+  this->MaximumDegradation = vtkGmshReader::DEGRADE_BOUNDARY;
+  this->ReadTimeHistory = false;
+  this->StreamPieces = false;
+  this->MergePoints = false;
+  this->MergeTolerance = 0.0;
+  this->SortCellsByEntity = false;
+  this->SelectEntities = false;
+  this->EntitySelection = vtkDataArraySelection::New();
+  this->BlockCacheSize = 512;
+  this->TraceFileName = nullptr;
+  this->Internals = new vtkInternals;
   this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(2);
 }
 
 //----------------------------------------------------------------------------
 vtkGmshReader::~vtkGmshReader()
 {
   this->SetFileName(nullptr);
+  this->SetTraceFileName(nullptr);
+  this->PointDataArraySelection->Delete();
+  this->CellDataArraySelection->Delete();
+  this->EntitySelection->Delete();
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
@@ -52,109 +2758,1331 @@ int vtkGmshReader::RequestData(vtkInformation*,
   vtkUnstructuredGrid* output =
     vtkUnstructuredGrid::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  std::ifstream MshFile(this->FileName);
+  vtkInternals* internals = this->Internals;
+
+  // Spans of the update, with those of the indexing pass that preceded it,
+  // are written to the trace file once it returns.
+  if (this->TraceFileName && *this->TraceFileName && !internals->Trace) {
+    internals->Trace = std::make_unique<GmshCore::Trace>();
+  }
+  struct TraceWriter
+  {
+    vtkGmshReader* Self;
+    ~TraceWriter()
+    {
+      std::unique_ptr<GmshCore::Trace>& trace = this->Self->Internals->Trace;
+      const char* name = this->Self->TraceFileName;
+      if (trace && name && *name && !trace->Write(name)) {
+	vtkWarningWithObjectMacro(this->Self, "Could not write trace to "
+				  << name << ".");
+      }
+      trace = nullptr;
+    }
+  } writer{ this };
+  GmshCore::Trace* trace = internals->Trace.get();
+  GmshCore::Trace::Scope UpdateScope(trace, "reader", "RequestData");
+  auto CountMemory = [trace, output]() {
+    if (trace) {
+      trace->SetCounter("Output memory (KiB)",
+			static_cast<double>(output->GetActualMemorySize()));
+    }
+  };
+
+  if (internals->Files.empty()) {
+    vtkErrorMacro("No file has been indexed.");
+    return 0;
+  }
 
-  // Nodes
-  for (std::string line; std::getline(MshFile, line);) {
-    if (line == "$Nodes") {
+  vtkInformation* CopiesInfo = outputVector->GetInformationObject(1);
+  vtkPartitionedDataSet* copies = vtkPartitionedDataSet::SafeDownCast(
+    CopiesInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  // The time requested on either output.
+  double RequestedTime = 0.0;
+  for (vtkInformation* info : { outInfo, CopiesInfo }) {
+    if (info->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())) {
+      RequestedTime =
+	info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
       break;
     }
   }
 
-  int NumberOfEntityBlocks, NumberOfNodes, MinNodeTag, MaxNodeTag;
-  MshFile >> NumberOfEntityBlocks >> NumberOfNodes >> MinNodeTag >> MaxNodeTag;
+  // Each file of a series is one time step, from which the latest views
+  // are read; a single file holds all the time steps.
+  std::size_t FileId = 0;
+  double ViewTime = RequestedTime;
+  const bool IsSeries = internals->Files.size() > 1;
+  if (IsSeries) {
+    const std::vector<double>& TimeSteps = internals->TimeSteps;
+    FileId = std::upper_bound(TimeSteps.begin(), TimeSteps.end(),
+			      RequestedTime) - TimeSteps.begin();
+    FileId = FileId > 0 ? FileId - 1 : 0;
+    ViewTime = std::numeric_limits<double>::infinity();
+  }
+  const FileIndex& file = internals->Files[FileId];
+  const char* FileName = file.FileName.c_str();
+
+  // Piece of the mesh requested by a streaming pipeline.
+  using SDDP = vtkStreamingDemandDrivenPipeline;
+  int Piece = 0;
+  int NumberOfPieces = 1;
+  if (this->StreamPieces && outInfo->Has(SDDP::UPDATE_NUMBER_OF_PIECES())) {
+    Piece = outInfo->Get(SDDP::UPDATE_PIECE_NUMBER());
+    NumberOfPieces = outInfo->Get(SDDP::UPDATE_NUMBER_OF_PIECES());
+  }
+  const bool Streaming = NumberOfPieces > 1;
+
+  // Pieces and selected entities are partial meshes, read on their own.
+  const bool Partial = Streaming || this->SelectEntities;
+  std::string entities;
+  if (this->SelectEntities) {
+    vtkDataArraySelection* selection = this->EntitySelection;
+    for (int i = 0; i < selection->GetNumberOfArrays(); ++i) {
+      if (selection->GetArraySetting(i)) {
+	entities += selection->GetArrayName(i);
+	entities += '\n';
+      }
+    }
+  }
+
+  // Mesh, kept from the previous update when the file has the same $Nodes
+  // and $Elements headers (the next file of a series, or the same file in
+  // follow mode). Otherwise it is attached from the shared memory cache
+  // when another process on this node already parsed the same file, or
+  // from the snapshot file written by an earlier load. The caches hold
+  // neither parametric coordinates nor partial meshes, so the mesh is
+  // parsed again when those are requested. Partial meshes are read
+  // without the caches. Validation needs the parse, so a mesh that was not
+  // validated is read again once ValidateMesh is on, and is then never
+  // attached from the caches; it is still published to them once valid.
+  // The reductions for the memory budget are planned at every update, from
+  // the indexed block headers, as the budget and the selected fields may
+  // change between updates; the mesh is read again when its arrays do.
+  MeshArrays& mesh = internals->Mesh;
+  const GmshCore::LoadPlan& plan = internals->Plan;
+  if (this->MemoryBudget > 0 && !Partial) {
+    if (!this->PlanLoad(static_cast<int>(FileId))) {
+      return 0;
+    }
+  } else {
+    internals->Plan = GmshCore::LoadPlan();
+  }
+
+  // Every option that changes how the mesh is built or checked is part of
+  // its key.
+  const bool ReadParametric = this->ReadParametricCoordinates && !Partial;
+  const bool Validate = this->ValidateMesh && !Partial;
+  GmshCore::MeshKey request;
+  request.Signature = file.MeshSignature;
+  request.Partial = Partial;
+  request.Piece = Piece;
+  request.NumberOfPieces = NumberOfPieces;
+  request.Entities = entities;
+  request.Parametric = ReadParametric;
+  request.SortedCells = this->SortCellsByEntity;
+  request.Validated = Validate;
+  request.Plan = plan;
+  if (!mesh.Points || !GmshCore::CanReuseMesh(internals->MeshKey, request)) {
+    GmshCore::Trace::Scope scope(trace, "reader", "Read mesh");
+    // The caches hold full meshes only.
+    const bool uncached = Partial || ReadParametric ||
+      this->SortCellsByEntity || plan.Level > GmshCore::Degradation::None;
+    const bool attach = !uncached && !Validate;
+    const std::string CacheKey = this->UseSharedMemoryCache && !uncached
+      ? GetSharedMemoryName(FileName) : std::string();
+
+    if (CacheKey.empty() || !attach ||
+	!AttachSharedMesh(FileName, CacheKey, mesh)) {
+      if (!this->UseSnapshotCache || !attach ||
+	  !AttachSnapshotFile(FileName, mesh)) {
+	GmshCore::FileStream MshFile(FileName,
+				     ToIOPolicy(this->IOPolicy));
+	const bool read = Partial
+	  ? this->ReadMeshPiece(MshFile, static_cast<int>(FileId), Piece,
+				NumberOfPieces)
+	  : this->ReadMesh(MshFile, static_cast<int>(FileId));
+	if (!read) {
+	  return 0;
+	}
+	if (this->UseSnapshotCache && !uncached &&
+	    !WriteSnapshotFile(FileName, mesh)) {
+	  vtkWarningMacro("Could not write mesh snapshot next to "
+			  << FileName << ".");
+	}
+      }
+
+      if (!CacheKey.empty() && !PublishSharedMesh(FileName, CacheKey, mesh)) {
+	vtkWarningMacro("Could not publish mesh to shared memory segment "
+			<< CacheKey << ".");
+      }
+    }
+
+    internals->MeshKey = request;
+    internals->DecodedFiles.clear();
+    internals->Links = nullptr;
+    internals->QualityArrays.clear();
+    internals->QualityStatistics.clear();
+    internals->Periodic = PeriodicArrays();
+    internals->History = nullptr;
+    internals->Merged = MergedPoints();
+  }
 
-  std::size_t MaxNodeId = 0;
-  std::size_t MinNodeId = std::numeric_limits<std::size_t>::max();
-  
   vtkNew<vtkPoints> vertices;
-  vertices->SetDataTypeToDouble();
-  
-  for (std::size_t i = 0; i < NumberOfEntityBlocks; ++i) {
-    int EntityDim, EntityTag, Parametric, NumberOfNodesInBlock;
-    MshFile >> EntityDim >> EntityTag >> Parametric >> NumberOfNodesInBlock;
-
-    std::size_t NumberOfCoords = 3;
-    if (Parametric) {
-      NumberOfCoords += EntityDim;
-    }
-    
-    std::vector<std::size_t> tags;
-    for (std::size_t j = 0; j < NumberOfNodesInBlock; ++j) {
-      std::size_t tag;
-      MshFile >> tag;
-      tags.push_back(tag);
-    }
-
-    for (std::size_t j = 0; j < NumberOfNodesInBlock; ++j) {
-      std::size_t NodeTag = tags[j];
-
-      double x, y, z;
-      if (NumberOfCoords == 5) {
-	double u, v;
-	MshFile >> x >> y >> z >> u >> v; 
-      } else if (NumberOfCoords == 4) {
-	double u;
-	MshFile >> x >> y >> z >> u;
+  vertices->SetData(mesh.Points);
+  output->SetPoints(vertices);
+
+  vtkDataArray* Offsets = mesh.Offsets;
+  vtkDataArray* Connectivity = mesh.Connectivity;
+  vtkUnsignedCharArray* CellTypes = mesh.CellTypes;
+  const unsigned char* ElementTypes = mesh.ElementTypes->GetPointer(0);
+
+  vtkNew<vtkCellArray> Cells;
+  Cells->SetData(Offsets, Connectivity);
+  output->SetCells(CellTypes, Cells);
+  CountMemory();
+
+  MemoryPolicy policy;
+  policy.ParallelFirstTouch = this->ParallelFirstTouch;
+  policy.HugePages = this->UseHugePages;
+  const GmshCore::IOPolicy io = ToIOPolicy(this->IOPolicy);
+
+  // Point and cell data. For batch jobs that go through every step of a
+  // series, the files sharing the mesh are decoded at once, one file per
+  // thread, on the first update. Only the fields the user selected are
+  // read when the others are dropped to fit the memory budget.
+  vtkSmartPointer<vtkDataArraySelection> PointSelection =
+    this->PointDataArraySelection;
+  vtkSmartPointer<vtkDataArraySelection> CellSelection =
+    this->CellDataArraySelection;
+  if (plan.Level >= GmshCore::Degradation::Fields) {
+    PointSelection = GetSelectedArrays(this->PointDataArraySelection,
+				       internals->SelectedPointArrays);
+    CellSelection = GetSelectedArrays(this->CellDataArraySelection,
+				      internals->SelectedCellArrays);
+  }
+  std::shared_ptr<const FieldArrays> arrays;
+  if (IsSeries && this->LoadFilesConcurrently) {
+    if (internals->DecodedFiles.empty() ||
+	internals->DecodedTime != this->GetMTime()) {
+      GmshCore::Trace::Scope scope(trace, "reader", "Read fields of series");
+      const vtkIdType NumberOfFiles =
+	static_cast<vtkIdType>(internals->Files.size());
+      internals->DecodedFiles.assign(NumberOfFiles, nullptr);
+      vtkSMPTools::For(0, NumberOfFiles, 1,
+		       [&](vtkIdType begin, vtkIdType end) {
+	for (vtkIdType i = begin; i < end; ++i) {
+	  const FileIndex& other = internals->Files[i];
+	  if (other.MeshSignature != internals->MeshKey.Signature) {
+	    continue;
+	  }
+	  GmshCore::Trace::Scope FileScope(trace, "worker", other.FileName);
+	  auto decoded = std::make_shared<FieldArrays>();
+	  ReadFieldArrays(other, ViewTime, mesh, PointSelection,
+			  CellSelection, io, policy, trace, *decoded);
+	  internals->DecodedFiles[i] = decoded;
+	}
+      });
+      internals->DecodedTime = this->GetMTime();
+    }
+    arrays = internals->DecodedFiles[FileId];
+  }
+
+  if (!arrays) {
+    auto read = std::make_shared<FieldArrays>();
+    GmshCore::Trace::Scope scope(trace, "reader", "Read fields");
+    ReadFieldArrays(file, ViewTime, mesh, PointSelection, CellSelection, io,
+		    policy, trace, *read);
+    arrays = read;
+  }
+
+  for (const std::string& warning : arrays->Warnings) {
+    vtkWarningMacro(<< warning);
+  }
+  if (!arrays->Error.empty()) {
+    vtkErrorMacro(<< arrays->Error);
+    return 0;
+  }
+
+  for (const auto& values : arrays->PointArrays) {
+    output->GetPointData()->AddArray(values);
+  }
+  if (ReadParametric) {
+    output->GetPointData()->AddArray(mesh.Parametric);
+  }
+  for (const auto& values : arrays->CellArrays) {
+    output->GetCellData()->AddArray(values);
+  }
+
+  // Time histories, read once for all the steps so that plots over time
+  // do not read the files again at every step.
+  if (this->ReadTimeHistory && !Partial) {
+    if (!internals->History || internals->HistoryTime != this->GetMTime()) {
+      GmshCore::Trace::Scope scope(trace, "reader", "Read time histories");
+      auto history = std::make_shared<HistoryArrays>();
+      ReadHistoryArrays(internals->Files, internals->MeshKey.Signature, mesh,
+			PointSelection, CellSelection,
+			internals->HistoryPointIds, internals->HistoryCellIds,
+			io, *history);
+      internals->History = history;
+      internals->HistoryTime = this->GetMTime();
+      for (const std::string& warning : history->Warnings) {
+	vtkWarningMacro(<< warning);
+      }
+    }
+    if (!internals->History->Error.empty()) {
+      vtkErrorMacro(<< internals->History->Error);
+      return 0;
+    }
+    for (const auto& values : internals->History->Arrays) {
+      output->GetFieldData()->AddArray(values);
+    }
+  }
+
+  // Cell ranges of each dimension and entity, which linearization does
+  // not preserve.
+  if (mesh.EntityRanges && !this->LinearizeCells) {
+    output->GetFieldData()->AddArray(mesh.DimensionRanges);
+    output->GetFieldData()->AddArray(mesh.EntityRanges);
+  }
+
+  // Quality metrics, computed once per mesh before the cells are exploded
+  // or linearized, which carry them over like other cell data.
+  if (this->ComputeCellQuality) {
+    if (internals->QualityArrays.empty()) {
+      GmshCore::Trace::Scope scope(trace, "reader", "Compute cell quality");
+      ComputeQualityArrays(mesh, internals->QualityArrays,
+			   internals->QualityStatistics);
+    }
+    for (const auto& values : internals->QualityArrays) {
+      output->GetCellData()->AddArray(values);
+    }
+    for (const auto& values : internals->QualityStatistics) {
+      output->GetFieldData()->AddArray(values);
+    }
+  }
+
+  // Periodic links, read once per mesh. Their point ids are those of the
+  // whole mesh points, before points are merged or cells exploded.
+  PeriodicArrays& periodic = internals->Periodic;
+  const bool ReadPeriodic = !Partial &&
+    (this->ReadPeriodicLinks || this->NumberOfPeriodicCopies > 0);
+  if (ReadPeriodic) {
+    std::string error;
+    if (!periodic.Links && !ReadPeriodicArrays(file, io, periodic, error)) {
+      vtkErrorMacro(<< error);
+      return 0;
+    }
+  }
+  if (this->ReadPeriodicLinks && ReadPeriodic) {
+    output->GetFieldData()->AddArray(periodic.Links);
+    output->GetFieldData()->AddArray(periodic.Transforms);
+    output->GetFieldData()->AddArray(periodic.NodeOffsets);
+    output->GetFieldData()->AddArray(periodic.Nodes);
+  }
+
+  vtkSmartPointer<vtkDataArray> CellConnectivity = Connectivity;
+  const std::vector<vtkSmartPointer<vtkDoubleArray>>& CellVertexArrays =
+    arrays->CellVertexArrays;
+
+  // Coincident points, merged once per mesh and tolerance. The parsed
+  // connectivity is shared with the caches, so the merged one is a new
+  // array, and the point arrays are gathered to the points kept.
+  if (this->MergePoints && !this->ExplodeCells) {
+    MergedPoints& merged = internals->Merged;
+    if (!merged.PointIds || merged.Tolerance != this->MergeTolerance) {
+      GmshCore::Trace::Scope scope(trace, "reader", "Merge points");
+      MergeCoincidentPoints(mesh, this->MergeTolerance, merged);
+    }
+    const vtkIdType* PointIds = merged.PointIds->GetPointer(0);
+    const vtkIdType NumberOfMergedPoints =
+      merged.PointIds->GetNumberOfValues();
+
+    vtkNew<vtkPoints> KeptPoints;
+    KeptPoints->SetData(
+      GatherTuples(mesh.Points, PointIds, NumberOfMergedPoints));
+
+    vtkNew<vtkPointData> KeptPointData;
+    vtkPointData* PointData = output->GetPointData();
+    for (int i = 0; i < PointData->GetNumberOfArrays(); ++i) {
+      if (vtkDataArray* values = PointData->GetArray(i)) {
+	KeptPointData->AddArray(
+	  GatherTuples(values, PointIds, NumberOfMergedPoints));
+      }
+    }
+    KeptPointData->AddArray(merged.NodeTags);
+
+    // The periodic node pairs follow the points to their merged ids.
+    if (this->ReadPeriodicLinks && ReadPeriodic) {
+      output->GetFieldData()->AddArray(
+	MergePeriodicNodes(periodic.Nodes, merged));
+    }
+
+    vtkNew<vtkCellArray> KeptCells;
+    KeptCells->SetData(Offsets, merged.Connectivity);
+    output->SetCells(CellTypes, KeptCells);
+    output->SetPoints(KeptPoints);
+    output->GetPointData()->ShallowCopy(KeptPointData);
+    CellConnectivity = merged.Connectivity;
+  }
+
+  if (this->ExplodeCells) {
+    GmshCore::Trace::Scope scope(trace, "reader", "Explode cells");
+    // Give each cell private copies of its points, gathered in parallel
+    // from the shared points and point data through the connectivity.
+    // The exploded connectivity counts up to the number of cell vertices,
+    // which the offsets already hold, so it keeps their width.
+    const vtkIdType NumberOfCellVertices = Connectivity->GetNumberOfValues();
+    vtkNew<vtkPoints> ExplodedPoints;
+    vtkNew<vtkPointData> ExplodedPointData;
+    vtkSmartPointer<vtkDataArray> ExplodedConnectivity =
+      NewIdArray(IsNarrow(Connectivity));
+    ExplodedConnectivity->SetNumberOfValues(NumberOfCellVertices);
+    VisitCellArrays(Connectivity, ExplodedConnectivity, [&](auto* VertexArray,
+							    auto* IdArray) {
+      const auto* VertexIds = VertexArray->GetPointer(0);
+      ExplodedPoints->SetData(
+	GatherTuples(mesh.Points, VertexIds, NumberOfCellVertices));
+      vtkPointData* PointData = output->GetPointData();
+      for (int i = 0; i < PointData->GetNumberOfArrays(); ++i) {
+	if (vtkDataArray* values = PointData->GetArray(i)) {
+	  ExplodedPointData->AddArray(
+	    GatherTuples(values, VertexIds, NumberOfCellVertices));
+	}
+      }
+
+      auto* ExplodedIds = IdArray->GetPointer(0);
+      vtkSMPTools::For(0, NumberOfCellVertices,
+		       [ExplodedIds](vtkIdType begin, vtkIdType end) {
+			 std::iota(ExplodedIds + begin, ExplodedIds + end,
+				   begin);
+		       });
+    });
+    for (const auto& values : CellVertexArrays) {
+      ExplodedPointData->AddArray(values);
+    }
+
+    vtkNew<vtkCellArray> ExplodedCells;
+    ExplodedCells->SetData(Offsets, ExplodedConnectivity);
+    output->SetCells(CellTypes, ExplodedCells);
+    output->SetPoints(ExplodedPoints);
+    output->GetPointData()->ShallowCopy(ExplodedPointData);
+    CellConnectivity = ExplodedConnectivity;
+  } else {
+    for (const auto& values : CellVertexArrays) {
+      output->GetFieldData()->AddArray(values);
+    }
+  }
+
+  if (this->LinearizeCells) {
+    GmshCore::Trace::Scope scope(trace, "reader", "Linearize cells");
+    const vtkIdType pyramids = LinearizeHighOrderCells(
+      output, Offsets, CellConnectivity, ElementTypes,
+      this->LinearizationTolerance, this->MaximumLinearizationDepth);
+    if (pyramids > 0) {
+      vtkWarningMacro(<< pyramids << " high-order pyramids were reduced to "
+		      "their corners by LinearizeCells.");
+    }
+  }
+
+  // Point-to-cell links, built by VTK with threaded counting, prefix sum
+  // and filling while the connectivity is still hot in cache.
+  if (this->BuildCellLinks) {
+    const bool MeshCells =
+      !this->ExplodeCells && !this->LinearizeCells && !this->MergePoints;
+    vtkSmartPointer<vtkStaticCellLinks> links =
+      MeshCells ? internals->Links : nullptr;
+    if (!links) {
+      GmshCore::Trace::Scope scope(trace, "reader", "Build cell links");
+      links = vtkSmartPointer<vtkStaticCellLinks>::New();
+      links->SetDataSet(output);
+      links->BuildLinks();
+      if (MeshCells) {
+	internals->Links = links;
+      }
+    }
+    // Cached links were built on the output of an earlier update, which
+    // shares the mesh cells.
+    links->SetDataSet(output);
+    output->SetLinks(links);
+  }
+
+  // Copies of a periodic sector, sharing the arrays of the output.
+  if (this->NumberOfPeriodicCopies > 0 && ReadPeriodic &&
+      !BuildPeriodicCopies(output, periodic, this->NumberOfPeriodicCopies,
+			   this->TransformPeriodicCopies, copies)) {
+    vtkWarningMacro("No periodic link with an affine transform in "
+		    << FileName << "; no periodic copies were made.");
+  }
+
+  CountMemory();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkGmshReader::PlanLoad(int index)
+{
+  vtkInternals* internals = this->Internals;
+  FileIndex& file = internals->Files[index];
+  std::string error;
+  if (file.ElementBlocks.empty()) {
+    GmshCore::FileStream MshFile(file.FileName, ToIOPolicy(this->IOPolicy));
+    GmshCore::Tokenizer tokens(MshFile);
+    if (!IndexMeshBlocks(file, tokens, false, error)) {
+      vtkErrorMacro(<< error << " (" << file.FileName << ")");
+      return false;
+    }
+  }
+
+  GmshCore::OutputSizes sizes =
+    GmshCore::PredictOutputSizes(file.ElementBlocks, file.MaxNodeTag);
+  CountComponents(file.NodeDataViews, this->PointDataArraySelection,
+		  internals->SelectedPointArrays, sizes.PointComponents,
+		  sizes.ExplicitPointComponents);
+  CountComponents(file.ElementDataViews, this->CellDataArraySelection,
+		  internals->SelectedCellArrays, sizes.CellComponents,
+		  sizes.ExplicitCellComponents);
+  CountComponents(file.ElementNodeDataViews, this->CellDataArraySelection,
+		  internals->SelectedCellArrays, sizes.CellVertexComponents,
+		  sizes.ExplicitCellVertexComponents);
+
+  const double MiB = 1024.0 * 1024.0;
+  GmshCore::LoadPlan plan;
+  if (!GmshCore::PlanLoad(
+	sizes, this->MemoryBudget * MiB,
+	static_cast<GmshCore::Degradation>(this->MaximumDegradation),
+	this->ExplodeCells, plan)) {
+    vtkErrorMacro("The output of " << file.FileName << " is estimated at "
+		  << std::ceil(plan.Bytes / MiB) << " MiB"
+		  << (plan.Level > GmshCore::Degradation::None
+		      ? " with all allowed reductions" : "")
+		  << ", above the memory budget of " << this->MemoryBudget
+		  << " MiB.");
+    return false;
+  }
+
+  // Reported when they change rather than at every time step.
+  const int level = static_cast<int>(plan.Level);
+  if (level > DEGRADE_NONE && plan.Level != internals->Plan.Level) {
+    std::string reductions;
+    for (int i = DEGRADE_CONNECTIVITY; i <= level; ++i) {
+      if (i == DEGRADE_CONNECTIVITY && !plan.NarrowConnectivity) {
+	continue;
+      }
+      reductions += std::string(reductions.empty() ? "" : ", ") +
+	DegradationNames[i];
+    }
+    vtkWarningMacro("The output of " << file.FileName << " is estimated at "
+		    << std::ceil(plan.Estimate / MiB)
+		    << " MiB, above the memory budget of "
+		    << this->MemoryBudget << " MiB; it is loaded with "
+		    << reductions << " (" << std::ceil(plan.Bytes / MiB)
+		    << " MiB).");
+  }
+
+  internals->Plan = plan;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 1) {
+    info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkPartitionedDataSet");
+    return 1;
+  }
+  return this->Superclass::FillOutputPortInformation(port, info);
+}
+
+//----------------------------------------------------------------------------
+bool vtkGmshReader::ReadMesh(std::istream& MshFile, int index)
+{
+  // Fills the mesh arrays from the node and element blocks delivered by
+  // the parser, which stops after the $Elements section.
+  struct MeshBuilder : GmshCore::Handler
+  {
+    vtkGmshReader* Self = nullptr;
+    MemoryPolicy Policy;
+    MeshArrays Mesh;
+    bool ReadParametric = false;
+    bool Validate = false;
+    MeshValidation Validation;
+    // Arrays planned for the memory budget.
+    bool NarrowConnectivity = false;
+    bool FloatCoordinates = false;
+    // Element blocks of this dimension and above are skipped.
+    int SkippedDimension = std::numeric_limits<int>::max();
+    std::size_t NumberOfSkippedElements = 0;
+    std::vector<GmshCore::CellBlock> CellBlocks;
+    // Numbers of cells and cell vertices given by the element block
+    // headers, -1 when the cell arrays grow as the blocks are parsed, and
+    // those read so far.
+    vtkIdType ExpectedCells = -1;
+    vtkIdType ExpectedVertices = -1;
+    vtkIdType NumberOfCells = 0;
+    vtkIdType NumberOfCellVertices = 0;
+    GmshCore::BlockSectionHeader NodesHeader;
+    GmshCore::BlockSectionHeader ElementsHeader;
+    std::size_t MinNodeId = std::numeric_limits<std::size_t>::max();
+    std::size_t MaxNodeId = 0;
+
+    void OnNodes(const GmshCore::BlockSectionHeader& header) override
+    {
+      // Points are indexed by node tag. Tags missing from a sparse
+      // numbering leave points at the origin.
+      this->NodesHeader = header;
+      auto CreatePoints = [&](auto points) {
+	points->SetNumberOfComponents(3);
+	points->SetNumberOfTuples(header.MaxTag);
+	TouchArray(points.Get(), this->Policy);
+	this->Mesh.Points = points;
+      };
+      if (this->FloatCoordinates) {
+	CreatePoints(vtkSmartPointer<vtkFloatArray>::New());
+      } else {
+	CreatePoints(vtkSmartPointer<vtkDoubleArray>::New());
+      }
+      if (header.NumberOfEntities != header.MaxTag &&
+	  !this->Policy.ParallelFirstTouch) {
+	this->Mesh.Points->Fill(0.0);
+      }
+
+      if (this->Validate) {
+	this->Validation.DefinedNodes.assign(header.MaxTag, 0);
+      }
+
+      if (this->ReadParametric) {
+	this->Mesh.Parametric = vtkSmartPointer<vtkDoubleArray>::New();
+	vtkDoubleArray* parametric = this->Mesh.Parametric;
+	parametric->SetName("gmsh:parametric");
+	parametric->SetNumberOfComponents(3);
+	parametric->SetNumberOfTuples(header.MaxTag);
+	vtkSMPTools::Fill(parametric->GetPointer(0),
+			  parametric->GetPointer(0) + 3 * header.MaxTag,
+			  vtkMath::Nan());
+      }
+    }
+
+    bool WantsParametricCoordinates() override
+    {
+      return this->ReadParametric;
+    }
+
+    void OnNodeBlock(const GmshCore::NodeBlock& block) override
+    {
+      if (this->Validate) {
+	this->ValidateNodeBlock(block);
+      }
+
+      for (std::size_t j = 0; j < block.Tags.size(); ++j) {
+	const std::size_t NodeTag = block.Tags[j];
+	if (NodeTag == 0) {
+	  continue;
+	}
+	this->MinNodeId = std::min(this->MinNodeId, NodeTag);
+	this->MaxNodeId = std::max(this->MaxNodeId, NodeTag);
+	this->Mesh.Points->InsertTuple(NodeTag - 1,
+				       block.Coordinates.data() + 3 * j);
+      }
+
+      // One parametric coordinate per dimension of the entity.
+      const std::size_t dim = static_cast<std::size_t>(block.EntityDim);
+      if (this->Mesh.Parametric && !block.ParametricCoordinates.empty() &&
+	  dim <= 3) {
+	double* uvw = this->Mesh.Parametric->GetPointer(0);
+	for (std::size_t j = 0; j < block.Tags.size(); ++j) {
+	  const std::size_t NodeTag = block.Tags[j];
+	  if (NodeTag == 0 || NodeTag > this->NodesHeader.MaxTag) {
+	    continue;
+	  }
+	  std::copy_n(block.ParametricCoordinates.data() + dim * j, dim,
+		      uvw + 3 * (NodeTag - 1));
+	}
+      }
+    }
+
+    // Node tags are within the header range and defined only once.
+    void ValidateNodeBlock(const GmshCore::NodeBlock& block)
+    {
+      std::vector<unsigned char>& defined = this->Validation.DefinedNodes;
+      for (std::size_t j = 0; j < block.Tags.size(); ++j) {
+	const std::size_t NodeTag = block.Tags[j];
+	if (NodeTag == 0 || NodeTag > defined.size() || defined[NodeTag - 1]) {
+	  this->Validation.Fail(
+	    "Node " + std::to_string(j) + " of the " +
+	    DescribeBlock("Nodes", block.EntityDim, block.EntityTag) +
+	    " has tag " + std::to_string(NodeTag) +
+	    (NodeTag == 0 || NodeTag > defined.size()
+	     ? ", outside of the range of the $Nodes header."
+	     : ", already defined."));
+	  continue;
+	}
+	defined[NodeTag - 1] = 1;
+      }
+      this->Validation.NumberOfNodes += block.Tags.size();
+    }
+
+    void OnElements(const GmshCore::BlockSectionHeader& header) override
+    {
+      this->ElementsHeader = header;
+      MeshArrays& mesh = this->Mesh;
+
+      // Cell arrays of known size are allocated once and placed like the
+      // points; the others grow while the blocks are parsed.
+      const bool sized = this->ExpectedCells >= 0;
+      const vtkIdType cells = sized
+	? this->ExpectedCells : static_cast<vtkIdType>(header.NumberOfEntities);
+      auto Prepare = [&](auto* array, vtkIdType size) {
+	if (sized) {
+	  array->SetNumberOfValues(size);
+	  TouchArray(array, this->Policy);
+	} else {
+	  array->Allocate(size);
+	}
+      };
+      mesh.CellTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      Prepare(mesh.CellTypes.Get(), cells);
+      mesh.Offsets = NewIdArray(this->NarrowConnectivity);
+      VisitIds(mesh.Offsets, [&](auto* offsets) {
+	Prepare(offsets, cells + 1);
+	*offsets->WritePointer(0, 1) = 0;
+      });
+      mesh.Connectivity = NewIdArray(this->NarrowConnectivity);
+      if (sized) {
+	VisitIds(mesh.Connectivity, [&](auto* connectivity) {
+	  Prepare(connectivity, this->ExpectedVertices);
+	});
+      }
+
+      // Element type of each cell, used to evaluate high-order fields.
+      mesh.ElementTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+      Prepare(mesh.ElementTypes.Get(), cells);
+
+      // Cell id of each element tag in the header range, used to place
+      // the records of $ElementData views.
+      mesh.CellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+      mesh.CellIds->SetNumberOfValues(header.MaxTag >= header.MinTag
+				      ? header.MaxTag - header.MinTag + 1 : 0);
+      TouchArray(mesh.CellIds.Get(), this->Policy);
+      vtkSMPTools::Fill(mesh.CellIds->GetPointer(0),
+			mesh.CellIds->GetPointer(0) +
+			  mesh.CellIds->GetNumberOfValues(),
+			-1);
+      mesh.MinElementTag = static_cast<vtkIdType>(header.MinTag);
+    }
+
+    void OnElementBlock(const GmshCore::ElementBlock& block) override
+    {
+      if (block.EntityDim >= this->SkippedDimension) {
+	this->NumberOfSkippedElements += block.Tags.size();
+	return;
+      }
+
+      MeshArrays& mesh = this->Mesh;
+      const std::size_t NumberOfVertices = block.Type->NumberOfNodes;
+      const unsigned char CellType =
+	this->Self->GetVTKCellType(block.Type->Type);
+      const vtkIdType FirstCell = this->NumberOfCells;
+      const vtkIdType NumberOfBlockCells =
+	static_cast<vtkIdType>(block.Tags.size());
+      GmshCore::AppendCellBlock(this->CellBlocks, block.EntityDim,
+				block.EntityTag, FirstCell,
+				NumberOfBlockCells);
+
+      // The block is written in place in the cell arrays, which grow
+      // geometrically unless they were sized. Tags beyond the range of the
+      // ids are invalid.
+      const vtkIdType first = this->NumberOfCellVertices;
+      const vtkIdType count = static_cast<vtkIdType>(block.NodeTags.size());
+      VisitIds(mesh.Connectivity, [&](auto* connectivity) {
+	auto* VertexIds = connectivity->WritePointer(first, count);
+	using ValueType = std::remove_pointer_t<decltype(VertexIds)>;
+	const std::size_t limit = std::numeric_limits<ValueType>::max();
+	for (vtkIdType k = 0; k < count; ++k) {
+	  const std::size_t NodeTag = block.NodeTags[k];
+	  VertexIds[k] =
+	    NodeTag <= limit ? static_cast<ValueType>(NodeTag) - 1 : -1;
+	}
+      });
+      VisitIds(mesh.Offsets, [&](auto* offsets) {
+	auto* CellOffsets =
+	  offsets->WritePointer(FirstCell + 1, NumberOfBlockCells);
+	using ValueType = std::remove_pointer_t<decltype(CellOffsets)>;
+	for (vtkIdType j = 0; j < NumberOfBlockCells; ++j) {
+	  CellOffsets[j] = static_cast<ValueType>(
+	    first + (j + 1) * static_cast<vtkIdType>(NumberOfVertices));
+	}
+      });
+      std::fill_n(mesh.CellTypes->WritePointer(FirstCell, NumberOfBlockCells),
+		  NumberOfBlockCells, CellType);
+      std::fill_n(
+	mesh.ElementTypes->WritePointer(FirstCell, NumberOfBlockCells),
+	NumberOfBlockCells, static_cast<unsigned char>(block.Type->Type));
+
+      const std::size_t MinElementTag =
+	static_cast<std::size_t>(mesh.MinElementTag);
+      const std::size_t NumberOfCellIds =
+	static_cast<std::size_t>(mesh.CellIds->GetNumberOfValues());
+      if (this->Validate) {
+	this->ValidateElementBlock(block);
+      }
+      for (std::size_t j = 0; j < block.Tags.size(); ++j) {
+	const std::size_t ElementTag = block.Tags[j];
+	const vtkIdType CellId = FirstCell + static_cast<vtkIdType>(j);
+	const bool inside = ElementTag >= MinElementTag &&
+	  ElementTag - MinElementTag < NumberOfCellIds;
+	if (this->Validate && (!inside ||
+	    mesh.CellIds->GetValue(ElementTag - MinElementTag) >= 0)) {
+	  this->FailElementTag(block, CellId, ElementTag, inside);
+	}
+	if (inside) {
+	  mesh.CellIds->SetValue(ElementTag - MinElementTag, CellId);
+	}
+      }
+      this->NumberOfCells += NumberOfBlockCells;
+      this->NumberOfCellVertices += count;
+    }
+
+    // Record the cells of a block, to report failures with their position.
+    // Blocks larger than the parser chunks are delivered in several calls,
+    // which extend the same block.
+    void ValidateElementBlock(const GmshCore::ElementBlock& block)
+    {
+      const vtkIdType FirstCell = this->NumberOfCells;
+      const vtkIdType NumberOfCells =
+	static_cast<vtkIdType>(block.Tags.size());
+      auto& blocks = this->Validation.ElementBlocks;
+      if (!blocks.empty() && blocks.back().EntityDim == block.EntityDim &&
+	  blocks.back().EntityTag == block.EntityTag &&
+	  blocks.back().Type == block.Type->Type &&
+	  blocks.back().FirstCell + blocks.back().NumberOfCells == FirstCell) {
+	blocks.back().NumberOfCells += NumberOfCells;
       } else {
-	MshFile >> x >> y >> z;
+	blocks.push_back({ block.EntityDim, block.EntityTag, block.Type->Type,
+			   FirstCell, NumberOfCells });
+      }
+    }
+
+    // Element tags are within the header range and defined only once.
+    void FailElementTag(const GmshCore::ElementBlock& block,
+			vtkIdType CellId, std::size_t ElementTag, bool inside)
+    {
+      const vtkIdType position =
+	CellId - this->Validation.ElementBlocks.back().FirstCell;
+      this->Validation.Fail(
+	"Element " + std::to_string(position) + " of the " +
+	DescribeBlock("Elements", block.EntityDim, block.EntityTag) +
+	" has tag " + std::to_string(ElementTag) +
+	(inside ? ", already defined."
+	 : ", outside of the range of the $Elements header."));
+    }
+
+    bool OnDataView(GmshCore::DataKind,
+		    const GmshCore::DataViewHeader&) override
+    {
+      return false;
+    }
+
+    bool OnEndSection(const std::string& name) override
+    {
+      // The blocks hold as many entities as their section header says.
+      if (this->Validate && (name == "Nodes" || name == "Elements")) {
+	const bool nodes = name == "Nodes";
+	const std::size_t expected = nodes
+	  ? this->NodesHeader.NumberOfEntities
+	  : this->ElementsHeader.NumberOfEntities;
+	const std::size_t found = nodes ? this->Validation.NumberOfNodes
+	  : static_cast<std::size_t>(this->NumberOfCells) +
+	    this->NumberOfSkippedElements;
+	if (expected != found) {
+	  this->Validation.Fail("The $" + name + " header announces " +
+				std::to_string(expected) + " entities, " +
+				"but its blocks hold " +
+				std::to_string(found) + ".");
+	}
+      }
+      return name != "Elements";
+    }
+  };
+
+  MeshBuilder builder;
+  builder.Self = this;
+  builder.Policy.ParallelFirstTouch = this->ParallelFirstTouch;
+  builder.Policy.HugePages = this->UseHugePages;
+  builder.ReadParametric = this->ReadParametricCoordinates;
+  builder.Validate = this->ValidateMesh;
+  const GmshCore::LoadPlan& plan = this->Internals->Plan;
+  builder.NarrowConnectivity = plan.NarrowConnectivity;
+  builder.FloatCoordinates = plan.FloatCoordinates;
+  if (plan.Level >= GmshCore::Degradation::Boundary) {
+    builder.SkippedDimension = plan.MeshDimension;
+  }
+
+  GmshCore::Tokenizer tokens(MshFile);
+  tokens.SetTrace(this->Internals->Trace.get());
+  std::string error;
+
+  // The element block headers size the cell arrays, so that the memory
+  // policies place them as they are allocated rather than by a copy once
+  // complete. They are indexed for the policies, or were by the memory
+  // budget.
+  FileIndex& file = this->Internals->Files[index];
+  if (this->ParallelFirstTouch || this->UseHugePages ||
+      !file.ElementBlocks.empty()) {
+    if (!IndexMeshBlocks(file, tokens, false, error)) {
+      vtkErrorMacro(<< error);
+      return false;
+    }
+    builder.ExpectedCells = 0;
+    builder.ExpectedVertices = 0;
+    for (const GmshCore::ElementBlockHeader& block : file.ElementBlocks) {
+      if (block.EntityDim < builder.SkippedDimension) {
+	const vtkIdType cells = static_cast<vtkIdType>(block.NumberOfElements);
+	builder.ExpectedCells += cells;
+	builder.ExpectedVertices += cells * block.Type->NumberOfNodes;
+      }
+    }
+    tokens.Seek(0);
+  }
+
+  if (!GmshCore::Parse(tokens, builder, error)) {
+    vtkErrorMacro(<< error);
+    return false;
+  }
+
+  if (!builder.Mesh.Points || !builder.Mesh.Offsets) {
+    vtkErrorMacro("Missing $Nodes or $Elements section.");
+    return false;
+  }
+  if (builder.NumberOfCells != builder.Mesh.CellTypes->GetNumberOfValues() ||
+      builder.NumberOfCellVertices !=
+	builder.Mesh.Connectivity->GetNumberOfValues()) {
+    vtkErrorMacro("The $Elements blocks do not hold the elements their "
+		  "headers announce.");
+    return false;
+  }
+
+  // Validation failures are reported with the block and position of the
+  // first offending node or element.
+  if (builder.Validate &&
+      (!builder.Validation.Error.empty() ||
+       !ValidateConnectivity(builder.Mesh, builder.Validation))) {
+    vtkErrorMacro("Invalid mesh: " << builder.Validation.Error);
+    return false;
+  }
+
+  // Consistency check
+  const GmshCore::BlockSectionHeader& header = builder.NodesHeader;
+  if (header.NumberOfEntities > 0 &&
+      (header.MinTag != builder.MinNodeId ||
+       header.MaxTag != builder.MaxNodeId)) {
+    vtkWarningMacro("Min/Max node tags reported in section header are wrong: "
+		    << "(" << header.MinTag << "/" << header.MaxTag << ") != "
+		    << "(" << builder.MinNodeId << "/" << builder.MaxNodeId
+		    << ")");
+  }
+
+  MeshArrays& mesh = builder.Mesh;
+  if (this->SortCellsByEntity) {
+    SortCells(mesh, builder.CellBlocks, builder.Policy);
+  }
+
+  this->Internals->Mesh = mesh;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkGmshReader::ReadMeshPiece(std::istream& MshFile, int index, int piece,
+				  int NumberOfPieces)
+{
+  FileIndex& file = this->Internals->Files[index];
+  GmshCore::Trace* trace = this->Internals->Trace.get();
+  GmshCore::Tokenizer tokens(MshFile);
+  tokens.SetTrace(trace);
+  std::string error;
+
+  // The block headers are indexed by the first piece read, with the
+  // offsets of their content and the range of the tags of the node blocks,
+  // so that only the node blocks holding points of the piece are read.
+  // Whole meshes are read through the block cache, block by block.
+  GmshCore::BlockCache& cache = this->Internals->Blocks;
+  cache.SetCapacity(static_cast<std::size_t>(this->BlockCacheSize) << 20);
+  const bool cached = NumberOfPieces == 1 && this->BlockCacheSize > 0;
+  if (!IndexMeshBlocks(file, tokens, true, error)) {
+    vtkErrorMacro(<< error);
+    return false;
+  }
+
+  // Blocks are taken from the cache, or decoded whole and kept there.
+  auto Decode = [&](std::streamoff offset, auto read) {
+    std::shared_ptr<const GmshCore::DecodedBlock> decoded =
+      cache.Find({ file.Identity, offset });
+    if (!decoded) {
+      auto block = std::make_shared<GmshCore::DecodedBlock>();
+      if (read(*block)) {
+	cache.Insert({ file.Identity, offset }, block);
+	decoded = block;
+      }
+    }
+    return decoded;
+  };
+
+  // Only the blocks of the enabled entities are read when selecting them.
+  std::vector<const GmshCore::ElementBlockHeader*> blocks;
+  for (const auto& block : file.ElementBlocks) {
+    if (!this->SelectEntities ||
+	this->EntitySelection->ArrayIsEnabled(
+	  GetEntityName(block.EntityDim, block.EntityTag).c_str())) {
+      blocks.push_back(&block);
+    }
+  }
+
+  // Collects the cells of the piece with the node tags of their vertices,
+  // then the coordinates of those nodes.
+  struct PieceBuilder : GmshCore::Handler
+  {
+    vtkGmshReader* Self = nullptr;
+    MeshArrays Mesh;
+    // Pieces are read at full width, as they are not planned.
+    vtkSmartPointer<vtkIdTypeArray> Offsets;
+    vtkSmartPointer<vtkDoubleArray> Points;
+    std::vector<std::size_t> ElementTags;
+    std::vector<std::size_t> Vertices;
+    std::vector<GmshCore::CellBlock> CellBlocks;
+
+    void OnElementBlock(const GmshCore::ElementBlock& block) override
+    {
+      MeshArrays& mesh = this->Mesh;
+      const std::size_t NumberOfVertices = block.Type->NumberOfNodes;
+      const unsigned char CellType =
+	this->Self->GetVTKCellType(block.Type->Type);
+      GmshCore::AppendCellBlock(this->CellBlocks, block.EntityDim,
+				block.EntityTag,
+				mesh.CellTypes->GetNumberOfValues(),
+				static_cast<vtkIdType>(block.Tags.size()));
+      for (std::size_t j = 0; j < block.Tags.size(); ++j) {
+	this->ElementTags.push_back(block.Tags[j]);
+	mesh.CellTypes->InsertNextValue(CellType);
+	mesh.ElementTypes->InsertNextValue(
+	  static_cast<unsigned char>(block.Type->Type));
+	this->Offsets->InsertNextValue(static_cast<vtkIdType>(
+	  this->Vertices.size() + (j + 1) * NumberOfVertices));
+      }
+      this->Vertices.insert(this->Vertices.end(), block.NodeTags.begin(),
+			    block.NodeTags.end());
+    }
+
+    void OnNodeBlock(const GmshCore::NodeBlock& block) override
+    {
+      const std::vector<std::size_t>& NodeTags = this->Mesh.NodeTags;
+      double* Points = this->Points->GetPointer(0);
+      for (std::size_t j = 0; j < block.Tags.size(); ++j) {
+	auto it = std::lower_bound(NodeTags.begin(), NodeTags.end(),
+				   block.Tags[j]);
+	if (it != NodeTags.end() && *it == block.Tags[j]) {
+	  std::copy_n(block.Coordinates.data() + 3 * j, 3,
+		      Points + 3 * (it - NodeTags.begin()));
+	}
+      }
+    }
+  };
+
+  PieceBuilder builder;
+  builder.Self = this;
+  MeshArrays& mesh = builder.Mesh;
+  mesh.Piece = true;
+  mesh.CellTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  mesh.ElementTypes = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  builder.Offsets = vtkSmartPointer<vtkIdTypeArray>::New();
+  builder.Offsets->InsertNextValue(0);
+  mesh.Offsets = builder.Offsets;
+
+  // Each piece is an equal range of the elements in file order, so that
+  // it holds consecutive entities of which only the first and the last
+  // may be split with the neighboring pieces.
+  std::size_t NumberOfElements = 0;
+  for (const auto* block : blocks) {
+    NumberOfElements += block->NumberOfElements;
+  }
+  const std::size_t first = NumberOfElements * piece / NumberOfPieces;
+  const std::size_t last = NumberOfElements * (piece + 1) / NumberOfPieces;
+
+  std::size_t BlockFirst = 0;
+  for (const auto* block : blocks) {
+    const std::size_t BlockLast = BlockFirst + block->NumberOfElements;
+    const std::size_t begin = std::max(first, BlockFirst);
+    const std::size_t end = std::min(last, BlockLast);
+    if (begin < end && cached) {
+      auto read = [&](GmshCore::DecodedBlock& target) {
+	return GmshCore::ReadElementBlock(tokens, *block, 0,
+					  block->NumberOfElements, target,
+					  error);
+      };
+      auto decoded = Decode(block->Offset, read);
+      if (!decoded) {
+	vtkErrorMacro(<< error);
+	return false;
+      }
+      builder.OnElementBlock(decoded->GetElementBlock());
+    } else if (begin < end &&
+	       !GmshCore::ReadElementBlock(tokens, *block, begin - BlockFirst,
+					   end - begin, builder, error)) {
+      vtkErrorMacro(<< error);
+      return false;
+    }
+    BlockFirst = BlockLast;
+  }
+
+  // The points are the nodes of the cells, in tag order.
+  std::vector<std::size_t>& NodeTags = mesh.NodeTags;
+  NodeTags = builder.Vertices;
+  vtkSMPTools::Sort(NodeTags.begin(), NodeTags.end());
+  NodeTags.erase(std::unique(NodeTags.begin(), NodeTags.end()),
+		 NodeTags.end());
+
+  const vtkIdType NumberOfVertices =
+    static_cast<vtkIdType>(builder.Vertices.size());
+  auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+  connectivity->SetNumberOfValues(NumberOfVertices);
+  mesh.Connectivity = connectivity;
+  vtkIdType* VertexIds = connectivity->GetPointer(0);
+  const std::size_t* Vertices = builder.Vertices.data();
+  vtkSMPTools::For(0, NumberOfVertices, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i) {
+      VertexIds[i] = std::lower_bound(NodeTags.begin(), NodeTags.end(),
+				      Vertices[i]) - NodeTags.begin();
+    }
+  });
+  std::vector<std::size_t>().swap(builder.Vertices);
+
+  builder.Points = vtkSmartPointer<vtkDoubleArray>::New();
+  builder.Points->SetNumberOfComponents(3);
+  builder.Points->SetNumberOfTuples(static_cast<vtkIdType>(NodeTags.size()));
+  builder.Points->Fill(0.0);
+  mesh.Points = builder.Points;
+  if (cached) {
+    // Only the node blocks holding nodes of the selected entities are
+    // decoded, whole so that other selections can use them.
+    for (const auto& block : file.NodeBlocks) {
+      if (!HasNodeTags(block, NodeTags)) {
+	continue;
+      }
+      auto read = [&](GmshCore::DecodedBlock& target) {
+	return GmshCore::ReadNodeBlock(tokens, block, target, error);
+      };
+      auto decoded = Decode(block.Offset, read);
+      if (!decoded) {
+	vtkErrorMacro(<< error);
+	return false;
+      }
+      builder.OnNodeBlock(decoded->GetNodeBlock());
+    }
+    if (trace) {
+      trace->SetCounter("Block cache (KiB)",
+			static_cast<double>(cache.GetSize() >> 10));
+    }
+  } else {
+    for (const auto& block : file.NodeBlocks) {
+      if (HasNodeTags(block, NodeTags) &&
+	  !GmshCore::ReadNodeBlock(tokens, block, NodeTags, builder, error)) {
+	vtkErrorMacro(<< error);
+	return false;
+      }
+    }
+  }
+
+  // Cell id of each element tag over the range of the tags of the piece,
+  // which is narrow for consecutive entities.
+  mesh.CellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+  const std::vector<std::size_t>& ElementTags = builder.ElementTags;
+  if (!ElementTags.empty()) {
+    const auto range =
+      std::minmax_element(ElementTags.begin(), ElementTags.end());
+    mesh.MinElementTag = static_cast<vtkIdType>(*range.first);
+    mesh.CellIds->SetNumberOfValues(
+      static_cast<vtkIdType>(*range.second - *range.first + 1));
+    mesh.CellIds->Fill(-1);
+    for (std::size_t i = 0; i < ElementTags.size(); ++i) {
+      mesh.CellIds->SetValue(
+	static_cast<vtkIdType>(ElementTags[i] - *range.first),
+	static_cast<vtkIdType>(i));
+    }
+  }
+
+  if (this->SortCellsByEntity) {
+    SortCells(mesh, builder.CellBlocks, MemoryPolicy());
+  }
+
+  this->Internals->Mesh = std::move(mesh);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::RequestInformation(vtkInformation*, vtkInformationVector**,
+				      vtkInformationVector* outputVector)
+{
+  vtkInternals* internals = this->Internals;
+
+  // A trace is started by each indexing pass and written by the update
+  // that follows it.
+  internals->Trace = nullptr;
+  if (this->TraceFileName && *this->TraceFileName) {
+    internals->Trace = std::make_unique<GmshCore::Trace>();
+  }
+  GmshCore::Trace::Scope scope(internals->Trace.get(), "reader",
+			       "RequestInformation");
+
+  std::vector<std::string> FileNames = internals->FileNames;
+  if (FileNames.empty() && this->FileName) {
+    FileNames.push_back(this->FileName);
+  }
+
+  if (FileNames.empty()) {
+    vtkErrorMacro("FileName has to be specified.");
+    return 0;
+  }
+
+  // Index the data sections so that RequestData can seek straight to the
+  // views it needs. In follow mode, indexing resumes where the previous
+  // pass stopped as long as the files only grew.
+  const bool resume = this->FollowFile &&
+    internals->Files.size() == FileNames.size() &&
+    std::equal(FileNames.begin(), FileNames.end(), internals->Files.begin(),
+	       [](const std::string& name, const FileIndex& file) {
+		 return name == file.FileName;
+	       });
+  // Otherwise, the index of a file whose name, size and modification time
+  // did not change since the previous pass is kept as is, and so are the
+  // mesh and the arrays cached with it when no file had to be indexed
+  // again, so that changing a selection does not read the files again.
+  // Refresh drops the previous index to force a full pass.
+  std::vector<FileIndex> previous;
+  std::vector<bool> kept(FileNames.size(), false);
+  if (!resume) {
+    previous.swap(internals->Files);
+    internals->Files.assign(FileNames.size(), FileIndex());
+    bool reindexed = false;
+    for (std::size_t i = 0; i < FileNames.size(); ++i) {
+      const std::string identity = GetFileIdentity(FileNames[i]);
+      for (FileIndex& other : previous) {
+	if (!identity.empty() && other.Identity == identity) {
+	  internals->Files[i] = other;
+	  kept[i] = true;
+	  break;
+	}
       }
+      if (!kept[i]) {
+	internals->Files[i].FileName = FileNames[i];
+	reindexed = true;
+      }
+    }
+    if (reindexed || previous.size() != FileNames.size()) {
+      internals->Mesh = MeshArrays();
+      internals->MeshKey = GmshCore::MeshKey();
+    }
+  }
+  internals->DecodedFiles.clear();
+  internals->History = nullptr;
 
-      MinNodeId = std::min(MinNodeId, NodeTag);
-      MaxNodeId = std::max(MaxNodeId, NodeTag);
+  for (std::size_t i = 0; i < internals->Files.size(); ++i) {
+    if (!kept[i] && !this->IndexFile(static_cast<int>(i))) {
+      internals->Files.clear();
+      return 0;
+    }
+  }
 
-      vertices->InsertPoint(NodeTag-1, x, y, z);
+  // Block headers are kept for the files that did not change.
+  for (FileIndex& file : internals->Files) {
+    for (FileIndex& other : previous) {
+      if (other.Identity == file.Identity) {
+	file.NodeBlocks = std::move(other.NodeBlocks);
+	file.ElementBlocks = std::move(other.ElementBlocks);
+	break;
+      }
     }
   }
 
-  // Consistency check
-  if (MinNodeTag != MinNodeId || MaxNodeTag != MaxNodeId) {
-    vtkWarningMacro("Min/Max node tags reported in section header are wrong: "
-		    << "(" << MinNodeTag << "/" << MaxNodeTag << ") != "
-		    << "(" << MinNodeId << "/" << MaxNodeId << ")");
+  // Entities are listed from the element block headers of each mesh.
+  if (this->SelectEntities) {
+    std::set<std::string> signatures;
+    for (FileIndex& file : internals->Files) {
+      if (!signatures.insert(file.MeshSignature).second) {
+	continue;
+      }
+      GmshCore::FileStream MshFile(file.FileName,
+				   ToIOPolicy(this->IOPolicy));
+      GmshCore::Tokenizer tokens(MshFile);
+      tokens.SetTrace(internals->Trace.get());
+      std::string error;
+      if (!IndexMeshBlocks(file, tokens, false, error)) {
+	vtkErrorMacro(<< error << " (" << file.FileName << ")");
+	internals->Files.clear();
+	return 0;
+      }
+      for (const auto& block : file.ElementBlocks) {
+	this->EntitySelection->AddArray(
+	  GetEntityName(block.EntityDim, block.EntityTag).c_str());
+      }
+    }
   }
 
-  output->SetPoints(vertices);
-
-  // Cells
-  for (std::string line; std::getline(MshFile, line);) {
-    if (line == "$Elements") {
-      break;
+  for (const FileIndex& file : internals->Files) {
+    for (const auto& view : file.NodeDataViews) {
+      this->PointDataArraySelection->AddArray(view.Name.c_str());
+    }
+    for (const auto* views :
+	   { &file.ElementDataViews, &file.ElementNodeDataViews }) {
+      for (const auto& view : *views) {
+	this->CellDataArraySelection->AddArray(view.Name.c_str());
+      }
     }
   }
 
-  int NumberOfElements, MinElementTag, MaxElementTag;
-  MshFile >> NumberOfEntityBlocks >> NumberOfElements >> MinElementTag >> MaxElementTag;
-
-  std::size_t MaxElementId = 0;
-  std::size_t MinElementId = std::numeric_limits<std::size_t>::max();
-
-  output->Allocate(NumberOfElements);
-  vtkNew<vtkIdList> ids;
-  
-  for (std::size_t i = 0; i < NumberOfEntityBlocks; ++i) {
-    int EntityDim, EntityTag, ElementType, NumberOfElementsInBlock;
-    MshFile >> EntityDim >> EntityTag >> ElementType >> NumberOfElementsInBlock;
-
-    const int NumberOfVerticesPerElement =
-      this->GetNumberOfVerticesForElementType(ElementType);
-
-    for (std::size_t j = 0; j < NumberOfElementsInBlock; ++j) {
-      std::size_t ElementTag;
-      MshFile >> ElementTag;
-
-      ids->SetNumberOfIds(NumberOfVerticesPerElement);
-      
-      for (int k = 0; k < NumberOfVerticesPerElement; ++k) {
-	std::size_t VertexTag;
-	MshFile >> VertexTag;
-	ids->SetId(k, VertexTag-1);
+  // A single file provides the times of its views. Each file of a series
+  // is one time step, at the latest time of its views when that increases
+  // from file to file, or at its index in the series otherwise.
+  std::vector<double>& TimeSteps = internals->TimeSteps;
+  TimeSteps.clear();
+  if (internals->Files.size() == 1) {
+    TimeSteps = internals->Files.front().TimeSteps;
+    std::sort(TimeSteps.begin(), TimeSteps.end());
+    TimeSteps.erase(std::unique(TimeSteps.begin(), TimeSteps.end()),
+		    TimeSteps.end());
+  } else {
+    bool increasing = true;
+    for (const FileIndex& file : internals->Files) {
+      if (file.TimeSteps.empty()) {
+	increasing = false;
+	break;
       }
+      const double time =
+	*std::max_element(file.TimeSteps.begin(), file.TimeSteps.end());
+      increasing = TimeSteps.empty() || time > TimeSteps.back();
+      if (!increasing) {
+	break;
+      }
+      TimeSteps.push_back(time);
+    }
+    if (!increasing) {
+      TimeSteps.resize(internals->Files.size());
+      std::iota(TimeSteps.begin(), TimeSteps.end(), 0.0);
+    }
+  }
 
-      MinElementId = std::min(MinElementId, ElementTag);
-      MaxElementId = std::min(MaxElementId, ElementTag);
+  for (int port = 0; port < this->GetNumberOfOutputPorts(); ++port) {
+    vtkInformation *outInfo = outputVector->GetInformationObject(port);
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    outInfo->Remove(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST());
+    if (this->StreamPieces) {
+      outInfo->Set(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST(), 1);
+    }
 
-      output->InsertNextCell(this->GetVTKCellType(ElementType), ids);
+    if (!TimeSteps.empty()) {
+      double TimeRange[2] = { TimeSteps.front(), TimeSteps.back() };
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
+		   TimeSteps.data(), static_cast<int>(TimeSteps.size()));
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(),
+		   TimeRange, 2);
     }
   }
 
@@ -162,25 +4090,26 @@ int vtkGmshReader::RequestData(vtkInformation*,
 }
 
 //----------------------------------------------------------------------------
-int vtkGmshReader::RequestInformation(vtkInformation*, vtkInformationVector**,
-				      vtkInformationVector* outputVector)
+bool vtkGmshReader::IndexFile(int index)
 {
-  if (!this->FileName) {
-    vtkErrorMacro("FileName has to be specified.");
-    return 0;
-  }
+  vtkInternals* internals = this->Internals;
+  FileIndex& file = internals->Files[index];
+  GmshCore::Trace::Scope scope(internals->Trace.get(), "reader",
+			       "Index " + file.FileName);
 
   // $MeshFormat section.
   double FormatVersionNumber;
   int FileType;  // 0 for ASCII, 1 for binary.
   int DataSize;  // sizeof(size_t).
 
-  std::ifstream MshFile(this->FileName);
+  GmshCore::FileStream MshFile(file.FileName,
+			       ToIOPolicy(this->IOPolicy));
   std::string line;
   MshFile >> line;
   if (line != "$MeshFormat") {
-    vtkErrorMacro("Expected $MeshFormat in first line.");
-    return 0;
+    vtkErrorMacro("Expected $MeshFormat in first line of "
+		  << file.FileName << ".");
+    return false;
   }
 
   MshFile >> FormatVersionNumber >> FileType >> DataSize;
@@ -188,22 +4117,259 @@ int vtkGmshReader::RequestInformation(vtkInformation*, vtkInformationVector**,
   // TODO: implement 2.0 and 3.0 formats.
   if (FormatVersionNumber < 4.0) {
     vtkErrorMacro("Reader can only read MSH file format version 4.0 and up.");
-    return 0;
+    return false;
   }
 
   // TODO: read binary files too.
   if (FileType != 0) {
     vtkErrorMacro("Reader can only read ASCII formatted files");
-    return 0;
+    return false;
   }
 
   MshFile >> line;
   if (line != "$EndMeshFormat") {
     vtkErrorMacro("Expected $EndMeshFormat.");
+    return false;
+  }
+
+  MshFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+  std::streamoff FileSize = 0;
+  {
+    const std::streampos start = MshFile.tellg();
+    MshFile.seekg(0, std::ios::end);
+    FileSize = MshFile.tellg();
+    MshFile.seekg(start);
+  }
+
+  // A file that shrank, or whose indexed part changed as when a restarted
+  // solver writes it again from scratch, was rewritten and is indexed
+  // again, mesh included.
+  std::streamoff start = MshFile.tellg();
+  if (file.IndexedOffset > 0 && file.IndexedOffset <= FileSize &&
+      GetFingerprint(MshFile, file.IndexedOffset) ==
+	file.IndexedFingerprint) {
+    start = file.IndexedOffset;
+  } else if (file.IndexedOffset > 0) {
+    std::string FileName = std::move(file.FileName);
+    file = FileIndex();
+    file.FileName = std::move(FileName);
+    internals->Mesh = MeshArrays();
+    internals->MeshKey = GmshCore::MeshKey();
+  }
+
+  if (file.Identity.empty()) {
+    file.Identity = GetFileIdentity(file.FileName, FileSize);
+  }
+
+  GmshCore::Tokenizer tokens(MshFile);
+  tokens.SetTrace(internals->Trace.get());
+  tokens.Seek(start);
+  std::vector<GmshCore::Section> sections;
+  const GmshCore::IndexResult result =
+    GmshCore::IndexSections(tokens, sections);
+  file.IndexedOffset = result.Offset;
+
+  for (std::size_t i = 0; i < sections.size(); ++i) {
+    const GmshCore::Section& section = sections[i];
+    GmshCore::DataKind kind;
+    if (section.Name == "Nodes" || section.Name == "Elements" ||
+	section.Name == "Periodic") {
+      file.MeshSignature += '$' + section.Name + ' ' + section.FirstLine + '\n';
+      if (section.Name == "Periodic") {
+	file.PeriodicOffset = section.ContentOffset;
+      } else if (section.Name == "Elements") {
+	file.ElementsOffset = section.ContentOffset;
+      } else {
+	file.NodesOffset = section.ContentOffset;
+	std::size_t NumberOfBlocks, NumberOfNodes, MinTag;
+	std::istringstream(section.FirstLine) >> NumberOfBlocks >>
+	  NumberOfNodes >> MinTag >> file.MaxNodeTag;
+      }
+    } else if (section.Name == "InterpolationScheme") {
+      std::string name, error;
+      GmshCore::InterpolationScheme scheme;
+      tokens.Seek(section.ContentOffset);
+      if (!GmshCore::ReadInterpolationScheme(tokens, name, scheme, error)) {
+	vtkErrorMacro(<< error << " (" << file.FileName << ")");
+	return false;
+      }
+      file.InterpolationSchemes[name] = std::move(scheme);
+    } else if (GmshCore::GetDataKind(section.Name, kind)) {
+      DataView view;
+      view.Kind = kind;
+      view.Name = section.View.GetName();
+      view.InterpolationScheme = section.View.GetInterpolationScheme();
+      view.Time = section.View.GetTime();
+      view.TimeStep = section.View.GetTimeStep();
+      view.NumberOfComponents = section.View.GetNumberOfComponents();
+      view.NumberOfEntities = section.View.GetNumberOfEntities();
+      view.Offset = section.RecordsOffset;
+      view.EndOffset =
+	i + 1 < sections.size() ? sections[i + 1].Offset : result.Offset;
+      if (view.Name.empty() || view.NumberOfComponents <= 0) {
+	vtkErrorMacro("Malformed $" << section.Name << " section in "
+		      << file.FileName << ".");
+	return false;
+      }
+
+      file.TimeSteps.push_back(view.Time);
+      if (kind == GmshCore::DataKind::Node) {
+	file.NodeDataViews.push_back(view);
+      } else if (kind == GmshCore::DataKind::Element) {
+	file.ElementDataViews.push_back(view);
+      } else {
+	file.ElementNodeDataViews.push_back(view);
+      }
+    }
+  }
+
+  // A section cut short by the end of the file is being appended by a
+  // running solver; it is indexed by a later pass in follow mode.
+  if (result.Status == GmshCore::IndexStatus::Malformed ||
+      (result.Status == GmshCore::IndexStatus::Incomplete &&
+       !this->FollowFile)) {
+    vtkErrorMacro("Malformed $" << result.SectionName << " section in "
+		  << file.FileName << ".");
+    return false;
+  }
+
+  file.IndexedFingerprint = GetFingerprint(MshFile, file.IndexedOffset);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::ProbeNodes(vtkIdTypeArray* NodeTags, vtkTable* table)
+{
+  vtkInternals* internals = this->Internals;
+  if (internals->Files.empty()) {
+    vtkErrorMacro("No file has been indexed.");
     return 0;
   }
 
-  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  std::vector<std::size_t> tags;
+  for (vtkIdType i = 0; i < NodeTags->GetNumberOfValues(); ++i) {
+    if (NodeTags->GetValue(i) > 0) {
+      tags.push_back(static_cast<std::size_t>(NodeTags->GetValue(i)));
+    }
+  }
+  std::sort(tags.begin(), tags.end());
+  tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+
+  // One row per time step of the reader: the time of each view in a
+  // single file, that of its file in a series.
+  const std::vector<double>& TimeSteps = internals->TimeSteps;
+  const vtkIdType NumberOfRows = static_cast<vtkIdType>(TimeSteps.size());
+  const bool IsSeries = internals->Files.size() > 1;
+
+  // Columns of each enabled field, one per node tag, and the views that
+  // fill them, by file and in file order.
+  struct Column
+  {
+    std::string Name;
+    int NumberOfComponents;
+    std::vector<vtkSmartPointer<vtkDoubleArray>> Arrays;
+  };
+  std::vector<Column> columns;
+  for (const FileIndex& file : internals->Files) {
+    for (const DataView& view : file.NodeDataViews) {
+      if (!this->PointDataArraySelection->ArrayIsEnabled(view.Name.c_str()) ||
+	  std::any_of(columns.begin(), columns.end(),
+		      [&view](const Column& column) {
+			return column.Name == view.Name;
+		      })) {
+	continue;
+      }
+      Column column{ view.Name, view.NumberOfComponents, {} };
+      for (std::size_t tag : tags) {
+	auto values = vtkSmartPointer<vtkDoubleArray>::New();
+	values->SetName(
+	  (view.Name + " (" + std::to_string(tag) + ")").c_str());
+	values->SetNumberOfComponents(view.NumberOfComponents);
+	values->SetNumberOfTuples(NumberOfRows);
+	values->Fill(vtkMath::Nan());
+	column.Arrays.push_back(values);
+      }
+      columns.push_back(std::move(column));
+    }
+  }
+
+  // Small positional reads: the stream is not buffered ahead of them and
+  // the tokenizer reads a page at a time.
+  std::vector<double> Probed;
+  for (std::size_t FileId = 0; FileId < internals->Files.size(); ++FileId) {
+    const FileIndex& file = internals->Files[FileId];
+    std::vector<const DataView*> views;
+    for (const DataView& view : file.NodeDataViews) {
+      if (this->PointDataArraySelection->ArrayIsEnabled(view.Name.c_str())) {
+	views.push_back(&view);
+      }
+    }
+    if (views.empty() || tags.empty()) {
+      continue;
+    }
+    std::sort(views.begin(), views.end(),
+	      [](const DataView* a, const DataView* b) {
+		return a->Offset < b->Offset;
+	      });
+
+    std::ifstream MshFile;
+    MshFile.rdbuf()->pubsetbuf(nullptr, 0);
+    MshFile.open(file.FileName, std::ios::binary);
+    if (!MshFile) {
+      vtkErrorMacro("Cannot open " << file.FileName << ".");
+      return 0;
+    }
+    GmshCore::Tokenizer tokens(MshFile, GmshCore::ProbeWindow);
+
+    for (const DataView* view : views) {
+      auto column = std::find_if(columns.begin(), columns.end(),
+				 [view](const Column& other) {
+				   return other.Name == view->Name;
+				 });
+      if (view->NumberOfComponents != column->NumberOfComponents) {
+	vtkWarningMacro("Skipped view \"" << view->Name << "\" at time "
+			<< view->Time << " of " << file.FileName
+			<< ": its number of components differs.");
+	continue;
+      }
+
+      const double time = IsSeries ? TimeSteps[FileId] : view->Time;
+      const vtkIdType row =
+	std::lower_bound(TimeSteps.begin(), TimeSteps.end(), time) -
+	TimeSteps.begin();
+      if (row >= NumberOfRows) {
+	continue;
+      }
+
+      const int NumberOfComponents = view->NumberOfComponents;
+      Probed.assign(tags.size() * NumberOfComponents, vtkMath::Nan());
+      if (!GmshCore::ProbeDataRecords(tokens, view->Offset, view->EndOffset,
+				      view->NumberOfEntities,
+				      NumberOfComponents, tags,
+				      Probed.data())) {
+	vtkErrorMacro("Failed to read values of view \"" << view->Name
+		      << "\" in " << file.FileName << ".");
+	return 0;
+      }
+      for (std::size_t j = 0; j < tags.size(); ++j) {
+	std::copy_n(Probed.data() + j * NumberOfComponents, NumberOfComponents,
+		    column->Arrays[j]->GetPointer(row * NumberOfComponents));
+      }
+    }
+  }
+
+  table->Initialize();
+  auto times = vtkSmartPointer<vtkDoubleArray>::New();
+  times->SetName("Time");
+  times->SetNumberOfValues(NumberOfRows);
+  std::copy(TimeSteps.begin(), TimeSteps.end(), times->GetPointer(0));
+  table->AddColumn(times);
+  for (const Column& column : columns) {
+    for (const auto& values : column.Arrays) {
+      table->AddColumn(values);
+    }
+  }
 
   return 1;
 }
@@ -324,114 +4490,12 @@ VTKCellType vtkGmshReader::GetVTKCellType(int mshElementType)
 //----------------------------------------------------------------------------
 int vtkGmshReader::GetNumberOfVerticesForElementType(int mshElementType)
 {
-  int NumberOfVertices = 0;
-
-  switch(mshElementType) {
-  case 1:
-    NumberOfVertices = 2;
-    break;
-  case 2:
-    NumberOfVertices = 3;
-    break;
-  case 3:
-    NumberOfVertices = 4;
-    break;
-  case 4:
-    NumberOfVertices = 4;
-    break;
-  case 5:
-    NumberOfVertices = 8;
-    break;
-  case 6:
-    NumberOfVertices = 6;
-    break;
-  case 7:
-    NumberOfVertices = 5;
-    break;
-  case 8:
-    NumberOfVertices = 3;
-    break;
-  case 9:
-    NumberOfVertices = 6;
-    break;
-  case 10:
-    NumberOfVertices = 9;
-    break;
-  case 11:
-    NumberOfVertices = 10;
-    break;
-  case 12:
-    NumberOfVertices = 27;
-    break;
-  case 13:
-    NumberOfVertices = 18;
-    break;
-  case 14:
-    NumberOfVertices = 14;
-    break;
-  case 15:
-    NumberOfVertices = 1;
-    break;
-  case 16:
-    NumberOfVertices = 8;
-    break;
-  case 17:
-    NumberOfVertices = 20;
-    break;
-  case 18:
-    NumberOfVertices = 15;
-    break;
-  case 19:
-    NumberOfVertices = 13;
-    break;
-  case 20:
-    NumberOfVertices = 9;
-    break;
-  case 21:
-    NumberOfVertices = 10;
-    break;
-  case 22:
-    NumberOfVertices = 12;
-    break;
-  case 23:
-    NumberOfVertices = 15;
-    break;
-  case 24:
-    NumberOfVertices = 15;
-    break;
-  case 25:
-    NumberOfVertices = 21;
-    break;
-  case 26:
-    NumberOfVertices = 4;
-    break;
-  case 27:
-    NumberOfVertices = 5;
-    break;
-  case 28:
-    NumberOfVertices = 6;
-    break;
-  case 29:
-    NumberOfVertices = 20;
-    break;
-  case 30:
-    NumberOfVertices = 35;
-    break;
-  case 31:
-    NumberOfVertices = 56;
-    break;
-  case 92:
-    NumberOfVertices = 64;
-    break;
-  case 93:
-    NumberOfVertices = 125;
-    break;
-  default:
+  const GmshCore::ElementType* type = GmshCore::GetElementType(mshElementType);
+  if (!type) {
     vtkErrorMacro("Unknown element type " << mshElementType);
-    break;
+    return 0;
   }
-
-  return NumberOfVertices;
+  return type->NumberOfNodes;
 }
 
 //----------------------------------------------------------------------------
@@ -441,8 +4505,238 @@ bool vtkGmshReader::CanReadFile(const char* filename)
   return true;
 }
 
+//----------------------------------------------------------------------------
+void vtkGmshReader::Refresh()
+{
+  if (!this->FollowFile) {
+    this->Internals->Files.clear();
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::AddFileName(const char* fname)
+{
+  if (fname) {
+    this->Internals->FileNames.push_back(fname);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::RemoveAllFileNames()
+{
+  if (!this->Internals->FileNames.empty()) {
+    this->Internals->FileNames.clear();
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::AddTimeHistoryPointId(vtkIdType id)
+{
+  this->Internals->HistoryPointIds.push_back(id);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::RemoveAllTimeHistoryPointIds()
+{
+  if (!this->Internals->HistoryPointIds.empty()) {
+    this->Internals->HistoryPointIds.clear();
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::AddTimeHistoryCellId(vtkIdType id)
+{
+  this->Internals->HistoryCellIds.push_back(id);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::RemoveAllTimeHistoryCellIds()
+{
+  if (!this->Internals->HistoryCellIds.empty()) {
+    this->Internals->HistoryCellIds.clear();
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkGmshReader::GetNumberOfFileNames()
+{
+  return static_cast<unsigned int>(this->Internals->FileNames.size());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkGmshReader::GetFileName(unsigned int index)
+{
+  return index < this->Internals->FileNames.size()
+    ? this->Internals->FileNames[index].c_str() : nullptr;
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::GetNumberOfPointArrays()
+{
+  return this->PointDataArraySelection->GetNumberOfArrays();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkGmshReader::GetPointArrayName(int index)
+{
+  return this->PointDataArraySelection->GetArrayName(index);
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::GetPointArrayStatus(const char* name)
+{
+  return this->PointDataArraySelection->ArrayIsEnabled(name);
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::SetPointArrayStatus(const char* name, int status)
+{
+  const bool changed =
+    UpdateSelected(this->Internals->SelectedPointArrays, name, status);
+  if (this->GetPointArrayStatus(name) == status) {
+    if (changed) {
+      this->Modified();
+    }
+    return;
+  }
+
+  if (status) {
+    this->PointDataArraySelection->EnableArray(name);
+  } else {
+    this->PointDataArraySelection->DisableArray(name);
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::GetNumberOfCellArrays()
+{
+  return this->CellDataArraySelection->GetNumberOfArrays();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkGmshReader::GetCellArrayName(int index)
+{
+  return this->CellDataArraySelection->GetArrayName(index);
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::GetCellArrayStatus(const char* name)
+{
+  return this->CellDataArraySelection->ArrayIsEnabled(name);
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::SetCellArrayStatus(const char* name, int status)
+{
+  const bool changed =
+    UpdateSelected(this->Internals->SelectedCellArrays, name, status);
+  if (this->GetCellArrayStatus(name) == status) {
+    if (changed) {
+      this->Modified();
+    }
+    return;
+  }
+
+  if (status) {
+    this->CellDataArraySelection->EnableArray(name);
+  } else {
+    this->CellDataArraySelection->DisableArray(name);
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::GetNumberOfEntityArrays()
+{
+  return this->EntitySelection->GetNumberOfArrays();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkGmshReader::GetEntityArrayName(int index)
+{
+  return this->EntitySelection->GetArrayName(index);
+}
+
+//----------------------------------------------------------------------------
+int vtkGmshReader::GetEntityArrayStatus(const char* name)
+{
+  return this->EntitySelection->ArrayIsEnabled(name);
+}
+
+//----------------------------------------------------------------------------
+void vtkGmshReader::SetEntityArrayStatus(const char* name, int status)
+{
+  if (this->GetEntityArrayStatus(name) == status) {
+    return;
+  }
+
+  if (status) {
+    this->EntitySelection->EnableArray(name);
+  } else {
+    this->EntitySelection->DisableArray(name);
+  }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkGmshReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: "
+     << (this->FileName ? this->FileName : "(none)") << endl;
+  os << indent << "PointDataArraySelection: "
+     << this->PointDataArraySelection << endl;
+  os << indent << "CellDataArraySelection: "
+     << this->CellDataArraySelection << endl;
+  os << indent << "ExplodeCells: " << this->ExplodeCells << endl;
+  os << indent << "LinearizeCells: " << this->LinearizeCells << endl;
+  os << indent << "LinearizationTolerance: "
+     << this->LinearizationTolerance << endl;
+  os << indent << "MaximumLinearizationDepth: "
+     << this->MaximumLinearizationDepth << endl;
+  os << indent << "UseSharedMemoryCache: "
+     << this->UseSharedMemoryCache << endl;
+  os << indent << "UseSnapshotCache: " << this->UseSnapshotCache << endl;
+  os << indent << "FollowFile: " << this->FollowFile << endl;
+  os << indent << "NumberOfFileNames: "
+     << this->Internals->FileNames.size() << endl;
+  os << indent << "LoadFilesConcurrently: "
+     << this->LoadFilesConcurrently << endl;
+  os << indent << "ParallelFirstTouch: " << this->ParallelFirstTouch << endl;
+  os << indent << "UseHugePages: " << this->UseHugePages << endl;
+  os << indent << "IOPolicy: " << this->IOPolicy << endl;
+  os << indent << "BuildCellLinks: " << this->BuildCellLinks << endl;
+  os << indent << "ComputeCellQuality: " << this->ComputeCellQuality << endl;
+  os << indent << "ReadPeriodicLinks: " << this->ReadPeriodicLinks << endl;
+  os << indent << "NumberOfPeriodicCopies: " << this->NumberOfPeriodicCopies
+     << endl;
+  os << indent << "TransformPeriodicCopies: " << this->TransformPeriodicCopies
+     << endl;
+  os << indent << "ReadParametricCoordinates: "
+     << this->ReadParametricCoordinates << endl;
+  os << indent << "ValidateMesh: " << this->ValidateMesh << endl;
+  os << indent << "MemoryBudget: " << this->MemoryBudget << endl;
+  os << indent << "MaximumDegradation: " << this->MaximumDegradation << endl;
+  os << indent << "ReadTimeHistory: " << this->ReadTimeHistory << endl;
+  os << indent << "NumberOfTimeHistoryPointIds: "
+     << this->Internals->HistoryPointIds.size() << endl;
+  os << indent << "NumberOfTimeHistoryCellIds: "
+     << this->Internals->HistoryCellIds.size() << endl;
+  os << indent << "StreamPieces: " << this->StreamPieces << endl;
+  os << indent << "MergePoints: " << this->MergePoints << endl;
+  os << indent << "MergeTolerance: " << this->MergeTolerance << endl;
+  os << indent << "SortCellsByEntity: " << this->SortCellsByEntity << endl;
+  os << indent << "SelectEntities: " << this->SelectEntities << endl;
+  os << indent << "EntitySelection: " << this->EntitySelection << endl;
+  os << indent << "BlockCacheSize: " << this->BlockCacheSize << endl;
+  os << indent << "TraceFileName: "
+     << (this->TraceFileName ? this->TraceFileName : "(none)") << endl;
 }
@@ -26,6 +26,12 @@
 #include <vtkUnstructuredGridAlgorithm.h>
 #include <vtkCellType.h>
 
+#include <iosfwd>
+
+class vtkDataArraySelection;
+class vtkIdTypeArray;
+class vtkTable;
+
 class vtkGmshReader : public vtkUnstructuredGridAlgorithm
 {
 public:
@@ -43,12 +49,504 @@ public:
   vtkSetStringMacro(FileName);
   vtkGetStringMacro(FileName);
 
+  //@{
+  /**
+   * Specify a series of Gmsh files read as one time step each, such as
+   * the result_0001.msh, result_0002.msh, ... files of a transient run.
+   * The mesh is parsed from the first file and only the data sections of
+   * the next ones are read, for as long as their $Nodes and $Elements
+   * section headers match. A file is placed at the latest time of its
+   * views when those times increase along the series, and at its index
+   * in the series otherwise. FileName is only read when no file was added.
+   */
+  void AddFileName(const char* fname);
+  void RemoveAllFileNames();
+  unsigned int GetNumberOfFileNames();
+  const char* GetFileName(unsigned int index);
+  //@}
+
   /**
    * Static method to know if a file can be read
    * based on its filename.
    */
   static bool CanReadFile(const char* filename);
 
+  //@{
+  /**
+   * Get the data array selection tables used to configure which
+   * $NodeData and $ElementData views are loaded as point and cell data
+   * arrays. $ElementNodeData views are listed with the cell arrays; those
+   * bound to an $InterpolationScheme are evaluated at the nodes of each
+   * cell, for elements of any order. Views that cover only part of the
+   * mesh are loaded with NaN for the points or cells they do not cover.
+   */
+  vtkGetObjectMacro(PointDataArraySelection, vtkDataArraySelection);
+  vtkGetObjectMacro(CellDataArraySelection, vtkDataArraySelection);
+  //@}
+
+  //@{
+  /**
+   * Get/Set whether the point array with the given name is to be read.
+   */
+  int GetNumberOfPointArrays();
+  const char* GetPointArrayName(int index);
+  int GetPointArrayStatus(const char* name);
+  void SetPointArrayStatus(const char* name, int status);
+  //@}
+
+  //@{
+  /**
+   * Get/Set whether the cell array with the given name is to be read.
+   */
+  int GetNumberOfCellArrays();
+  const char* GetCellArrayName(int index);
+  int GetCellArrayStatus(const char* name);
+  void SetCellArrayStatus(const char* name, int status);
+  //@}
+
+  //@{
+  /**
+   * When on, every cell gets private copies of its points so that
+   * $ElementNodeData views are loaded as discontinuous point data.
+   * When off (the default), $ElementNodeData views are loaded as field
+   * data arrays with one tuple per entry of the cell connectivity array.
+   */
+  vtkSetMacro(ExplodeCells, bool);
+  vtkGetMacro(ExplodeCells, bool);
+  vtkBooleanMacro(ExplodeCells, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, high-order cells are replaced by linear cells for filters
+   * and renderers that only understand those. Elements of order 2 and
+   * above are subdivided recursively, through their nodes and through new
+   * points interpolated inside them, wherever their geometry or a point
+   * field deviates from linear by more than LinearizationTolerance, up to
+   * MaximumLinearizationDepth. High-order pyramids, whose gmsh basis is
+   * rational, are reduced to their corners with a warning. The id of the
+   * original cell is kept in the vtkOriginalCellIds cell array, and point
+   * arrays other than double fields hold -1 at new points. Off by default.
+   */
+  vtkSetMacro(LinearizeCells, bool);
+  vtkGetMacro(LinearizeCells, bool);
+  vtkBooleanMacro(LinearizeCells, bool);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the deviation from linear, relative to the cell size for the
+   * geometry and to the data range for point fields, above which a cell
+   * is subdivided when LinearizeCells is on. A tolerance of 0 always
+   * subdivides. Defaults to 1e-3.
+   */
+  vtkSetClampMacro(LinearizationTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(LinearizationTolerance, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of times a cell may be halved along each edge when
+   * LinearizeCells is on, each level multiplying the number of cells of
+   * an element by up to 2, 4 or 8 with its dimension. Defaults to 3.
+   */
+  vtkSetClampMacro(MaximumLinearizationDepth, int, 0, 6);
+  vtkGetMacro(MaximumLinearizationDepth, int);
+  //@}
+
+  //@{
+  /**
+   * When on, the parsed mesh (points, offsets, connectivity and cell
+   * types) is placed in a named POSIX shared memory segment keyed by the
+   * path, size and modification time of the file. Readers in other
+   * processes of the same node then map the segment copy-on-write and wrap
+   * it as VTK arrays instead of parsing the mesh; a segment is only
+   * attached once it is completely written and matches the checksum of
+   * its layout. Segments outlive the processes and are found under
+   * /dev/shm/vtkGmshReader-*. Publishing the segment of a file removes on
+   * Linux those of its earlier versions, so that one segment per file is
+   * left in memory, until it is removed with rm /dev/shm/vtkGmshReader-*
+   * or the node reboots. Off by default; not available on Windows.
+   */
+  vtkSetMacro(UseSharedMemoryCache, bool);
+  vtkGetMacro(UseSharedMemoryCache, bool);
+  vtkBooleanMacro(UseSharedMemoryCache, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the parsed mesh is dumped to a snapshot file next to the
+   * Gmsh file (with a .snap suffix), holding the same page-aligned
+   * sections as the shared memory cache. Later loads of an unchanged file
+   * map the snapshot copy-on-write and wrap its sections as VTK arrays,
+   * with no parsing and no copy. Off by default; not available on Windows.
+   */
+  vtkSetMacro(UseSnapshotCache, bool);
+  vtkGetMacro(UseSnapshotCache, bool);
+  vtkBooleanMacro(UseSnapshotCache, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the reader follows a file being appended by a running
+   * solver: each update only indexes the sections appended since the
+   * previous one, extending the list of time steps, and keeps the mesh it
+   * already read. A trailing section that is still being written is
+   * ignored until it is complete. A file that shrank, or whose first
+   * bytes or the last bytes of its indexed part changed, as when a
+   * restarted solver writes it again from scratch, is indexed again from
+   * its start, mesh included. Off by default.
+   */
+  vtkSetMacro(FollowFile, bool);
+  vtkGetMacro(FollowFile, bool);
+  vtkBooleanMacro(FollowFile, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the first update of a file series decodes the data sections
+   * of all the files sharing its mesh at once, several files in parallel,
+   * and keeps the arrays so that later time steps are served from memory.
+   * Meant for batch jobs that go through every time step. Off by default.
+   */
+  vtkSetMacro(LoadFilesConcurrently, bool);
+  vtkGetMacro(LoadFilesConcurrently, bool);
+  vtkBooleanMacro(LoadFilesConcurrently, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the pages of the output arrays are first touched by the
+   * vtkSMPTools threads, with the partitioning used by parallel filters,
+   * instead of by the single parsing thread. On NUMA machines this spreads
+   * the arrays over the memory of all sockets. The cell arrays, such as
+   * the connectivity, are sized beforehand from the headers of the element
+   * blocks, which are indexed for it. Off by default.
+   */
+  vtkSetMacro(ParallelFirstTouch, bool);
+  vtkGetMacro(ParallelFirstTouch, bool);
+  vtkBooleanMacro(ParallelFirstTouch, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, output arrays of 64 MiB and more are advised to be backed by
+   * transparent huge pages (MADV_HUGEPAGE), which cuts TLB misses in the
+   * filters that traverse them. Only available on Linux. Off by default.
+   */
+  vtkSetMacro(UseHugePages, bool);
+  vtkGetMacro(UseHugePages, bool);
+  vtkBooleanMacro(UseHugePages, bool);
+  //@}
+
+  enum IOPolicies
+  {
+    BUFFERED_IO = 0,
+    DROP_BEHIND_IO = 1,
+    DIRECT_IO = 2
+  };
+
+  //@{
+  /**
+   * Set/Get how files are read. BUFFERED_IO (the default) reads through
+   * the page cache like std::ifstream. For one-shot conversions that should
+   * not evict the page cache of other jobs, DROP_BEHIND_IO reads in large
+   * aligned blocks and drops the cached pages behind the read cursor, and
+   * DIRECT_IO bypasses the page cache with O_DIRECT where the file system
+   * supports it. Both behave as BUFFERED_IO on Windows.
+   */
+  vtkSetClampMacro(IOPolicy, int, BUFFERED_IO, DIRECT_IO);
+  vtkGetMacro(IOPolicy, int);
+  //@}
+
+  //@{
+  /**
+   * When on, the point-to-cell links of the output are built in parallel
+   * once the cells are assembled and attached to it as vtkStaticCellLinks,
+   * so that the filters looking up the cells using a point do not build
+   * them serially on first use. Off by default.
+   */
+  vtkSetMacro(BuildCellLinks, bool);
+  vtkGetMacro(BuildCellLinks, bool);
+  vtkBooleanMacro(BuildCellLinks, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the Size (length, area or volume), ScaledJacobian and
+   * AspectRatio of the triangles, quadrangles, tetrahedra and hexahedra
+   * are computed from their corners as cell arrays, NaN on other cells,
+   * and their minimum, maximum, mean and standard deviation are added to
+   * the field data as <name>Statistics arrays. Off by default.
+   */
+  vtkSetMacro(ComputeCellQuality, bool);
+  vtkGetMacro(ComputeCellQuality, bool);
+  vtkBooleanMacro(ComputeCellQuality, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the $Periodic section is read into the field data of the
+   * output: PeriodicLinks holds the entity dimension, entity tag and
+   * master entity tag of each link, PeriodicTransforms its row-major 4x4
+   * affine transform (NaN when the file gives none), and PeriodicNodes
+   * the point id and master point id of the node pairs of all links,
+   * those of link i starting at PeriodicNodeOffsets[i]. Point ids are
+   * those of the shared points, before ExplodeCells; with MergePoints
+   * they are those of the merged points, -1 for a node that no cell
+   * uses. Off by default.
+   */
+  vtkSetMacro(ReadPeriodicLinks, bool);
+  vtkGetMacro(ReadPeriodicLinks, bool);
+  vtkBooleanMacro(ReadPeriodicLinks, bool);
+  //@}
+
+  //@{
+  /**
+   * Number of copies of a periodic sector produced on the second output,
+   * a vtkPartitionedDataSet. Copy k is transformed by the k-th power of
+   * the affine transform of the highest-dimensional periodic link, given
+   * in its PeriodicTransform field array; all copies share the cells and
+   * the field arrays of the first output. When TransformPeriodicCopies is
+   * off, they also share its points, for instanced rendering from the
+   * transforms. 0 (the default) leaves the second output empty.
+   */
+  vtkSetClampMacro(NumberOfPeriodicCopies, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPeriodicCopies, int);
+  vtkSetMacro(TransformPeriodicCopies, bool);
+  vtkGetMacro(TransformPeriodicCopies, bool);
+  vtkBooleanMacro(TransformPeriodicCopies, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the parametric coordinates of the nodes on curves and
+   * surfaces are read into the 3-component gmsh:parametric point array,
+   * NaN for the nodes and components the file does not give. When off
+   * (the default), they are skipped without being decoded.
+   */
+  vtkSetMacro(ReadParametricCoordinates, bool);
+  vtkGetMacro(ReadParametricCoordinates, bool);
+  vtkBooleanMacro(ReadParametricCoordinates, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the mesh is checked as it is parsed: node and element tags
+   * must be within the range of their section header and defined once,
+   * the blocks must hold as many entities as the headers announce, and
+   * every cell vertex must be a defined node, which is checked in
+   * parallel once the elements are read. The first failure is reported
+   * with its block and position and the mesh is rejected. Validation
+   * needs the file to be parsed: turning it on reads the file again when
+   * the mesh kept from the previous update was not validated, and meshes
+   * are then never attached from the shared memory or snapshot caches,
+   * although the validated mesh is still published to them. Pieces are
+   * not validated. Off by default, for trusted files.
+   */
+  vtkSetMacro(ValidateMesh, bool);
+  vtkGetMacro(ValidateMesh, bool);
+  vtkBooleanMacro(ValidateMesh, bool);
+  //@}
+
+  enum MemoryDegradations
+  {
+    DEGRADE_NONE = 0,
+    DEGRADE_CONNECTIVITY = 1,
+    DEGRADE_COORDINATES = 2,
+    DEGRADE_FIELDS = 3,
+    DEGRADE_BOUNDARY = 4
+  };
+
+  //@{
+  /**
+   * Set/Get the memory budget of the output in MiB, 0 (the default) for
+   * none. Before a mesh is read, the size of the output is predicted from
+   * the $Nodes header, the element block headers and the selected views.
+   * When it exceeds the budget, reductions are applied in order until it
+   * fits, up to MaximumDegradation: 32-bit connectivity
+   * (DEGRADE_CONNECTIVITY), float coordinates (DEGRADE_COORDINATES), no
+   * point or cell data from the file but the arrays enabled through
+   * SetPointArrayStatus and SetCellArrayStatus, rather than by default
+   * (DEGRADE_FIELDS), then only the elements of lower dimension than the
+   * mesh, such as its boundary surfaces (DEGRADE_BOUNDARY). If the output
+   * still does not fit, the reader fails with its estimate. The mesh is
+   * read directly into the reduced arrays and kept across time steps.
+   * The reductions are planned again at every update, from the indexed
+   * block headers, and the mesh is read again only when its arrays
+   * change.
+   */
+  vtkSetClampMacro(MemoryBudget, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MemoryBudget, int);
+  vtkSetClampMacro(MaximumDegradation, int, DEGRADE_NONE, DEGRADE_BOUNDARY);
+  vtkGetMacro(MaximumDegradation, int);
+  //@}
+
+  //@{
+  /**
+   * When on, the enabled $NodeData and $ElementData fields are also read
+   * at every time step, in one pass over the files sharing the mesh, for
+   * plots over time. Each field gives a "<name> History" field data array
+   * with a tuple per point or cell holding the components of every step
+   * side by side (step-major), NaN where a step has no value, and a
+   * "<name> HistoryTimes" array with the time of each step. The histories
+   * are kept until the reader is modified, so that stepping through time
+   * does not read them again. Off by default.
+   */
+  vtkSetMacro(ReadTimeHistory, bool);
+  vtkGetMacro(ReadTimeHistory, bool);
+  vtkBooleanMacro(ReadTimeHistory, bool);
+  //@}
+
+  //@{
+  /**
+   * Restrict the time histories to the given point or cell ids, whose
+   * tuples then follow the order of the ids, listed in the
+   * TimeHistoryPointIds and TimeHistoryCellIds field data arrays. The
+   * records of the other points and cells are skipped. All the points or
+   * cells are read when no id is given.
+   */
+  void AddTimeHistoryPointId(vtkIdType id);
+  void RemoveAllTimeHistoryPointIds();
+  void AddTimeHistoryCellId(vtkIdType id);
+  void RemoveAllTimeHistoryCellIds();
+  //@}
+
+  /**
+   * Read the values of the enabled point arrays at the given node tags,
+   * across all the time steps, into a table with a Time column and, for
+   * each array and tag, a "<name> (<tag>)" column with the components of
+   * the array, NaN at the steps without a value. Only the records of the
+   * tags are read, with small positional reads into each $NodeData view,
+   * and the mesh is not read. The files must have been indexed by
+   * UpdateInformation. Returns 0 on failure.
+   */
+  int ProbeNodes(vtkIdTypeArray* NodeTags, vtkTable* table);
+
+  //@{
+  /**
+   * When on, the reader honors the piece requests of a streaming or
+   * parallel pipeline. Each piece is an equal range of the elements in
+   * file order, so that it holds consecutive entities, with the nodes of
+   * its cells as points; only that range of the $Elements section is
+   * decoded, only the node blocks whose tag range holds points of the
+   * piece are read, with the coordinate lines of the other nodes skipped
+   * undecoded, and the data records of the other nodes and elements are
+   * skipped, so that memory is bounded by the largest piece. Pieces are
+   * neither cached nor validated, and are read without parametric
+   * coordinates, time histories, periodic links, $ElementNodeData views or
+   * memory budget. Off by default.
+   */
+  vtkSetMacro(StreamPieces, bool);
+  vtkGetMacro(StreamPieces, bool);
+  vtkBooleanMacro(StreamPieces, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, the points of the cells lying within MergeTolerance of each
+   * other are merged, as along the interfaces of separately meshed parts,
+   * so that no Clean to Grid is needed. The points are hashed to a grid
+   * in parallel and visited in node tag order, each point being merged
+   * into the first point kept that lies within the tolerance, or kept
+   * itself, so that no point moves further than the tolerance; the points
+   * used by no cell are dropped. The cells are rewritten to the points kept, whose
+   * node tags are given by the gmsh:node point array. A tolerance of 0
+   * (the default) merges points at the same place only. Merging is
+   * skipped when cells are exploded. Off by default.
+   */
+  vtkSetMacro(MergePoints, bool);
+  vtkGetMacro(MergePoints, bool);
+  vtkBooleanMacro(MergePoints, bool);
+  vtkSetClampMacro(MergeTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(MergeTolerance, double);
+  //@}
+
+  //@{
+  /**
+   * When on, the cells are ordered by dimension, then by entity tag, in
+   * file order within an entity, rather than in the order of the element
+   * blocks. The [begin, end) cell range of each dimension is given by the
+   * 2-component DimensionCellRanges field data array, one tuple for each
+   * dimension from 0 to 3, and that of each entity by the 4-component
+   * EntityCellRanges array as (dimension, tag, begin, end), so that the
+   * cells of a dimension or entity can be taken as a slice of the cell
+   * arrays. The ranges are not given when cells are linearized. Off by
+   * default.
+   */
+  vtkSetMacro(SortCellsByEntity, bool);
+  vtkGetMacro(SortCellsByEntity, bool);
+  vtkBooleanMacro(SortCellsByEntity, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, only the elements of the entities enabled in the entity
+   * selection are read, with the nodes of their cells as points, as for
+   * pieces. Entities are listed from the element block headers as Point,
+   * Curve, Surface or Volume followed by their tag, and are enabled when
+   * first listed. Unless pieces are requested, the node and element blocks
+   * are decoded whole and kept in the block cache, so that a new selection
+   * only decodes the blocks never read before. Selected entities are read
+   * without the mesh caches, validation, parametric coordinates, time
+   * histories, periodic links, $ElementNodeData views or memory budget.
+   * Off by default.
+   */
+  vtkSetMacro(SelectEntities, bool);
+  vtkGetMacro(SelectEntities, bool);
+  vtkBooleanMacro(SelectEntities, bool);
+  //@}
+
+  //@{
+  /**
+   * Get/Set whether the entity with the given name is read when
+   * SelectEntities is on.
+   */
+  vtkGetObjectMacro(EntitySelection, vtkDataArraySelection);
+  int GetNumberOfEntityArrays();
+  const char* GetEntityArrayName(int index);
+  int GetEntityArrayStatus(const char* name);
+  void SetEntityArrayStatus(const char* name, int status);
+  //@}
+
+  //@{
+  /**
+   * Memory in MiB of the decoded blocks kept by the block cache, beyond
+   * which the least recently used blocks are evicted; 0 disables the
+   * cache. A single block larger than this, as that of a mesh of one
+   * entity, is kept on its own on top of it. Blocks are keyed by their
+   * offset and the size and modification time of their file, so that a
+   * rewritten file is decoded again. 512 by default.
+   */
+  vtkSetClampMacro(BlockCacheSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(BlockCacheSize, int);
+  //@}
+
+  //@{
+  /**
+   * Name of a file to which each update writes a trace of the reader in
+   * the Chrome trace event JSON format, as loaded by Perfetto: spans of the
+   * reading stages, of each section and entity block parsed, of each chunk
+   * decoded by a worker thread and of each read of the files, on the track
+   * of the thread running them, with counters of the bytes read and of the
+   * memory of the output. The indexing pass preceding an update is traced
+   * along with it, and each update overwrites the file. None by default.
+   */
+  vtkSetStringMacro(TraceFileName);
+  vtkGetStringMacro(TraceFileName);
+  //@}
+
+  /**
+   * Mark the reader as modified so that the next update re-reads the
+   * file; in follow mode, only the newly appended sections are read.
+   * Other changes to the reader keep the index of the files whose name,
+   * size and modification time did not change, and with it the mesh and
+   * the arrays derived from it (cell links, quality metrics, merged
+   * points), so that toggling a property or a selection does not read
+   * the file again.
+   */
+  void Refresh();
+
 protected:
   vtkGmshReader();
   ~vtkGmshReader() override;
@@ -59,10 +557,52 @@ protected:
   int RequestData(vtkInformation* request,
 		  vtkInformationVector** inputVector,
 		  vtkInformationVector* outputVector) override;
+  int FillOutputPortInformation(int port, vtkInformation* info) override;
 
 private:
   char* FileName;
 
+  vtkDataArraySelection* PointDataArraySelection;
+  vtkDataArraySelection* CellDataArraySelection;
+  bool ExplodeCells;
+  bool LinearizeCells;
+  double LinearizationTolerance;
+  int MaximumLinearizationDepth;
+  bool UseSharedMemoryCache;
+  bool UseSnapshotCache;
+  bool FollowFile;
+  bool LoadFilesConcurrently;
+  bool ParallelFirstTouch;
+  bool UseHugePages;
+  int IOPolicy;
+  bool BuildCellLinks;
+  bool ComputeCellQuality;
+  bool ReadPeriodicLinks;
+  int NumberOfPeriodicCopies;
+  bool TransformPeriodicCopies;
+  bool ReadParametricCoordinates;
+  bool ValidateMesh;
+  int MemoryBudget;
+  int MaximumDegradation;
+  bool ReadTimeHistory;
+  bool StreamPieces;
+  bool MergePoints;
+  double MergeTolerance;
+  bool SortCellsByEntity;
+  bool SelectEntities;
+  vtkDataArraySelection* EntitySelection;
+  int BlockCacheSize;
+  char* TraceFileName;
+
+  struct vtkInternals;
+  vtkInternals* Internals;
+
+  bool IndexFile(int index);
+  bool PlanLoad(int index);
+  bool ReadMesh(std::istream& MshFile, int index);
+  bool ReadMeshPiece(std::istream& MshFile, int index, int piece,
+		     int NumberOfPieces);
+
   VTKCellType GetVTKCellType(int mshElementType);
   int GetNumberOfVerticesForElementType(int mshElementType);
   